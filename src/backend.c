@@ -0,0 +1,304 @@
+/**
+ * @file backend.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Memory access backends used to read and write remote processes
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "backend.h"
+#include "logger.h"
+#include "status_codes.h"
+
+static ssize_t libhack_vm_readv(const struct libhack_handle *handle,
+                                const struct iovec *local,
+                                const struct iovec *remote, unsigned long count)
+{
+    return process_vm_readv(handle->pid, local, count, remote, count, 0);
+}
+
+static ssize_t libhack_vm_writev(const struct libhack_handle *handle,
+                                 const struct iovec *local,
+                                 const struct iovec *remote, unsigned long count)
+{
+    return process_vm_writev(handle->pid, local, count, remote, count, 0);
+}
+
+/**
+ * @brief Transfers paired iovecs through the /proc/<pid>/mem descriptor
+ *
+ * @param handle Handle to libhack
+ * @param local Local buffers
+ * @param remote Remote ranges
+ * @param count Number of entries
+ * @param write true to write, false to read
+ * @return ssize_t Number of bytes transferred until the first fault or -1
+ */
+static ssize_t libhack_mem_transfer(const struct libhack_handle *handle,
+                                    const struct iovec *local,
+                                    const struct iovec *remote,
+                                    unsigned long count, bool write)
+{
+    ssize_t total = 0;
+
+    if (handle->mem_fd == -1)
+    {
+        errno = EBADF;
+        return -1;
+    }
+
+    for (unsigned long i = 0; i < count; i++)
+    {
+        size_t done = 0;
+        off_t offset = (off_t)(uintptr_t)remote[i].iov_base;
+
+        while (done < remote[i].iov_len)
+        {
+            char *buffer = (char *)local[i].iov_base + done;
+            size_t len = remote[i].iov_len - done;
+            ssize_t ret = write
+                ? pwrite(handle->mem_fd, buffer, len, offset + (off_t)done)
+                : pread(handle->mem_fd, buffer, len, offset + (off_t)done);
+
+            if (ret <= 0)
+            {
+                if (ret == -1 && errno == EINTR)
+                    continue;
+
+                total += (ssize_t)done;
+                if (total > 0)
+                    return total;
+
+                // procfs reports unmapped addresses as EIO
+                if (ret == 0 || errno == EIO)
+                    errno = EFAULT;
+
+                return -1;
+            }
+
+            done += (size_t)ret;
+        }
+
+        total += (ssize_t)done;
+    }
+
+    return total;
+}
+
+static ssize_t libhack_mem_readv(const struct libhack_handle *handle,
+                                 const struct iovec *local,
+                                 const struct iovec *remote, unsigned long count)
+{
+    return libhack_mem_transfer(handle, local, remote, count, false);
+}
+
+static ssize_t libhack_mem_writev(const struct libhack_handle *handle,
+                                  const struct iovec *local,
+                                  const struct iovec *remote, unsigned long count)
+{
+    return libhack_mem_transfer(handle, local, remote, count, true);
+}
+
+static const struct libhack_backend process_vm_backend = {
+    "process_vm", LIBHACK_BACKEND_PROCESS_VM, libhack_vm_readv, libhack_vm_writev};
+
+static const struct libhack_backend proc_mem_backend = {
+    "proc_mem", LIBHACK_BACKEND_PROC_MEM, libhack_mem_readv, libhack_mem_writev};
+
+/**
+ * @brief Gets the first readable address of the target
+ *
+ * @param pid Process ID
+ * @param addr Receives the address
+ * @return bool true on success false otherwise
+ */
+static bool libhack_backend_probe_addr(pid_t pid, unsigned long *addr)
+{
+    char maps_path[BUFLEN];
+    char line[BUFLEN * 2];
+    bool found = false;
+
+    snprintf(maps_path, arraySize(maps_path), "/proc/%d/maps", pid);
+
+    FILE *fp = fopen(maps_path, "r");
+    if (fp == NULL)
+    {
+        libhack_err("failed to open %s: %d", maps_path, errno);
+        return false;
+    }
+
+    while (!found && fgets(line, sizeof(line), fp) != NULL)
+    {
+        unsigned long start, end;
+        char flags[8];
+
+        if (sscanf(line, "%lx-%lx %7s", &start, &end, flags) == 3 && flags[0] == 'r')
+        {
+            *addr = start;
+            found = true;
+        }
+    }
+
+    fclose(fp);
+
+    return found;
+}
+
+/**
+ * @brief Opens /proc/<pid>/mem, read-write if possible
+ *
+ * @param handle Handle to libhack
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_backend_open_mem(struct libhack_handle *handle)
+{
+    char mem_path[BUFLEN];
+
+    if (handle->mem_fd != -1)
+        return LIBHACK_OK;
+
+    snprintf(mem_path, arraySize(mem_path), "/proc/%d/mem", handle->pid);
+
+    handle->mem_fd = open(mem_path, O_RDWR | O_CLOEXEC);
+    if (handle->mem_fd == -1)
+        handle->mem_fd = open(mem_path, O_RDONLY | O_CLOEXEC);
+
+    if (handle->mem_fd == -1)
+    {
+        libhack_debug("failed to open %s: %d", mem_path, errno);
+        return errno;
+    }
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Checks if a backend is able to read the target
+ *
+ * @param handle Handle to libhack
+ * @param backend Backend to be checked
+ * @param addr Readable address of the target
+ * @return bool true if the backend works
+ */
+static bool libhack_backend_works(const struct libhack_handle *handle,
+                                  const struct libhack_backend *backend,
+                                  unsigned long addr)
+{
+    unsigned char byte;
+    struct iovec local = {&byte, 1};
+    struct iovec remote = {(void *)addr, 1};
+
+    return backend->readv(handle, &local, &remote, 1) == 1;
+}
+
+long libhack_backend_attach(struct libhack_handle *handle)
+{
+    unsigned long addr = 0;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, -1);
+
+    if (handle->pid == -1)
+        return ESRCH;
+
+    // The descriptor is kept open: it is also able to write read-only pages
+    libhack_backend_open_mem(handle);
+
+    if (!libhack_backend_probe_addr(handle->pid, &addr))
+    {
+        handle->backend = &process_vm_backend;
+        return ESRCH;
+    }
+
+    if (libhack_backend_works(handle, &process_vm_backend, addr))
+    {
+        handle->backend = &process_vm_backend;
+    }
+    else if (handle->mem_fd != -1 &&
+             libhack_backend_works(handle, &proc_mem_backend, addr))
+    {
+        handle->backend = &proc_mem_backend;
+    }
+    else
+    {
+        libhack_err("no memory backend is able to read process %d", handle->pid);
+        handle->backend = &process_vm_backend;
+        return EPERM;
+    }
+
+    libhack_debug("using %s backend for process %d", handle->backend->name,
+                  handle->pid);
+
+    return LIBHACK_OK;
+}
+
+void libhack_backend_detach(struct libhack_handle *handle)
+{
+    if (!handle)
+        return;
+
+    if (handle->mem_fd != -1)
+    {
+        close(handle->mem_fd);
+        handle->mem_fd = -1;
+    }
+
+    handle->backend = NULL;
+}
+
+long libhack_set_backend(struct libhack_handle *handle,
+                         enum libhack_backend_type type)
+{
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, -1);
+
+    if (handle->pid == -1)
+        return ESRCH;
+
+    switch (type)
+    {
+    case LIBHACK_BACKEND_AUTO:
+        return libhack_backend_attach(handle);
+
+    case LIBHACK_BACKEND_PROCESS_VM:
+        handle->backend = &process_vm_backend;
+        return LIBHACK_OK;
+
+    case LIBHACK_BACKEND_PROC_MEM:
+        status = libhack_backend_open_mem(handle);
+        if (status == LIBHACK_OK)
+            handle->backend = &proc_mem_backend;
+
+        return status;
+    }
+
+    return EINVAL;
+}
+
+const struct libhack_backend *libhack_get_backend(const struct libhack_handle *handle)
+{
+    if (handle == NULL || handle->backend == NULL)
+        return &process_vm_backend;
+
+    return handle->backend;
+}
+
+#endif // __linux__
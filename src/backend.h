@@ -0,0 +1,128 @@
+/**
+ * @file backend.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Memory access backends used to read and write remote processes
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_BACKEND_H
+#define LIBHACK_BACKEND_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <sys/uio.h>
+#include "init.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Available memory access backends
+ *
+ */
+enum libhack_backend_type
+{
+	/**
+	 * @brief Probe the target and pick the best working backend
+	 *
+	 */
+	LIBHACK_BACKEND_AUTO,
+
+	/**
+	 * @brief process_vm_readv/process_vm_writev
+	 *
+	 */
+	LIBHACK_BACKEND_PROCESS_VM,
+
+	/**
+	 * @brief pread/pwrite on a persistent /proc/<pid>/mem descriptor
+	 *
+	 */
+	LIBHACK_BACKEND_PROC_MEM
+};
+
+/**
+ * @brief Table of operations implemented by a memory access backend
+ *
+ * Both operations follow the process_vm_readv semantics: local and remote
+ * entries are paired, the transfer stops at the first remote entry that
+ * faults and the number of bytes transferred until then is returned.
+ *
+ */
+struct libhack_backend
+{
+	/**
+	 * @brief Backend name
+	 *
+	 */
+	const char *name;
+
+	/**
+	 * @brief Backend type
+	 *
+	 */
+	enum libhack_backend_type type;
+
+	/**
+	 * @brief Reads remote memory
+	 *
+	 */
+	ssize_t (*readv)(const struct libhack_handle *handle, const struct iovec *local,
+					 const struct iovec *remote, unsigned long count);
+
+	/**
+	 * @brief Writes remote memory
+	 *
+	 */
+	ssize_t (*writev)(const struct libhack_handle *handle, const struct iovec *local,
+					  const struct iovec *remote, unsigned long count);
+};
+
+/**
+ * @brief Probes the target process and selects the backend to be used
+ *
+ * Called once the process ID is resolved.
+ *
+ * @param handle Handle to libhack
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_backend_attach(struct libhack_handle *handle);
+
+/**
+ * @brief Releases resources held by the backend of the handle
+ *
+ * @param handle Handle to libhack
+ */
+void libhack_backend_detach(struct libhack_handle *handle);
+
+/**
+ * @brief Forces a memory access backend
+ *
+ * @param handle Handle to libhack
+ * @param type Backend to be used (LIBHACK_BACKEND_AUTO probes again)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_set_backend(struct libhack_handle *handle, enum libhack_backend_type type);
+
+/**
+ * @brief Gets the backend used by the handle
+ *
+ * @param handle Handle to libhack
+ * @return const struct libhack_backend* Backend (process_vm_* if none was selected yet)
+ */
+const struct libhack_backend *libhack_get_backend(const struct libhack_handle *handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_BACKEND_H
@@ -0,0 +1,965 @@
+/**
+ * @file candidates.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Candidate sets narrowed by successive scans
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "candidates.h"
+#include "logger.h"
+#include "process.h"
+#include "status_codes.h"
+
+/**
+ * @brief Layout of the addresses of a block
+ *
+ */
+enum libhack_candidate_encoding
+{
+	/**
+	 * @brief One bit per possible position
+	 *
+	 */
+	LIBHACK_ENCODING_BITMAP,
+
+	/**
+	 * @brief LEB128 distances between consecutive positions
+	 *
+	 */
+	LIBHACK_ENCODING_DELTA
+};
+
+/**
+ * @brief Candidates lying in one span of the address space
+ *
+ */
+struct libhack_candidate_block
+{
+	/**
+	 * @brief First address of the span
+	 *
+	 */
+	DWORD64 base;
+
+	/**
+	 * @brief Number of candidates
+	 *
+	 */
+	size_t count;
+
+	/**
+	 * @brief Layout of index
+	 *
+	 */
+	enum libhack_candidate_encoding encoding;
+
+	/**
+	 * @brief Encoded positions of the candidates
+	 *
+	 */
+	unsigned char *index;
+
+	/**
+	 * @brief Size of index
+	 *
+	 */
+	size_t index_len;
+
+	/**
+	 * @brief Values of the last pass, packed in address order
+	 *
+	 */
+	unsigned char *values;
+};
+
+struct libhack_candidates
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Type of the values
+	 *
+	 */
+	enum libhack_value_type type;
+
+	/**
+	 * @brief Size of the values
+	 *
+	 */
+	size_t size;
+
+	/**
+	 * @brief Alignment requested by the caller
+	 *
+	 */
+	size_t alignment;
+
+	/**
+	 * @brief Granularity of positions inside a block
+	 *
+	 */
+	size_t unit;
+
+	/**
+	 * @brief Bytes covered by a block (multiple of the page size)
+	 *
+	 */
+	size_t span;
+
+	/**
+	 * @brief Page size of the system
+	 *
+	 */
+	size_t page;
+
+	/**
+	 * @brief Blocks sorted by base address
+	 *
+	 */
+	struct libhack_candidate_block *blocks;
+
+	/**
+	 * @brief Number of blocks
+	 *
+	 */
+	size_t block_count;
+
+	/**
+	 * @brief Capacity of blocks
+	 *
+	 */
+	size_t block_capacity;
+
+	/**
+	 * @brief Total number of candidates
+	 *
+	 */
+	size_t count;
+
+	/**
+	 * @brief Positions of the block being appended (NULL outside of a streamed scan)
+	 *
+	 */
+	uint32_t *pending_pos;
+
+	/**
+	 * @brief Values of the block being appended
+	 *
+	 */
+	unsigned char *pending_values;
+
+	/**
+	 * @brief Number of candidates of the block being appended
+	 *
+	 */
+	size_t pending_count;
+
+	/**
+	 * @brief First address of the block being appended
+	 *
+	 */
+	DWORD64 pending_base;
+};
+
+/**
+ * @brief Gets the number of positions of a block
+ *
+ * @param set Candidate set
+ * @return size_t Number of positions
+ */
+static inline size_t libhack_candidates_positions(const struct libhack_candidates *set)
+{
+    return set->span / set->unit;
+}
+
+/**
+ * @brief Encodes the positions of a block, picking the smallest layout
+ *
+ * @param set Candidate set
+ * @param block Block receiving the index
+ * @param pos Sorted positions
+ * @param count Number of positions
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_candidate_block_encode(const struct libhack_candidates *set,
+                                           struct libhack_candidate_block *block,
+                                           const uint32_t *pos, size_t count)
+{
+    size_t bitmap_len = (libhack_candidates_positions(set) + 7) / 8;
+    size_t delta_len = 0;
+    uint32_t prev = 0;
+    unsigned char *index;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t delta = pos[i] - prev;
+
+        do
+        {
+            delta_len++;
+            delta >>= 7;
+        } while (delta);
+
+        prev = pos[i];
+    }
+
+    free(block->index);
+    block->index = NULL;
+    block->index_len = 0;
+    block->count = count;
+
+    if (count == 0)
+        return LIBHACK_OK;
+
+    if (bitmap_len <= delta_len)
+    {
+        index = (unsigned char *)calloc(bitmap_len, 1);
+        if (!index)
+            return ENOMEM;
+
+        for (size_t i = 0; i < count; i++)
+            index[pos[i] / 8] |= (unsigned char)(1 << (pos[i] % 8));
+
+        block->encoding = LIBHACK_ENCODING_BITMAP;
+        block->index_len = bitmap_len;
+    }
+    else
+    {
+        size_t len = 0;
+
+        index = (unsigned char *)malloc(delta_len);
+        if (!index)
+            return ENOMEM;
+
+        prev = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t delta = pos[i] - prev;
+
+            while (delta >= 0x80)
+            {
+                index[len++] = (unsigned char)(delta | 0x80);
+                delta >>= 7;
+            }
+
+            index[len++] = (unsigned char)delta;
+            prev = pos[i];
+        }
+
+        block->encoding = LIBHACK_ENCODING_DELTA;
+        block->index_len = delta_len;
+    }
+
+    block->index = index;
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Decodes the positions of a block
+ *
+ * @param block Block
+ * @param pos Receives block->count sorted positions
+ */
+static void libhack_candidate_block_decode(const struct libhack_candidate_block *block,
+                                           uint32_t *pos)
+{
+    size_t count = 0;
+
+    if (block->encoding == LIBHACK_ENCODING_BITMAP)
+    {
+        for (size_t byte = 0; byte < block->index_len && count < block->count; byte++)
+        {
+            unsigned int bits = block->index[byte];
+
+            while (bits)
+            {
+                pos[count++] = (uint32_t)(byte * 8 + (size_t)__builtin_ctz(bits));
+                bits &= bits - 1;
+            }
+        }
+
+        return;
+    }
+
+    uint32_t prev = 0;
+    size_t i = 0;
+
+    while (count < block->count && i < block->index_len)
+    {
+        uint32_t delta = 0;
+        int shift = 0;
+
+        do
+        {
+            delta |= (uint32_t)(block->index[i] & 0x7F) << shift;
+            shift += 7;
+        } while (block->index[i++] & 0x80);
+
+        prev += delta;
+        pos[count++] = prev;
+    }
+}
+
+static void libhack_candidate_block_release(struct libhack_candidate_block *block)
+{
+    free(block->index);
+    free(block->values);
+    memset(block, 0, sizeof(*block));
+}
+
+static void libhack_candidates_clear(struct libhack_candidates *set)
+{
+    for (size_t i = 0; i < set->block_count; i++)
+        libhack_candidate_block_release(&set->blocks[i]);
+
+    free(set->blocks);
+    set->blocks = NULL;
+    set->block_count = 0;
+    set->block_capacity = 0;
+    set->count = 0;
+
+    free(set->pending_pos);
+    free(set->pending_values);
+    set->pending_pos = NULL;
+    set->pending_values = NULL;
+    set->pending_count = 0;
+}
+
+/**
+ * @brief Picks the granularity of positions for addresses spaced by the alignment
+ *
+ * @param set Candidate set
+ */
+static void libhack_candidates_pick_unit(struct libhack_candidates *set)
+{
+    set->unit = 1;
+    if ((set->alignment & (set->alignment - 1)) == 0 && set->alignment <= set->page)
+        set->unit = set->alignment;
+}
+
+/**
+ * @brief Encodes the block being appended and adds it to the set
+ *
+ * @param set Candidate set
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_candidates_flush(struct libhack_candidates *set)
+{
+    struct libhack_candidate_block *block;
+    long status;
+
+    if (set->pending_count == 0)
+        return LIBHACK_OK;
+
+    if (set->block_count == set->block_capacity)
+    {
+        size_t capacity = set->block_capacity ? set->block_capacity * 2 : 64;
+        struct libhack_candidate_block *blocks = (struct libhack_candidate_block *)realloc(
+            set->blocks, capacity * sizeof(struct libhack_candidate_block));
+
+        if (!blocks)
+            return ENOMEM;
+
+        set->blocks = blocks;
+        set->block_capacity = capacity;
+    }
+
+    block = &set->blocks[set->block_count];
+    memset(block, 0, sizeof(*block));
+    block->base = set->pending_base;
+
+    status = libhack_candidate_block_encode(set, block, set->pending_pos, set->pending_count);
+    block->values = (unsigned char *)malloc(set->pending_count * set->size);
+    if (status != LIBHACK_OK || !block->values)
+    {
+        libhack_candidate_block_release(block);
+        return ENOMEM;
+    }
+
+    memcpy(block->values, set->pending_values, set->pending_count * set->size);
+
+    set->block_count++;
+    set->count += set->pending_count;
+    set->pending_count = 0;
+
+    return LIBHACK_OK;
+}
+
+#define NARROW_TEST(T)                                                  \
+    do                                                                  \
+    {                                                                   \
+        T p, c, v;                                                      \
+        memcpy(&p, prev, sizeof(T));                                    \
+        memcpy(&c, cur, sizeof(T));                                     \
+        switch (op)                                                     \
+        {                                                               \
+        case LIBHACK_NARROW_INCREASED:                                  \
+            return c > p;                                               \
+        case LIBHACK_NARROW_DECREASED:                                  \
+            return c < p;                                               \
+        case LIBHACK_NARROW_EQUAL:                                      \
+            memcpy(&v, value, sizeof(T));                               \
+            return c == v;                                              \
+        default:                                                        \
+            return false;                                               \
+        }                                                               \
+    } while (0)
+
+bool libhack_narrow_test(enum libhack_value_type type, enum libhack_narrow_op op,
+                         const void *prev, const void *cur, const void *value)
+{
+    // Bitwise comparison keeps NaN and -0.0 stable across passes
+    if (op == LIBHACK_NARROW_CHANGED)
+        return memcmp(prev, cur, libhack_value_size(type)) != 0;
+
+    if (op == LIBHACK_NARROW_UNCHANGED)
+        return memcmp(prev, cur, libhack_value_size(type)) == 0;
+
+    switch (type)
+    {
+    case LIBHACK_TYPE_INT8:
+        NARROW_TEST(int8_t);
+    case LIBHACK_TYPE_INT16:
+        NARROW_TEST(int16_t);
+    case LIBHACK_TYPE_INT32:
+        NARROW_TEST(int32_t);
+    case LIBHACK_TYPE_INT64:
+        NARROW_TEST(int64_t);
+    case LIBHACK_TYPE_FLOAT:
+        NARROW_TEST(float);
+    case LIBHACK_TYPE_DOUBLE:
+        NARROW_TEST(double);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Builds one descriptor per page holding candidates of a block
+ *
+ * Pages are read separately so a page which vanished only drops its own
+ * candidates; the batched read still packs them into a few syscalls.
+ *
+ * @param set Candidate set
+ * @param block Block
+ * @param pos Decoded positions of the block
+ * @param buffer Buffer receiving the span of the block
+ * @param descs Receives the pages
+ * @return size_t Number of pages
+ */
+static size_t libhack_candidates_build_pages(const struct libhack_candidates *set,
+                                             const struct libhack_candidate_block *block,
+                                             const uint32_t *pos, unsigned char *buffer,
+                                             struct libhack_mem_desc *descs)
+{
+    size_t pages = 0;
+
+    for (size_t i = 0; i < block->count; i++)
+    {
+        DWORD64 addr = block->base + (DWORD64)pos[i] * set->unit;
+        DWORD64 first = addr & ~((DWORD64)set->page - 1);
+        DWORD64 last = (addr + set->size - 1) & ~((DWORD64)set->page - 1);
+
+        for (DWORD64 page = first; page <= last; page += set->page)
+        {
+            if (pages > 0 && descs[pages - 1].addr >= page)
+                continue;
+
+            descs[pages].addr = page;
+            descs[pages].buffer = buffer + (page - block->base);
+            descs[pages].len = set->page;
+            pages++;
+        }
+    }
+
+    return pages;
+}
+
+/**
+ * @brief Checks if a batched read failed as a whole rather than on some pages
+ *
+ * @param status Status of each page
+ * @param pages Number of pages
+ * @param ret Result of the batched read
+ * @return true if every page failed with the same error, which is not a fault
+ */
+static bool libhack_candidates_read_failed(const long *status, size_t pages, long ret)
+{
+    if (ret == LIBHACK_OK || ret == EFAULT || ret == EIO || pages == 0)
+        return false;
+
+    for (size_t i = 0; i < pages; i++)
+    {
+        if (status[i] != ret)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Re-reads every candidate and keeps those matching a condition
+ *
+ * If a group of blocks cannot be read at all (permission denied, out of
+ * memory, ...), the pass stops and that group and the following ones keep
+ * their candidates untouched.
+ *
+ * @param set Candidate set
+ * @param keep_all Keep every candidate which could be read (ignores op)
+ * @param op Condition
+ * @param value New value for LIBHACK_NARROW_EQUAL
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_candidates_pass(struct libhack_candidates *set, bool keep_all,
+                                    enum libhack_narrow_op op, const void *value)
+{
+    // A block reads the pages of its span plus the page its last value may spill into
+    size_t slot_len = set->span + set->page;
+    size_t max_pages = set->span / set->page + 1;
+    unsigned char *buffer = (unsigned char *)malloc(LIBHACK_CANDIDATE_BATCH * slot_len);
+    struct libhack_mem_desc *descs = (struct libhack_mem_desc *)malloc(
+        LIBHACK_CANDIDATE_BATCH * max_pages * sizeof(struct libhack_mem_desc));
+    long *status = (long *)malloc(LIBHACK_CANDIDATE_BATCH * max_pages * sizeof(long));
+    uint32_t *pos = (uint32_t *)malloc(libhack_candidates_positions(set) * sizeof(uint32_t));
+    size_t first_page[LIBHACK_CANDIDATE_BATCH + 1];
+    size_t kept_blocks = 0;
+    size_t kept = 0;
+    bool intact = false;
+    long ret = LIBHACK_OK;
+
+    if (!buffer || !descs || !status || !pos)
+    {
+        free(buffer);
+        free(descs);
+        free(status);
+        free(pos);
+        return ENOMEM;
+    }
+
+    for (size_t group = 0; group < set->block_count; group += LIBHACK_CANDIDATE_BATCH)
+    {
+        size_t blocks = set->block_count - group;
+        size_t pages = 0;
+
+        if (blocks > LIBHACK_CANDIDATE_BATCH)
+            blocks = LIBHACK_CANDIDATE_BATCH;
+
+        // Only the pages still holding candidates are requested
+        for (size_t b = 0; b < blocks; b++)
+        {
+            struct libhack_candidate_block *block = &set->blocks[group + b];
+
+            libhack_candidate_block_decode(block, pos);
+            first_page[b] = pages;
+            pages += libhack_candidates_build_pages(set, block, pos, buffer + b * slot_len,
+                                                    descs + pages);
+        }
+
+        first_page[blocks] = pages;
+
+        ret = libhack_read_batch(set->handle, descs, pages, status);
+        if (ret == ESRCH)
+            goto out;
+
+        // Nothing was read: the remaining blocks are moved down as they are
+        if (libhack_candidates_read_failed(status, pages, ret))
+        {
+            for (size_t b = group; b < set->block_count; b++)
+            {
+                kept += set->blocks[b].count;
+                set->blocks[kept_blocks] = set->blocks[b];
+                if (kept_blocks++ != b)
+                    memset(&set->blocks[b], 0, sizeof(set->blocks[b]));
+            }
+
+            set->block_count = kept_blocks;
+            set->count = kept;
+            intact = true;
+
+            libhack_err("failed to read candidates from %d: %ld", set->handle->pid, ret);
+            goto out;
+        }
+
+        ret = LIBHACK_OK;
+
+        for (size_t b = 0; b < blocks; b++)
+        {
+            struct libhack_candidate_block *block = &set->blocks[group + b];
+            unsigned char *slot = buffer + b * slot_len;
+            size_t page = first_page[b];
+            size_t survivors = 0;
+
+            libhack_candidate_block_decode(block, pos);
+
+            for (size_t i = 0; i < block->count; i++)
+            {
+                DWORD64 addr = block->base + (DWORD64)pos[i] * set->unit;
+                const unsigned char *cur = slot + (addr - block->base);
+                unsigned char *prev = block->values + i * set->size;
+
+                while (descs[page].addr + set->page <= addr)
+                    page++;
+
+                // Pages which vanished since the last pass drop their candidates
+                if (status[page] != LIBHACK_OK)
+                    continue;
+
+                if (descs[page].addr + set->page < addr + set->size && status[page + 1] != LIBHACK_OK)
+                    continue;
+
+                if (!keep_all && !libhack_narrow_test(set->type, op, prev, cur, value))
+                    continue;
+
+                memcpy(block->values + survivors * set->size, cur, set->size);
+                pos[survivors++] = pos[i];
+            }
+
+            ret = libhack_candidate_block_encode(set, block, pos, survivors);
+            if (ret != LIBHACK_OK)
+                goto out;
+
+            if (survivors == 0)
+            {
+                libhack_candidate_block_release(block);
+                continue;
+            }
+
+            unsigned char *values = (unsigned char *)realloc(block->values, survivors * set->size);
+            if (values)
+                block->values = values;
+
+            kept += survivors;
+            set->blocks[kept_blocks] = *block;
+            if (kept_blocks++ != group + b)
+                memset(block, 0, sizeof(*block));
+        }
+    }
+
+    set->block_count = kept_blocks;
+    set->count = kept;
+
+    libhack_debug("%zu candidates left in %zu blocks", kept, kept_blocks);
+
+out:
+    // Blocks were compacted in place: a pass stopped halfway leaves nothing usable
+    if (ret != LIBHACK_OK && !intact)
+        libhack_candidates_clear(set);
+
+    free(buffer);
+    free(descs);
+    free(status);
+    free(pos);
+
+    return ret;
+}
+
+struct libhack_candidates *libhack_candidates_create(struct libhack_handle *handle,
+                                                     enum libhack_value_type type,
+                                                     size_t alignment)
+{
+    struct libhack_candidates *set;
+    size_t size = libhack_value_size(type);
+    long page = sysconf(_SC_PAGESIZE);
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && size > 0, NULL);
+
+    set = (struct libhack_candidates *)calloc(1, sizeof(struct libhack_candidates));
+    if (!set)
+        return NULL;
+
+    set->handle = handle;
+    set->type = type;
+    set->size = size;
+    set->alignment = alignment ? alignment : size;
+    set->page = page > 0 ? (size_t)page : 4096;
+    set->span = LIBHACK_CANDIDATE_SPAN < set->page ? set->page : LIBHACK_CANDIDATE_SPAN;
+    set->unit = 1;
+
+    return set;
+}
+
+long libhack_candidates_load(struct libhack_candidates *set, const DWORD64 *addrs, size_t count)
+{
+    uint32_t *pos;
+    size_t blocks = 0;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(set != NULL && (addrs != NULL || count == 0), -1);
+
+    libhack_candidates_clear(set);
+
+    for (size_t i = 1; i < count; i++)
+    {
+        if (addrs[i] <= addrs[i - 1])
+        {
+            libhack_err("candidate addresses must be sorted and unique");
+            return EINVAL;
+        }
+    }
+
+    // Positions are counted in alignment units when every address allows it
+    libhack_candidates_pick_unit(set);
+
+    for (size_t i = 0; i < count && set->unit > 1; i++)
+    {
+        if (addrs[i] % set->unit != 0)
+            set->unit = 1;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i == 0 || addrs[i] / set->span != addrs[i - 1] / set->span)
+            blocks++;
+    }
+
+    if (count == 0)
+        return LIBHACK_OK;
+
+    set->blocks = (struct libhack_candidate_block *)calloc(blocks, sizeof(struct libhack_candidate_block));
+    pos = (uint32_t *)malloc(libhack_candidates_positions(set) * sizeof(uint32_t));
+    if (!set->blocks || !pos)
+    {
+        free(pos);
+        libhack_candidates_clear(set);
+        return ENOMEM;
+    }
+
+    set->block_capacity = blocks;
+
+    for (size_t i = 0; i < count;)
+    {
+        struct libhack_candidate_block *block = &set->blocks[set->block_count++];
+        size_t n = 0;
+
+        block->base = addrs[i] - addrs[i] % set->span;
+
+        while (i < count && addrs[i] - block->base < set->span)
+        {
+            pos[n++] = (uint32_t)((addrs[i] - block->base) / set->unit);
+            i++;
+        }
+
+        status = libhack_candidate_block_encode(set, block, pos, n);
+        block->values = (unsigned char *)malloc(n * set->size);
+        if (status != LIBHACK_OK || !block->values)
+        {
+            free(pos);
+            libhack_candidates_clear(set);
+            return ENOMEM;
+        }
+
+        set->count += n;
+    }
+
+    free(pos);
+
+    // Fetch the initial values, dropping what cannot be read
+    return libhack_candidates_pass(set, true, LIBHACK_NARROW_CHANGED, NULL);
+}
+
+long libhack_candidates_begin(struct libhack_candidates *set)
+{
+    size_t positions;
+
+    // Sanity checking
+    libhack_assert_or_return(set != NULL, -1);
+
+    libhack_candidates_clear(set);
+
+    // Streamed addresses are all aligned, so positions always use the alignment
+    libhack_candidates_pick_unit(set);
+    positions = libhack_candidates_positions(set);
+
+    set->pending_pos = (uint32_t *)malloc(positions * sizeof(uint32_t));
+    set->pending_values = (unsigned char *)malloc(positions * set->size);
+    if (!set->pending_pos || !set->pending_values)
+    {
+        libhack_candidates_clear(set);
+        return ENOMEM;
+    }
+
+    return LIBHACK_OK;
+}
+
+long libhack_candidates_append(struct libhack_candidates *set, DWORD64 addr, const void *value)
+{
+    DWORD64 base;
+    uint32_t pos;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(set != NULL && value != NULL, -1);
+
+    if (!set->pending_pos)
+        return EINVAL;
+
+    base = addr - addr % set->span;
+    pos = (uint32_t)((addr - base) / set->unit);
+
+    if (addr % set->unit != 0 ||
+        (set->pending_count > 0 &&
+         (base < set->pending_base ||
+          (base == set->pending_base && pos <= set->pending_pos[set->pending_count - 1]))) ||
+        (set->block_count > 0 && base <= set->blocks[set->block_count - 1].base))
+    {
+        libhack_err("candidate addresses must be aligned, sorted and unique");
+        libhack_candidates_clear(set);
+        return EINVAL;
+    }
+
+    if (set->pending_count > 0 && base != set->pending_base)
+    {
+        status = libhack_candidates_flush(set);
+        if (status != LIBHACK_OK)
+        {
+            libhack_candidates_clear(set);
+            return status;
+        }
+    }
+
+    set->pending_base = base;
+    set->pending_pos[set->pending_count] = pos;
+    memcpy(set->pending_values + set->pending_count * set->size, value, set->size);
+    set->pending_count++;
+
+    return LIBHACK_OK;
+}
+
+long libhack_candidates_end(struct libhack_candidates *set)
+{
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(set != NULL, -1);
+
+    if (!set->pending_pos)
+        return EINVAL;
+
+    status = libhack_candidates_flush(set);
+
+    free(set->pending_pos);
+    free(set->pending_values);
+    set->pending_pos = NULL;
+    set->pending_values = NULL;
+
+    if (status != LIBHACK_OK)
+        libhack_candidates_clear(set);
+
+    return status;
+}
+
+long libhack_candidates_narrow(struct libhack_candidates *set, enum libhack_narrow_op op,
+                               const void *value)
+{
+    // Sanity checking
+    libhack_assert_or_return(set != NULL && (op != LIBHACK_NARROW_EQUAL || value != NULL), -1);
+
+    if (set->count == 0)
+        return LIBHACK_OK;
+
+    return libhack_candidates_pass(set, false, op, value);
+}
+
+size_t libhack_candidates_count(const struct libhack_candidates *set)
+{
+    return set ? set->count : 0;
+}
+
+enum libhack_value_type libhack_candidates_type(const struct libhack_candidates *set)
+{
+    return set->type;
+}
+
+size_t libhack_candidates_alignment(const struct libhack_candidates *set)
+{
+    return set->alignment;
+}
+
+size_t libhack_candidates_get(const struct libhack_candidates *set, DWORD64 *addrs,
+                              void *values, size_t max)
+{
+    uint32_t *pos;
+    size_t copied = 0;
+
+    if (!set || set->count == 0 || max == 0)
+        return 0;
+
+    pos = (uint32_t *)malloc(libhack_candidates_positions(set) * sizeof(uint32_t));
+    if (!pos)
+        return 0;
+
+    for (size_t b = 0; b < set->block_count && copied < max; b++)
+    {
+        const struct libhack_candidate_block *block = &set->blocks[b];
+        size_t n = block->count;
+
+        if (n > max - copied)
+            n = max - copied;
+
+        libhack_candidate_block_decode(block, pos);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (addrs)
+                addrs[copied + i] = block->base + (DWORD64)pos[i] * set->unit;
+        }
+
+        if (values)
+            memcpy((unsigned char *)values + copied * set->size, block->values, n * set->size);
+
+        copied += n;
+    }
+
+    free(pos);
+
+    return copied;
+}
+
+size_t libhack_candidates_memory(const struct libhack_candidates *set)
+{
+    size_t total = 0;
+
+    if (!set)
+        return 0;
+
+    total += set->block_count * sizeof(struct libhack_candidate_block);
+
+    for (size_t b = 0; b < set->block_count; b++)
+        total += set->blocks[b].index_len + set->blocks[b].count * set->size;
+
+    return total;
+}
+
+void libhack_candidates_free(struct libhack_candidates *set)
+{
+    if (!set)
+        return;
+
+    libhack_candidates_clear(set);
+    free(set);
+}
+
+#endif // __linux__
@@ -0,0 +1,219 @@
+/**
+ * @file candidates.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Candidate sets narrowed by successive scans
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_CANDIDATES_H
+#define LIBHACK_CANDIDATES_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "compare.h"
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Conditions kept by a narrowing pass
+ *
+ */
+enum libhack_narrow_op
+{
+	/**
+	 * @brief Value differs from the previous pass
+	 *
+	 */
+	LIBHACK_NARROW_CHANGED,
+
+	/**
+	 * @brief Value is the same as in the previous pass
+	 *
+	 */
+	LIBHACK_NARROW_UNCHANGED,
+
+	/**
+	 * @brief Value is greater than in the previous pass
+	 *
+	 */
+	LIBHACK_NARROW_INCREASED,
+
+	/**
+	 * @brief Value is smaller than in the previous pass
+	 *
+	 */
+	LIBHACK_NARROW_DECREASED,
+
+	/**
+	 * @brief Value is equal to a new value
+	 *
+	 */
+	LIBHACK_NARROW_EQUAL
+};
+
+/**
+ * @brief Checks a value against the condition of a narrowing pass
+ *
+ * @param type Type of the value
+ * @param op Condition
+ * @param prev Value of the previous pass
+ * @param cur Current value
+ * @param value New value for LIBHACK_NARROW_EQUAL (ignored otherwise)
+ * @return bool true if the value matches the condition
+ */
+bool libhack_narrow_test(enum libhack_value_type type, enum libhack_narrow_op op,
+						 const void *prev, const void *cur, const void *value);
+
+/**
+ * @brief Surviving addresses of a scan and their previous values
+ *
+ * Addresses are grouped in blocks of LIBHACK_CANDIDATE_SPAN bytes. Each block
+ * stores its addresses either as a bitmap (dense results) or as delta encoded
+ * offsets (sparse results), whichever is smaller.
+ *
+ */
+struct libhack_candidates;
+
+/**
+ * @brief Creates an empty candidate set bound to a handle
+ *
+ * @param handle Handle to libhack
+ * @param type Type of the values
+ * @param alignment Distance between candidate addresses used by the scan
+ * @return struct libhack_candidates* Candidate set or NULL on error
+ */
+struct libhack_candidates *libhack_candidates_create(struct libhack_handle *handle,
+													 enum libhack_value_type type,
+													 size_t alignment);
+
+/**
+ * @brief Replaces the candidates by a list of addresses and reads their values
+ *
+ * Addresses which cannot be read are dropped.
+ *
+ * @param set Candidate set
+ * @param addrs Addresses sorted in ascending order (e.g. a scan result)
+ * @param count Number of addresses
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_candidates_load(struct libhack_candidates *set, const DWORD64 *addrs, size_t count);
+
+/**
+ * @brief Empties a candidate set to fill it with the addresses streamed by a scan
+ *
+ * Addresses are then passed to libhack_candidates_append in ascending order
+ * and the set is completed by libhack_candidates_end. Each block is encoded as
+ * soon as the scan leaves its span, so only one span is held uncompressed.
+ *
+ * @param set Candidate set
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_candidates_begin(struct libhack_candidates *set);
+
+/**
+ * @brief Adds an address found by a streamed scan
+ *
+ * On error the set is left empty.
+ *
+ * @param set Candidate set
+ * @param addr Address, aligned and greater than the previous one
+ * @param value Current value at the address
+ * @return long LIBHACK_OK on success, EINVAL if the address is out of order or errno value
+ */
+long libhack_candidates_append(struct libhack_candidates *set, DWORD64 addr, const void *value);
+
+/**
+ * @brief Completes a set filled by a streamed scan
+ *
+ * @param set Candidate set
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_candidates_end(struct libhack_candidates *set);
+
+/**
+ * @brief Keeps only the candidates matching a condition
+ *
+ * Only the pages still holding candidates are read, through batched reads.
+ * The values read become the previous values of the next pass. Candidates in
+ * pages which cannot be read are dropped; if the reads fail as a whole
+ * (EPERM, ENOMEM, ...), the error is returned and the candidates not
+ * narrowed yet are kept as they were.
+ *
+ * @param set Candidate set
+ * @param op Condition
+ * @param value New value for LIBHACK_NARROW_EQUAL (ignored otherwise)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_candidates_narrow(struct libhack_candidates *set, enum libhack_narrow_op op,
+							   const void *value);
+
+/**
+ * @brief Gets the number of candidates
+ *
+ * @param set Candidate set
+ * @return size_t Number of candidates
+ */
+size_t libhack_candidates_count(const struct libhack_candidates *set);
+
+/**
+ * @brief Gets the type of the values of a candidate set
+ *
+ * @param set Candidate set
+ * @return enum libhack_value_type Type of the values
+ */
+enum libhack_value_type libhack_candidates_type(const struct libhack_candidates *set);
+
+/**
+ * @brief Gets the distance between candidate addresses of a candidate set
+ *
+ * @param set Candidate set
+ * @return size_t Alignment of the addresses
+ */
+size_t libhack_candidates_alignment(const struct libhack_candidates *set);
+
+/**
+ * @brief Copies the candidates in ascending address order
+ *
+ * @param set Candidate set
+ * @param addrs Receives the addresses (may be NULL)
+ * @param values Receives the values of the last pass, packed (may be NULL)
+ * @param max Maximum number of candidates to be copied
+ * @return size_t Number of candidates copied
+ */
+size_t libhack_candidates_get(const struct libhack_candidates *set, DWORD64 *addrs,
+							  void *values, size_t max);
+
+/**
+ * @brief Gets the memory used to store the candidates
+ *
+ * @param set Candidate set
+ * @return size_t Size in bytes of the indexes and values
+ */
+size_t libhack_candidates_memory(const struct libhack_candidates *set);
+
+/**
+ * @brief Releases a candidate set
+ *
+ * @param set Candidate set
+ */
+void libhack_candidates_free(struct libhack_candidates *set);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_CANDIDATES_H
@@ -0,0 +1,516 @@
+/**
+ * @file compare.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Vectorized comparison kernels used by scans
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <string.h>
+#include "compare.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LIBHACK_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Kernel comparing count positions of a buffer
+ *
+ */
+typedef void (*libhack_compare_kernel)(const struct libhack_compare *cmp,
+                                       const unsigned char *buffer, size_t count,
+                                       size_t stride, uint64_t *mask);
+
+size_t libhack_value_size(enum libhack_value_type type)
+{
+    switch (type)
+    {
+    case LIBHACK_TYPE_INT8:
+        return sizeof(int8_t);
+    case LIBHACK_TYPE_INT16:
+        return sizeof(int16_t);
+    case LIBHACK_TYPE_INT32:
+        return sizeof(int32_t);
+    case LIBHACK_TYPE_INT64:
+        return sizeof(int64_t);
+    case LIBHACK_TYPE_FLOAT:
+        return sizeof(float);
+    case LIBHACK_TYPE_DOUBLE:
+        return sizeof(double);
+    }
+
+    return 0;
+}
+
+#define SET_BIT(mask, i) ((mask)[(i) / 64] |= 1ULL << ((i) % 64))
+
+/*
+ * Scalar kernels. They are the reference implementation and also handle the
+ * strides not supported by the vector kernels and the tail of each block.
+ */
+
+#define SCALAR_TEST(T, v, op, a, b)                                   \
+    ((op) == LIBHACK_CMP_EQ   ? (v) == (a)                            \
+     : (op) == LIBHACK_CMP_NE ? (v) != (a)                            \
+     : (op) == LIBHACK_CMP_LT ? (v) < (a)                             \
+     : (op) == LIBHACK_CMP_GT ? (v) > (a)                             \
+                              : ((v) >= (a) && (v) <= (b)))
+
+#define DEFINE_SCALAR_KERNEL(NAME, T, FIELD)                                       \
+    static void NAME(const struct libhack_compare *cmp,                            \
+                     const unsigned char *buffer, size_t count, size_t stride,     \
+                     uint64_t *mask)                                               \
+    {                                                                              \
+        const T a = cmp->a.FIELD;                                                  \
+        const T b = cmp->b.FIELD;                                                  \
+        const enum libhack_compare_op op = cmp->op;                                \
+                                                                                   \
+        for (size_t i = 0; i < count; i++)                                         \
+        {                                                                          \
+            T v;                                                                   \
+            memcpy(&v, buffer + i * stride, sizeof(T));                            \
+            if (SCALAR_TEST(T, v, op, a, b))                                       \
+                SET_BIT(mask, i);                                                  \
+        }                                                                          \
+    }
+
+DEFINE_SCALAR_KERNEL(scalar_i8, int8_t, i8)
+DEFINE_SCALAR_KERNEL(scalar_i16, int16_t, i16)
+DEFINE_SCALAR_KERNEL(scalar_i32, int32_t, i32)
+DEFINE_SCALAR_KERNEL(scalar_i64, int64_t, i64)
+DEFINE_SCALAR_KERNEL(scalar_f32, float, f32)
+DEFINE_SCALAR_KERNEL(scalar_f64, double, f64)
+
+static const libhack_compare_kernel scalar_kernels[] = {
+    scalar_i8, scalar_i16, scalar_i32, scalar_i64, scalar_f32, scalar_f64};
+
+#ifdef LIBHACK_X86
+
+/*
+ * Vector kernels. Values are loaded unaligned: when the stride is smaller than
+ * the value size, the block is walked once per phase (stride offset) and each
+ * lane hit is scattered back to its position.
+ */
+
+#define DEFINE_VECTOR_KERNEL(NAME, ATTR, T, FIELD, VTYPE, LOAD, SET1, MASKFN)          \
+    static ATTR void NAME(const struct libhack_compare *cmp,                           \
+                          const unsigned char *buffer, size_t count, size_t stride,    \
+                          uint64_t *mask)                                              \
+    {                                                                                  \
+        const size_t lanes = sizeof(VTYPE) / sizeof(T);                                \
+        const size_t step = sizeof(T) / stride;                                        \
+        const T a_value = cmp->a.FIELD;                                                \
+        const T b_value = cmp->b.FIELD;                                                \
+        const VTYPE a = SET1(a_value);                                                 \
+        const VTYPE b = SET1(b_value);                                                 \
+        const enum libhack_compare_op op = cmp->op;                                    \
+                                                                                       \
+        for (size_t phase = 0; phase < step && phase < count; phase++)                \
+        {                                                                              \
+            const unsigned char *base = buffer + phase * stride;                       \
+            size_t n = (count - phase + step - 1) / step;                              \
+            size_t k = 0;                                                              \
+                                                                                       \
+            for (; k + lanes <= n; k += lanes)                                         \
+            {                                                                          \
+                uint64_t bits = MASKFN(LOAD(base + k * sizeof(T)), op, a, b);          \
+                                                                                       \
+                if (step == 1)                                                         \
+                {                                                                      \
+                    mask[k / 64] |= bits << (k % 64);                                  \
+                    continue;                                                          \
+                }                                                                      \
+                                                                                       \
+                while (bits)                                                           \
+                {                                                                      \
+                    size_t i = phase + (k + (size_t)__builtin_ctzll(bits)) * step;     \
+                    SET_BIT(mask, i);                                                  \
+                    bits &= bits - 1;                                                  \
+                }                                                                      \
+            }                                                                          \
+                                                                                       \
+            for (; k < n; k++)                                                         \
+            {                                                                          \
+                T v;                                                                   \
+                memcpy(&v, base + k * sizeof(T), sizeof(T));                           \
+                if (SCALAR_TEST(T, v, op, a_value, b_value))                           \
+                    SET_BIT(mask, phase + k * step);                                   \
+            }                                                                          \
+        }                                                                              \
+    }
+
+/* SSE2 */
+
+#define SSE2_LOAD_INT(p) _mm_loadu_si128((const __m128i *)(p))
+#define SSE2_LOAD_PS(p) _mm_loadu_ps((const float *)(p))
+#define SSE2_LOAD_PD(p) _mm_loadu_pd((const double *)(p))
+
+static inline __m128i sse2_cmpeq_epi64(__m128i x, __m128i y)
+{
+    __m128i eq = _mm_cmpeq_epi32(x, y);
+
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+static inline __m128i sse2_cmpgt_epi64(__m128i x, __m128i y)
+{
+    // Low halves are compared unsigned by flipping their sign bit
+    const __m128i flip = _mm_set_epi32(0, (int)0x80000000, 0, (int)0x80000000);
+    __m128i xs = _mm_xor_si128(x, flip);
+    __m128i ys = _mm_xor_si128(y, flip);
+    __m128i gt = _mm_cmpgt_epi32(xs, ys);
+    __m128i eq = _mm_cmpeq_epi32(xs, ys);
+    __m128i gt_hi = _mm_shuffle_epi32(gt, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128i gt_lo = _mm_shuffle_epi32(gt, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128i eq_hi = _mm_shuffle_epi32(eq, _MM_SHUFFLE(3, 3, 1, 1));
+
+    return _mm_or_si128(gt_hi, _mm_and_si128(eq_hi, gt_lo));
+}
+
+#define SSE2_MOVEMASK_I8(r) ((uint64_t)(unsigned)_mm_movemask_epi8(r))
+#define SSE2_MOVEMASK_I16(r) \
+    ((uint64_t)(unsigned)_mm_movemask_epi8(_mm_packs_epi16((r), _mm_setzero_si128())))
+#define SSE2_MOVEMASK_I32(r) ((uint64_t)(unsigned)_mm_movemask_ps(_mm_castsi128_ps(r)))
+#define SSE2_MOVEMASK_I64(r) ((uint64_t)(unsigned)_mm_movemask_pd(_mm_castsi128_pd(r)))
+
+#define DEFINE_SSE2_INT_MASK(NAME, CMPEQ, CMPGT, MOVEMASK)                         \
+    static inline uint64_t NAME(__m128i v, enum libhack_compare_op op, __m128i a,   \
+                                __m128i b)                                         \
+    {                                                                              \
+        const __m128i ones = _mm_set1_epi32(-1);                                   \
+        __m128i r;                                                                 \
+                                                                                   \
+        switch (op)                                                                \
+        {                                                                          \
+        case LIBHACK_CMP_EQ:                                                       \
+            r = CMPEQ(v, a);                                                       \
+            break;                                                                 \
+        case LIBHACK_CMP_NE:                                                       \
+            r = _mm_xor_si128(CMPEQ(v, a), ones);                                  \
+            break;                                                                 \
+        case LIBHACK_CMP_LT:                                                       \
+            r = CMPGT(a, v);                                                       \
+            break;                                                                 \
+        case LIBHACK_CMP_GT:                                                       \
+            r = CMPGT(v, a);                                                       \
+            break;                                                                 \
+        default:                                                                   \
+            r = _mm_andnot_si128(_mm_or_si128(CMPGT(a, v), CMPGT(v, b)), ones);    \
+            break;                                                                 \
+        }                                                                          \
+                                                                                   \
+        return MOVEMASK(r);                                                        \
+    }
+
+DEFINE_SSE2_INT_MASK(sse2_mask_i8, _mm_cmpeq_epi8, _mm_cmpgt_epi8, SSE2_MOVEMASK_I8)
+DEFINE_SSE2_INT_MASK(sse2_mask_i16, _mm_cmpeq_epi16, _mm_cmpgt_epi16, SSE2_MOVEMASK_I16)
+DEFINE_SSE2_INT_MASK(sse2_mask_i32, _mm_cmpeq_epi32, _mm_cmpgt_epi32, SSE2_MOVEMASK_I32)
+DEFINE_SSE2_INT_MASK(sse2_mask_i64, sse2_cmpeq_epi64, sse2_cmpgt_epi64, SSE2_MOVEMASK_I64)
+
+#define DEFINE_SSE2_FLOAT_MASK(NAME, VTYPE, SUFFIX)                                \
+    static inline uint64_t NAME(VTYPE v, enum libhack_compare_op op, VTYPE a,       \
+                                VTYPE b)                                           \
+    {                                                                              \
+        VTYPE r;                                                                   \
+                                                                                   \
+        switch (op)                                                                \
+        {                                                                          \
+        case LIBHACK_CMP_EQ:                                                       \
+            r = _mm_cmpeq_##SUFFIX(v, a);                                          \
+            break;                                                                 \
+        case LIBHACK_CMP_NE:                                                       \
+            r = _mm_cmpneq_##SUFFIX(v, a);                                         \
+            break;                                                                 \
+        case LIBHACK_CMP_LT:                                                       \
+            r = _mm_cmplt_##SUFFIX(v, a);                                          \
+            break;                                                                 \
+        case LIBHACK_CMP_GT:                                                       \
+            r = _mm_cmpgt_##SUFFIX(v, a);                                          \
+            break;                                                                 \
+        default:                                                                   \
+            r = _mm_and_##SUFFIX(_mm_cmpge_##SUFFIX(v, a), _mm_cmple_##SUFFIX(v, b)); \
+            break;                                                                 \
+        }                                                                          \
+                                                                                   \
+        return (uint64_t)(unsigned)_mm_movemask_##SUFFIX(r);                       \
+    }
+
+DEFINE_SSE2_FLOAT_MASK(sse2_mask_f32, __m128, ps)
+DEFINE_SSE2_FLOAT_MASK(sse2_mask_f64, __m128d, pd)
+
+#define SSE2_SET1_I8(x) _mm_set1_epi8((char)(x))
+#define SSE2_SET1_I64(x) _mm_set1_epi64x((long long)(x))
+
+DEFINE_VECTOR_KERNEL(sse2_i8, , int8_t, i8, __m128i, SSE2_LOAD_INT, SSE2_SET1_I8, sse2_mask_i8)
+DEFINE_VECTOR_KERNEL(sse2_i16, , int16_t, i16, __m128i, SSE2_LOAD_INT, _mm_set1_epi16, sse2_mask_i16)
+DEFINE_VECTOR_KERNEL(sse2_i32, , int32_t, i32, __m128i, SSE2_LOAD_INT, _mm_set1_epi32, sse2_mask_i32)
+DEFINE_VECTOR_KERNEL(sse2_i64, , int64_t, i64, __m128i, SSE2_LOAD_INT, SSE2_SET1_I64, sse2_mask_i64)
+DEFINE_VECTOR_KERNEL(sse2_f32, , float, f32, __m128, SSE2_LOAD_PS, _mm_set1_ps, sse2_mask_f32)
+DEFINE_VECTOR_KERNEL(sse2_f64, , double, f64, __m128d, SSE2_LOAD_PD, _mm_set1_pd, sse2_mask_f64)
+
+static const libhack_compare_kernel sse2_kernels[] = {
+    sse2_i8, sse2_i16, sse2_i32, sse2_i64, sse2_f32, sse2_f64};
+
+/* AVX2 */
+
+#define AVX2_ATTR __attribute__((target("avx2")))
+
+#define AVX2_LOAD_INT(p) _mm256_loadu_si256((const __m256i *)(p))
+#define AVX2_LOAD_PS(p) _mm256_loadu_ps((const float *)(p))
+#define AVX2_LOAD_PD(p) _mm256_loadu_pd((const double *)(p))
+
+#define AVX2_MOVEMASK_I8(r) ((uint64_t)(uint32_t)_mm256_movemask_epi8(r))
+#define AVX2_MOVEMASK_I16(r)                                                            \
+    ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_permute4x64_epi64(                 \
+         _mm256_packs_epi16((r), _mm256_setzero_si256()), _MM_SHUFFLE(3, 1, 2, 0))) &   \
+     0xFFFF)
+#define AVX2_MOVEMASK_I32(r) ((uint64_t)(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(r)))
+#define AVX2_MOVEMASK_I64(r) ((uint64_t)(unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(r)))
+
+#define DEFINE_AVX2_INT_MASK(NAME, SUFFIX, MOVEMASK)                                   \
+    static inline AVX2_ATTR uint64_t NAME(__m256i v, enum libhack_compare_op op,        \
+                                          __m256i a, __m256i b)                        \
+    {                                                                                  \
+        const __m256i ones = _mm256_set1_epi32(-1);                                    \
+        __m256i r;                                                                     \
+                                                                                       \
+        switch (op)                                                                    \
+        {                                                                              \
+        case LIBHACK_CMP_EQ:                                                           \
+            r = _mm256_cmpeq_##SUFFIX(v, a);                                           \
+            break;                                                                     \
+        case LIBHACK_CMP_NE:                                                           \
+            r = _mm256_xor_si256(_mm256_cmpeq_##SUFFIX(v, a), ones);                   \
+            break;                                                                     \
+        case LIBHACK_CMP_LT:                                                           \
+            r = _mm256_cmpgt_##SUFFIX(a, v);                                           \
+            break;                                                                     \
+        case LIBHACK_CMP_GT:                                                           \
+            r = _mm256_cmpgt_##SUFFIX(v, a);                                           \
+            break;                                                                     \
+        default:                                                                       \
+            r = _mm256_andnot_si256(                                                   \
+                _mm256_or_si256(_mm256_cmpgt_##SUFFIX(a, v), _mm256_cmpgt_##SUFFIX(v, b)), \
+                ones);                                                                 \
+            break;                                                                     \
+        }                                                                              \
+                                                                                       \
+        return MOVEMASK(r);                                                            \
+    }
+
+DEFINE_AVX2_INT_MASK(avx2_mask_i8, epi8, AVX2_MOVEMASK_I8)
+DEFINE_AVX2_INT_MASK(avx2_mask_i16, epi16, AVX2_MOVEMASK_I16)
+DEFINE_AVX2_INT_MASK(avx2_mask_i32, epi32, AVX2_MOVEMASK_I32)
+DEFINE_AVX2_INT_MASK(avx2_mask_i64, epi64, AVX2_MOVEMASK_I64)
+
+#define DEFINE_AVX2_FLOAT_MASK(NAME, VTYPE, SUFFIX)                                    \
+    static inline AVX2_ATTR uint64_t NAME(VTYPE v, enum libhack_compare_op op, VTYPE a,  \
+                                          VTYPE b)                                     \
+    {                                                                                  \
+        VTYPE r;                                                                       \
+                                                                                       \
+        switch (op)                                                                    \
+        {                                                                              \
+        case LIBHACK_CMP_EQ:                                                           \
+            r = _mm256_cmp_##SUFFIX(v, a, _CMP_EQ_OQ);                                 \
+            break;                                                                     \
+        case LIBHACK_CMP_NE:                                                           \
+            r = _mm256_cmp_##SUFFIX(v, a, _CMP_NEQ_UQ);                                \
+            break;                                                                     \
+        case LIBHACK_CMP_LT:                                                           \
+            r = _mm256_cmp_##SUFFIX(v, a, _CMP_LT_OQ);                                 \
+            break;                                                                     \
+        case LIBHACK_CMP_GT:                                                           \
+            r = _mm256_cmp_##SUFFIX(v, a, _CMP_GT_OQ);                                 \
+            break;                                                                     \
+        default:                                                                       \
+            r = _mm256_and_##SUFFIX(_mm256_cmp_##SUFFIX(v, a, _CMP_GE_OQ),             \
+                                    _mm256_cmp_##SUFFIX(v, b, _CMP_LE_OQ));            \
+            break;                                                                     \
+        }                                                                              \
+                                                                                       \
+        return (uint64_t)(unsigned)_mm256_movemask_##SUFFIX(r);                        \
+    }
+
+DEFINE_AVX2_FLOAT_MASK(avx2_mask_f32, __m256, ps)
+DEFINE_AVX2_FLOAT_MASK(avx2_mask_f64, __m256d, pd)
+
+#define AVX2_SET1_I8(x) _mm256_set1_epi8((char)(x))
+#define AVX2_SET1_I64(x) _mm256_set1_epi64x((long long)(x))
+
+DEFINE_VECTOR_KERNEL(avx2_i8, AVX2_ATTR, int8_t, i8, __m256i, AVX2_LOAD_INT, AVX2_SET1_I8, avx2_mask_i8)
+DEFINE_VECTOR_KERNEL(avx2_i16, AVX2_ATTR, int16_t, i16, __m256i, AVX2_LOAD_INT, _mm256_set1_epi16, avx2_mask_i16)
+DEFINE_VECTOR_KERNEL(avx2_i32, AVX2_ATTR, int32_t, i32, __m256i, AVX2_LOAD_INT, _mm256_set1_epi32, avx2_mask_i32)
+DEFINE_VECTOR_KERNEL(avx2_i64, AVX2_ATTR, int64_t, i64, __m256i, AVX2_LOAD_INT, AVX2_SET1_I64, avx2_mask_i64)
+DEFINE_VECTOR_KERNEL(avx2_f32, AVX2_ATTR, float, f32, __m256, AVX2_LOAD_PS, _mm256_set1_ps, avx2_mask_f32)
+DEFINE_VECTOR_KERNEL(avx2_f64, AVX2_ATTR, double, f64, __m256d, AVX2_LOAD_PD, _mm256_set1_pd, avx2_mask_f64)
+
+static const libhack_compare_kernel avx2_kernels[] = {
+    avx2_i8, avx2_i16, avx2_i32, avx2_i64, avx2_f32, avx2_f64};
+
+/* AVX-512 (F + BW): comparisons produce bit masks directly */
+
+#define AVX512_ATTR __attribute__((target("avx512f,avx512bw")))
+
+#define AVX512_LOAD_INT(p) _mm512_loadu_si512((const void *)(p))
+#define AVX512_LOAD_PS(p) _mm512_loadu_ps((const void *)(p))
+#define AVX512_LOAD_PD(p) _mm512_loadu_pd((const void *)(p))
+
+#define DEFINE_AVX512_INT_MASK(NAME, SUFFIX)                                           \
+    static inline AVX512_ATTR uint64_t NAME(__m512i v, enum libhack_compare_op op,      \
+                                            __m512i a, __m512i b)                      \
+    {                                                                                  \
+        switch (op)                                                                    \
+        {                                                                              \
+        case LIBHACK_CMP_EQ:                                                           \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _MM_CMPINT_EQ);          \
+        case LIBHACK_CMP_NE:                                                           \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _MM_CMPINT_NE);          \
+        case LIBHACK_CMP_LT:                                                           \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _MM_CMPINT_LT);          \
+        case LIBHACK_CMP_GT:                                                           \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _MM_CMPINT_NLE);         \
+        default:                                                                       \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _MM_CMPINT_NLT) &        \
+                   (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, b, _MM_CMPINT_LE);          \
+        }                                                                              \
+    }
+
+DEFINE_AVX512_INT_MASK(avx512_mask_i8, epi8)
+DEFINE_AVX512_INT_MASK(avx512_mask_i16, epi16)
+DEFINE_AVX512_INT_MASK(avx512_mask_i32, epi32)
+DEFINE_AVX512_INT_MASK(avx512_mask_i64, epi64)
+
+#define DEFINE_AVX512_FLOAT_MASK(NAME, VTYPE, SUFFIX)                                  \
+    static inline AVX512_ATTR uint64_t NAME(VTYPE v, enum libhack_compare_op op,        \
+                                            VTYPE a, VTYPE b)                          \
+    {                                                                                  \
+        switch (op)                                                                    \
+        {                                                                              \
+        case LIBHACK_CMP_EQ:                                                           \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _CMP_EQ_OQ);             \
+        case LIBHACK_CMP_NE:                                                           \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _CMP_NEQ_UQ);            \
+        case LIBHACK_CMP_LT:                                                           \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _CMP_LT_OQ);             \
+        case LIBHACK_CMP_GT:                                                           \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _CMP_GT_OQ);             \
+        default:                                                                       \
+            return (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, a, _CMP_GE_OQ) &            \
+                   (uint64_t)_mm512_cmp_##SUFFIX##_mask(v, b, _CMP_LE_OQ);             \
+        }                                                                              \
+    }
+
+DEFINE_AVX512_FLOAT_MASK(avx512_mask_f32, __m512, ps)
+DEFINE_AVX512_FLOAT_MASK(avx512_mask_f64, __m512d, pd)
+
+#define AVX512_SET1_I8(x) _mm512_set1_epi8((char)(x))
+#define AVX512_SET1_I64(x) _mm512_set1_epi64((long long)(x))
+
+DEFINE_VECTOR_KERNEL(avx512_i8, AVX512_ATTR, int8_t, i8, __m512i, AVX512_LOAD_INT, AVX512_SET1_I8, avx512_mask_i8)
+DEFINE_VECTOR_KERNEL(avx512_i16, AVX512_ATTR, int16_t, i16, __m512i, AVX512_LOAD_INT, _mm512_set1_epi16, avx512_mask_i16)
+DEFINE_VECTOR_KERNEL(avx512_i32, AVX512_ATTR, int32_t, i32, __m512i, AVX512_LOAD_INT, _mm512_set1_epi32, avx512_mask_i32)
+DEFINE_VECTOR_KERNEL(avx512_i64, AVX512_ATTR, int64_t, i64, __m512i, AVX512_LOAD_INT, AVX512_SET1_I64, avx512_mask_i64)
+DEFINE_VECTOR_KERNEL(avx512_f32, AVX512_ATTR, float, f32, __m512, AVX512_LOAD_PS, _mm512_set1_ps, avx512_mask_f32)
+DEFINE_VECTOR_KERNEL(avx512_f64, AVX512_ATTR, double, f64, __m512d, AVX512_LOAD_PD, _mm512_set1_pd, avx512_mask_f64)
+
+static const libhack_compare_kernel avx512_kernels[] = {
+    avx512_i8, avx512_i16, avx512_i32, avx512_i64, avx512_f32, avx512_f64};
+
+#endif // LIBHACK_X86
+
+enum libhack_simd_level libhack_simd_detect()
+{
+#ifdef LIBHACK_X86
+    static enum libhack_simd_level detected = LIBHACK_SIMD_SCALAR;
+    static bool done = false;
+
+    if (!done)
+    {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+            detected = LIBHACK_SIMD_AVX512;
+        else if (__builtin_cpu_supports("avx2"))
+            detected = LIBHACK_SIMD_AVX2;
+        else if (__builtin_cpu_supports("sse2"))
+            detected = LIBHACK_SIMD_SSE2;
+
+        done = true;
+    }
+
+    return detected;
+#else
+    return LIBHACK_SIMD_SCALAR;
+#endif
+}
+
+size_t libhack_compare_block_level(enum libhack_simd_level level,
+                                   const struct libhack_compare *cmp,
+                                   const void *buffer, size_t count, size_t stride,
+                                   uint64_t *mask)
+{
+    const libhack_compare_kernel *kernels = scalar_kernels;
+    size_t size;
+    size_t hits = 0;
+
+    if (!cmp || !buffer || !mask || stride == 0)
+        return 0;
+
+    size = libhack_value_size(cmp->type);
+    if (size == 0)
+        return 0;
+
+    memset(mask, 0, ((count + 63) / 64) * sizeof(uint64_t));
+
+    if (level > libhack_simd_detect())
+        level = libhack_simd_detect();
+
+#ifdef LIBHACK_X86
+    // Vector kernels only walk strides which split a value in equal phases
+    if (stride <= size && size % stride == 0)
+    {
+        switch (level)
+        {
+        case LIBHACK_SIMD_AVX512:
+            kernels = avx512_kernels;
+            break;
+        case LIBHACK_SIMD_AVX2:
+            kernels = avx2_kernels;
+            break;
+        case LIBHACK_SIMD_SSE2:
+            kernels = sse2_kernels;
+            break;
+        case LIBHACK_SIMD_SCALAR:
+            break;
+        }
+    }
+#endif
+
+    kernels[cmp->type](cmp, (const unsigned char *)buffer, count, stride, mask);
+
+    for (size_t i = 0; i < (count + 63) / 64; i++)
+        hits += (size_t)__builtin_popcountll(mask[i]);
+
+    return hits;
+}
+
+size_t libhack_compare_block(const struct libhack_compare *cmp, const void *buffer,
+                             size_t count, size_t stride, uint64_t *mask)
+{
+    return libhack_compare_block_level(libhack_simd_detect(), cmp, buffer, count,
+                                       stride, mask);
+}
+
+#endif // __linux__
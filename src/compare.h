@@ -0,0 +1,188 @@
+/**
+ * @file compare.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Vectorized comparison kernels used by scans
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_COMPARE_H
+#define LIBHACK_COMPARE_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Types of values that can be compared
+ *
+ */
+enum libhack_value_type
+{
+	LIBHACK_TYPE_INT8,
+	LIBHACK_TYPE_INT16,
+	LIBHACK_TYPE_INT32,
+	LIBHACK_TYPE_INT64,
+	LIBHACK_TYPE_FLOAT,
+	LIBHACK_TYPE_DOUBLE
+};
+
+/**
+ * @brief Comparison operators
+ *
+ */
+enum libhack_compare_op
+{
+	/**
+	 * @brief value == a
+	 *
+	 */
+	LIBHACK_CMP_EQ,
+
+	/**
+	 * @brief value != a
+	 *
+	 */
+	LIBHACK_CMP_NE,
+
+	/**
+	 * @brief value < a
+	 *
+	 */
+	LIBHACK_CMP_LT,
+
+	/**
+	 * @brief value > a
+	 *
+	 */
+	LIBHACK_CMP_GT,
+
+	/**
+	 * @brief a <= value <= b
+	 *
+	 */
+	LIBHACK_CMP_RANGE
+};
+
+/**
+ * @brief Instruction sets used by the comparison kernels
+ *
+ */
+enum libhack_simd_level
+{
+	LIBHACK_SIMD_SCALAR,
+	LIBHACK_SIMD_SSE2,
+	LIBHACK_SIMD_AVX2,
+	LIBHACK_SIMD_AVX512
+};
+
+/**
+ * @brief A value of any supported type
+ *
+ */
+union libhack_value
+{
+	int8_t i8;
+	int16_t i16;
+	int32_t i32;
+	int64_t i64;
+	float f32;
+	double f64;
+};
+
+/**
+ * @brief A comparison to be evaluated on every position of a block
+ *
+ */
+struct libhack_compare
+{
+	/**
+	 * @brief Type of values
+	 *
+	 */
+	enum libhack_value_type type;
+
+	/**
+	 * @brief Operator
+	 *
+	 */
+	enum libhack_compare_op op;
+
+	/**
+	 * @brief Operand (lower bound for LIBHACK_CMP_RANGE)
+	 *
+	 */
+	union libhack_value a;
+
+	/**
+	 * @brief Upper bound for LIBHACK_CMP_RANGE
+	 *
+	 */
+	union libhack_value b;
+};
+
+/**
+ * @brief Gets the size of a value type
+ *
+ * @param type Value type
+ * @return size_t Size in bytes
+ */
+size_t libhack_value_size(enum libhack_value_type type);
+
+/**
+ * @brief Gets the best instruction set supported by the running CPU
+ *
+ * @return enum libhack_simd_level Instruction set detected through CPUID
+ */
+enum libhack_simd_level libhack_simd_detect();
+
+/**
+ * @brief Compares every position of a block
+ *
+ * Position i is the value starting at byte i * stride, so the buffer must hold
+ * (count - 1) * stride + libhack_value_size(type) bytes. Vector kernels are
+ * used when stride divides the value size, the scalar kernel otherwise.
+ *
+ * @param cmp Comparison
+ * @param buffer Values to be compared
+ * @param count Number of positions
+ * @param stride Distance in bytes between positions
+ * @param mask Receives one bit per position ((count + 63) / 64 words)
+ * @return size_t Number of positions matching the comparison
+ */
+size_t libhack_compare_block(const struct libhack_compare *cmp, const void *buffer,
+							 size_t count, size_t stride, uint64_t *mask);
+
+/**
+ * @brief Same as libhack_compare_block, using a specific instruction set
+ *
+ * Levels not supported by the CPU fall back to the best supported one.
+ *
+ * @param level Instruction set
+ * @param cmp Comparison
+ * @param buffer Values to be compared
+ * @param count Number of positions
+ * @param stride Distance in bytes between positions
+ * @param mask Receives one bit per position ((count + 63) / 64 words)
+ * @return size_t Number of positions matching the comparison
+ */
+size_t libhack_compare_block_level(enum libhack_simd_level level, const struct libhack_compare *cmp,
+								   const void *buffer, size_t count, size_t stride, uint64_t *mask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_COMPARE_H
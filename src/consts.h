@@ -27,4 +27,28 @@
  * 
  */
 #define MAX_PROCESS_NAME 64
+
+/**
+ * @brief Maximum number of bytes requested by a single bulk read
+ * 
+ */
+#define LIBHACK_BULK_READ_CHUNK (16 * 1024 * 1024)
+
+/**
+ * @brief Default number of bytes read and compared at once by a scan worker
+ * 
+ */
+#define LIBHACK_SCAN_CHUNK (1024 * 1024)
+
+/**
+ * @brief Span of address space covered by a block of a candidate set
+ * 
+ */
+#define LIBHACK_CANDIDATE_SPAN (64 * 1024)
+
+/**
+ * @brief Number of candidate blocks re-read by a single batched read
+ * 
+ */
+#define LIBHACK_CANDIDATE_BATCH 64
 #endif // __linux__
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../init.h"
+#include "../../process.h"
+#include "../../backend.h"
+#include "../../status_codes.h"
+
+#define SCATTERED_READS 4096
+#define SEQUENTIAL_SIZE (64 * 1024 * 1024)
+#define ROUNDS 16
+
+static double now_ns() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench(struct libhack_handle *lh, enum libhack_backend_type type,
+                  unsigned char *region, unsigned char *copy) {
+    static struct libhack_mem_desc descs[SCATTERED_READS];
+    static long values[SCATTERED_READS];
+    double start, scattered, sequential;
+
+    if(libhack_set_backend(lh, type) != LIBHACK_OK) {
+        printf("backend %d is not available\n", type);
+        return;
+    }
+
+    // Small reads spread over the whole region
+    for(int i = 0; i < SCATTERED_READS; i++) {
+        descs[i].addr = (DWORD64)(region + ((size_t)rand() % (SEQUENTIAL_SIZE / sizeof(long))) * sizeof(long));
+        descs[i].buffer = &values[i];
+        descs[i].len = sizeof(long);
+    }
+
+    start = now_ns();
+    for(int i = 0; i < ROUNDS; i++) {
+        libhack_read_batch(lh, descs, SCATTERED_READS, NULL);
+    }
+    scattered = (now_ns() - start) / (ROUNDS * SCATTERED_READS);
+
+    start = now_ns();
+    for(int i = 0; i < ROUNDS; i++) {
+        libhack_read_bytes(lh, (DWORD64)region, copy, SEQUENTIAL_SIZE, NULL);
+    }
+    sequential = (ROUNDS * (double)SEQUENTIAL_SIZE) / ((now_ns() - start) / 1e9) / (1024 * 1024);
+
+    printf("%-12s scattered: %8.1f ns/read   sequential: %8.1f MiB/s\n",
+           libhack_get_backend(lh)->name, scattered, sequential);
+}
+
+int main() {
+
+    struct libhack_handle *lh = libhack_init("backend_bench");
+    unsigned char *region = malloc(SEQUENTIAL_SIZE);
+    unsigned char *copy = malloc(SEQUENTIAL_SIZE);
+
+    if(!lh || !region || !copy) {
+        printf("failed to initialize benchmark\n");
+        return 1;
+    }
+
+    // Touch every page so both backends read resident memory
+    for(size_t i = 0; i < SEQUENTIAL_SIZE; i++) {
+        region[i] = (unsigned char)i;
+    }
+
+    // Benchmark against ourselves
+    libhack_attach_pid(lh, getpid());
+
+    bench(lh, LIBHACK_BACKEND_PROCESS_VM, region, copy);
+    bench(lh, LIBHACK_BACKEND_PROC_MEM, region, copy);
+
+    libhack_free(lh);
+    free(region);
+    free(copy);
+
+    return 0;
+}
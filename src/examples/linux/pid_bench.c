@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <proc/readproc.h>
+#include "../../procfs.h"
+
+#define ROUNDS 20
+#define MAX_PIDS 64
+
+static double now_ms() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// The lookup libhack used to perform with procps
+static pid_t readproc_lookup(const char *name) {
+    PROCTAB *proc = openproc(PROC_FILLMEM | PROC_FILLSTAT | PROC_FILLSTATUS);
+    proc_t proc_info;
+    pid_t pid = -1;
+
+    if(!proc) {
+        return -1;
+    }
+
+    memset(&proc_info, 0, sizeof(proc_info));
+
+    while(readproc(proc, &proc_info) != NULL) {
+        if(strcmp(proc_info.cmd, name) == 0) {
+            pid = proc_info.tid;
+            break;
+        }
+    }
+
+    closeproc(proc);
+
+    return pid;
+}
+
+int main(int argc, char **argv) {
+
+    const char *name = argc > 1 ? argv[1] : "systemd";
+    pid_t pids[MAX_PIDS];
+    pid_t pid = -1;
+    size_t count = 0;
+    double start;
+
+    start = now_ms();
+    for(int i = 0; i < ROUNDS; i++) {
+        pid = readproc_lookup(name);
+    }
+    printf("readproc:          %8.3f ms/lookup (pid %d)\n", (now_ms() - start) / ROUNDS, pid);
+
+    start = now_ms();
+    for(int i = 0; i < ROUNDS; i++) {
+        pid = libhack_find_process(name, LIBHACK_MATCH_COMM);
+    }
+    printf("first match:       %8.3f ms/lookup (pid %d)\n", (now_ms() - start) / ROUNDS, pid);
+
+    start = now_ms();
+    for(int i = 0; i < ROUNDS; i++) {
+        count = libhack_find_processes(name, LIBHACK_MATCH_COMM, pids, MAX_PIDS);
+    }
+    printf("all matches:       %8.3f ms/lookup (%zu processes)\n", (now_ms() - start) / ROUNDS, count);
+
+    return 0;
+}
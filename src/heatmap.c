@@ -0,0 +1,492 @@
+/**
+ * @file heatmap.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Per-region access counts sampled through the kernel's idle page tracking
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "heatmap.h"
+#include "logger.h"
+#include "maps.h"
+#include "pagemap.h"
+#include "status_codes.h"
+
+/**
+ * @brief Words of the idle bitmap transferred by a single read or write
+ *
+ */
+#define HEATMAP_BITMAP_RUN 512
+
+/**
+ * @brief State of a sampled page: accessed during the interval
+ *
+ */
+#define HEATMAP_ACCESSED 0
+
+/**
+ * @brief State of a sampled page: still idle at the end of the interval
+ *
+ */
+#define HEATMAP_IDLE 1
+
+/**
+ * @brief State of a sampled page: the bitmap could not be written or read
+ *
+ */
+#define HEATMAP_UNKNOWN 2
+
+/**
+ * @brief A resident page of the process
+ *
+ */
+struct libhack_heatmap_page
+{
+	/**
+	 * @brief Page frame number
+	 *
+	 */
+	uint64_t pfn;
+
+	/**
+	 * @brief Index of the region holding the page
+	 *
+	 */
+	size_t region;
+};
+
+struct libhack_heatmap
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Descriptor of LIBHACK_PAGE_IDLE_BITMAP (opened on first sample)
+	 *
+	 */
+	int idle_fd;
+
+	/**
+	 * @brief Regions sorted by address
+	 *
+	 */
+	struct libhack_heatmap_region *regions;
+
+	/**
+	 * @brief Number of regions
+	 *
+	 */
+	size_t count;
+};
+
+static int libhack_heatmap_page_compare(const void *a, const void *b)
+{
+    uint64_t x = ((const struct libhack_heatmap_page *)a)->pfn;
+    uint64_t y = ((const struct libhack_heatmap_page *)b)->pfn;
+
+    return (x > y) - (x < y);
+}
+
+struct libhack_heatmap *libhack_heatmap_create(struct libhack_handle *handle)
+{
+    struct libhack_heatmap *heat;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, NULL);
+
+    heat = (struct libhack_heatmap *)calloc(1, sizeof(struct libhack_heatmap));
+    if (!heat)
+        return NULL;
+
+    heat->handle = handle;
+    heat->idle_fd = -1;
+
+    return heat;
+}
+
+/**
+ * @brief Replaces the regions by the current layout, keeping the counts of unchanged regions
+ *
+ * @param heat Heatmap
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_heatmap_update_regions(struct libhack_heatmap *heat)
+{
+    struct libhack_heatmap_region *regions;
+    const struct libhack_maps *maps;
+    size_t count = 0;
+    size_t old = 0;
+
+    if (libhack_maps_update(heat->handle, NULL) != LIBHACK_OK)
+        return ESRCH;
+
+    maps = libhack_get_maps(heat->handle);
+    if (!maps)
+        return ESRCH;
+
+    regions = (struct libhack_heatmap_region *)calloc(maps->count + 1,
+                                                      sizeof(struct libhack_heatmap_region));
+    if (!regions)
+        return ENOMEM;
+
+    for (size_t i = 0; i < maps->count; i++)
+    {
+        const struct libhack_region *region = &maps->regions[i];
+        struct libhack_heatmap_region *entry;
+
+        if (!libhack_region_readable(region))
+            continue;
+
+        entry = &regions[count++];
+        entry->start = region->start;
+        entry->end = region->end;
+
+        while (old < heat->count && heat->regions[old].start < region->start)
+            old++;
+
+        if (old < heat->count && heat->regions[old].start == region->start &&
+            heat->regions[old].end == region->end)
+        {
+            entry->sampled = heat->regions[old].sampled;
+            entry->accessed = heat->regions[old].accessed;
+            entry->shared = heat->regions[old].shared;
+        }
+    }
+
+    free(heat->regions);
+    heat->regions = regions;
+    heat->count = count;
+
+    return LIBHACK_OK;
+}
+
+static bool libhack_heatmap_push(struct libhack_heatmap_page **pages, size_t *count,
+                                 size_t *capacity, uint64_t pfn, size_t region)
+{
+    if (*count == *capacity)
+    {
+        size_t new_capacity = *capacity ? *capacity * 2 : 4096;
+        struct libhack_heatmap_page *grown = (struct libhack_heatmap_page *)realloc(
+            *pages, new_capacity * sizeof(struct libhack_heatmap_page));
+
+        if (!grown)
+            return false;
+
+        *pages = grown;
+        *capacity = new_capacity;
+    }
+
+    (*pages)[*count].pfn = pfn;
+    (*pages)[*count].region = region;
+    (*count)++;
+
+    return true;
+}
+
+/**
+ * @brief Lists the resident pages of every region
+ *
+ * @param heat Heatmap
+ * @param pages Receives the pages (release with free)
+ * @param count Receives the number of pages
+ * @return long LIBHACK_OK on success, EPERM if page frame numbers are hidden or errno value
+ */
+static long libhack_heatmap_collect(struct libhack_heatmap *heat,
+                                    struct libhack_heatmap_page **pages, size_t *count)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uint64_t entries[LIBHACK_PAGEMAP_BATCH];
+    size_t capacity = 0;
+    bool hidden = false;
+
+    *pages = NULL;
+    *count = 0;
+
+    for (size_t r = 0; r < heat->count; r++)
+    {
+        const struct libhack_heatmap_region *region = &heat->regions[r];
+
+        for (DWORD64 addr = region->start; addr < region->end; addr += LIBHACK_PAGEMAP_BATCH * page)
+        {
+            size_t batch = (size_t)((region->end - addr) / page);
+            long status;
+
+            if (batch > LIBHACK_PAGEMAP_BATCH)
+                batch = LIBHACK_PAGEMAP_BATCH;
+
+            status = libhack_pagemap_read(heat->handle, addr, batch, entries);
+
+            // Regions may vanish while they are sampled: only stop if the process is gone
+            if (status != LIBHACK_OK && status != ESRCH)
+                continue;
+
+            for (size_t i = 0; i < batch && status == LIBHACK_OK; i++)
+            {
+                uint64_t pfn = entries[i] & LIBHACK_PAGEMAP_PFN_MASK;
+
+                if (!(entries[i] & LIBHACK_PAGEMAP_PRESENT))
+                    continue;
+
+                if (pfn == 0)
+                {
+                    hidden = true;
+                    continue;
+                }
+
+                // Shared by every process and never reclaimed
+                if (libhack_pagemap_is_zero_page(entries[i]))
+                    continue;
+
+                // Accesses of other processes would clear the idle bit of shared pages too
+                if (!(entries[i] & LIBHACK_PAGEMAP_EXCLUSIVE))
+                {
+                    heat->regions[r].shared++;
+                    continue;
+                }
+
+                if (!libhack_heatmap_push(pages, count, &capacity, pfn, r))
+                    status = ENOMEM;
+            }
+
+            if (status != LIBHACK_OK)
+            {
+                free(*pages);
+                *pages = NULL;
+                *count = 0;
+                return status;
+            }
+        }
+    }
+
+    if (*count == 0 && hidden)
+        return EPERM;
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Marks pages idle or checks which of them are still idle
+ *
+ * Pages are grouped by the words of the bitmap they fall in, so sorted pages
+ * take one system call per HEATMAP_BITMAP_RUN words. Writing a zero bit leaves
+ * the page untouched.
+ *
+ * @param fd Descriptor of the idle bitmap
+ * @param pages Pages sorted by page frame number
+ * @param count Number of pages
+ * @param mark true to mark the pages idle, false to check them
+ * @param state Receives the HEATMAP_* state of each page (checks skip unknown pages)
+ * @return size_t Number of pages which could not be marked or checked
+ */
+static size_t libhack_heatmap_bitmap(int fd, const struct libhack_heatmap_page *pages,
+                                     size_t count, bool mark, unsigned char *state)
+{
+    uint64_t words[HEATMAP_BITMAP_RUN];
+    size_t failed = 0;
+
+    for (size_t i = 0; i < count;)
+    {
+        uint64_t first = pages[i].pfn / 64;
+        size_t end = i;
+        size_t len;
+        ssize_t done;
+
+        while (end < count && pages[end].pfn / 64 - first < HEATMAP_BITMAP_RUN)
+            end++;
+
+        len = (size_t)(pages[end - 1].pfn / 64 - first + 1) * sizeof(uint64_t);
+
+        if (mark)
+        {
+            memset(words, 0, len);
+
+            for (size_t j = i; j < end; j++)
+                words[pages[j].pfn / 64 - first] |= 1ULL << (pages[j].pfn % 64);
+
+            done = pwrite(fd, words, len, (off_t)(first * sizeof(uint64_t)));
+        }
+        else
+        {
+            done = pread(fd, words, len, (off_t)(first * sizeof(uint64_t)));
+        }
+
+        for (size_t j = i; j < end; j++)
+        {
+            size_t word = (size_t)(pages[j].pfn / 64 - first);
+            bool ok = done > 0 && (size_t)done >= (word + 1) * sizeof(uint64_t);
+
+            if (mark)
+                state[j] = ok ? HEATMAP_ACCESSED : HEATMAP_UNKNOWN;
+            else if (state[j] != HEATMAP_UNKNOWN)
+                state[j] = !ok ? HEATMAP_UNKNOWN
+                               : (words[word] >> (pages[j].pfn % 64)) & 1 ? HEATMAP_IDLE
+                                                                         : HEATMAP_ACCESSED;
+
+            failed += !ok;
+        }
+
+        i = end;
+    }
+
+    return failed;
+}
+
+long libhack_heatmap_sample(struct libhack_heatmap *heat, unsigned int interval_ms)
+{
+    struct libhack_heatmap_page *pages = NULL;
+    unsigned char *state = NULL;
+    struct timespec interval;
+    size_t accessed = 0;
+    size_t count = 0;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(heat != NULL, -1);
+
+    if (heat->idle_fd == -1)
+    {
+        heat->idle_fd = open(LIBHACK_PAGE_IDLE_BITMAP, O_RDWR | O_CLOEXEC);
+        if (heat->idle_fd == -1)
+        {
+            libhack_err("failed to open %s: %d", LIBHACK_PAGE_IDLE_BITMAP, errno);
+            return errno;
+        }
+    }
+
+    status = libhack_heatmap_update_regions(heat);
+    if (status != LIBHACK_OK)
+        return status;
+
+    status = libhack_heatmap_collect(heat, &pages, &count);
+    if (status != LIBHACK_OK)
+        return status;
+
+    if (count == 0)
+        return LIBHACK_OK;
+
+    state = (unsigned char *)malloc(count);
+    if (!state)
+    {
+        free(pages);
+        return ENOMEM;
+    }
+
+    qsort(pages, count, sizeof(struct libhack_heatmap_page), libhack_heatmap_page_compare);
+
+    // Pages which were never marked tell nothing about the interval
+    if (libhack_heatmap_bitmap(heat->idle_fd, pages, count, true, state) == count)
+    {
+        libhack_err("failed to mark the pages of %d idle: %d", heat->handle->pid, errno);
+        status = errno ? errno : EIO;
+        goto out;
+    }
+
+    // Pages the kernel cannot track (not on an LRU list) ignore the mark and never look idle
+    libhack_heatmap_bitmap(heat->idle_fd, pages, count, false, state);
+
+    for (size_t i = 0; i < count; i++)
+        state[i] = state[i] == HEATMAP_IDLE ? HEATMAP_ACCESSED : HEATMAP_UNKNOWN;
+
+    interval.tv_sec = interval_ms / 1000;
+    interval.tv_nsec = (long)(interval_ms % 1000) * 1000000L;
+
+    while (nanosleep(&interval, &interval) == -1 && errno == EINTR)
+        ;
+
+    libhack_heatmap_bitmap(heat->idle_fd, pages, count, false, state);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        struct libhack_heatmap_region *region = &heat->regions[pages[i].region];
+
+        // Set by the kernel on the first access after the page was marked
+        if (state[i] == HEATMAP_ACCESSED)
+        {
+            region->accessed++;
+            accessed++;
+        }
+
+        if (state[i] != HEATMAP_UNKNOWN)
+            region->sampled++;
+    }
+
+    libhack_debug("heatmap of %d: %zu of %zu resident pages accessed in %u ms",
+                  heat->handle->pid, accessed, count, interval_ms);
+
+out:
+    free(pages);
+    free(state);
+
+    return status;
+}
+
+const struct libhack_heatmap_region *libhack_heatmap_regions(const struct libhack_heatmap *heat,
+                                                             size_t *count)
+{
+    // Sanity checking
+    libhack_assert_or_return(heat != NULL && count != NULL, NULL);
+
+    *count = heat->count;
+
+    return heat->regions;
+}
+
+const struct libhack_heatmap_region *libhack_heatmap_find(const struct libhack_heatmap *heat,
+                                                          DWORD64 addr)
+{
+    size_t low = 0;
+    size_t high;
+
+    if (!heat)
+        return NULL;
+
+    high = heat->count;
+
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+
+        if (addr < heat->regions[mid].start)
+            high = mid;
+        else if (addr >= heat->regions[mid].end)
+            low = mid + 1;
+        else
+            return &heat->regions[mid];
+    }
+
+    return NULL;
+}
+
+void libhack_heatmap_free(struct libhack_heatmap *heat)
+{
+    if (!heat)
+        return;
+
+    if (heat->idle_fd != -1)
+        close(heat->idle_fd);
+
+    free(heat->regions);
+    free(heat);
+}
+
+#endif // __linux__
@@ -0,0 +1,135 @@
+/**
+ * @file heatmap.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Per-region access counts sampled through the kernel's idle page tracking
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_HEATMAP_H
+#define LIBHACK_HEATMAP_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stddef.h>
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Bitmap of idle page frames exported by the kernel (CONFIG_IDLE_PAGE_TRACKING)
+ *
+ */
+#define LIBHACK_PAGE_IDLE_BITMAP "/sys/kernel/mm/page_idle/bitmap"
+
+/**
+ * @brief Access counts of the regions of a process
+ *
+ * Each sample marks the resident pages of the process idle, waits and counts
+ * the pages the process touched in the meantime. Only pages mapped by the
+ * process alone are sampled, since any process touching a shared page clears
+ * its idle bit, and pages the kernel cannot track are left out. Counts of a
+ * region are kept across samples as long as the region keeps its bounds.
+ *
+ */
+struct libhack_heatmap;
+
+/**
+ * @brief Access counts of a region
+ *
+ */
+struct libhack_heatmap_region
+{
+	/**
+	 * @brief First address of the region
+	 *
+	 */
+	DWORD64 start;
+
+	/**
+	 * @brief End of the region (exclusive)
+	 *
+	 */
+	DWORD64 end;
+
+	/**
+	 * @brief Resident pages of the process alone seen by the samples (summed over the samples)
+	 *
+	 */
+	size_t sampled;
+
+	/**
+	 * @brief Pages read or written during the intervals (summed over the samples)
+	 *
+	 */
+	size_t accessed;
+
+	/**
+	 * @brief Resident pages left out because other processes map them too (summed over the samples)
+	 *
+	 */
+	size_t shared;
+};
+
+/**
+ * @brief Creates an empty heatmap bound to a handle
+ *
+ * @param handle Handle to libhack
+ * @return struct libhack_heatmap* Heatmap or NULL on error
+ */
+struct libhack_heatmap *libhack_heatmap_create(struct libhack_handle *handle);
+
+/**
+ * @brief Counts the pages of each region accessed during an interval
+ *
+ * Page frame numbers are only visible with CAP_SYS_ADMIN, which is also needed
+ * to open LIBHACK_PAGE_IDLE_BITMAP. The calling thread sleeps for the interval.
+ *
+ * @param heat Heatmap
+ * @param interval_ms Time the process is given to access its pages
+ * @return long LIBHACK_OK on success, EPERM if page frame numbers are hidden or errno value
+ */
+long libhack_heatmap_sample(struct libhack_heatmap *heat, unsigned int interval_ms);
+
+/**
+ * @brief Gets the regions of a heatmap, sorted by address
+ *
+ * @param heat Heatmap
+ * @param count Receives the number of regions
+ * @return const struct libhack_heatmap_region* Regions (valid until the next sample)
+ */
+const struct libhack_heatmap_region *libhack_heatmap_regions(const struct libhack_heatmap *heat,
+															 size_t *count);
+
+/**
+ * @brief Finds the region of a heatmap holding an address
+ *
+ * @param heat Heatmap
+ * @param addr Address
+ * @return const struct libhack_heatmap_region* Region or NULL if the address was not sampled
+ */
+const struct libhack_heatmap_region *libhack_heatmap_find(const struct libhack_heatmap *heat,
+														  DWORD64 addr);
+
+/**
+ * @brief Releases a heatmap
+ *
+ * @param heat Heatmap
+ */
+void libhack_heatmap_free(struct libhack_heatmap *heat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_HEATMAP_H
@@ -0,0 +1,109 @@
+/**
+ * @file image.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Local mappings of the files behind remote regions
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+#include "image.h"
+#include "logger.h"
+#include "status_codes.h"
+
+long libhack_image_map(const struct libhack_handle *handle, const struct libhack_region *region,
+                       struct libhack_image *image)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t region_size;
+    char path[PATH_MAX + 32];
+    struct stat st;
+    void *data;
+    int fd;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && region != NULL && image != NULL, -1);
+
+    memset(image, 0, sizeof(*image));
+
+    if (region->inode == 0 || region->pathname[0] != '/')
+        return ENOENT;
+
+    snprintf(path, sizeof(path), "/proc/%d/root%s", handle->pid, region->pathname);
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return errno;
+
+    if (fstat(fd, &st) == -1)
+    {
+        close(fd);
+        return errno;
+    }
+
+    // A file replaced on disk after being mapped is a different inode
+    if (st.st_ino != (ino_t)region->inode || major(st.st_dev) != region->dev_major ||
+        minor(st.st_dev) != region->dev_minor)
+    {
+        libhack_debug("%s does not match the mapped file anymore", region->pathname);
+        close(fd);
+        return ESTALE;
+    }
+
+    if ((DWORD64)st.st_size <= region->offset)
+    {
+        close(fd);
+        return ENOENT;
+    }
+
+    // Touching pages past the end of the file raises SIGBUS
+    region_size = (size_t)(region->end - region->start);
+    image->size = ((size_t)((DWORD64)st.st_size - region->offset) + page - 1) & ~(page - 1);
+    if (image->size > region_size)
+        image->size = region_size;
+
+    data = mmap(NULL, image->size, PROT_READ, MAP_PRIVATE, fd, (off_t)region->offset);
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        long status = errno;
+
+        libhack_debug("failed to map %s: %ld", region->pathname, status);
+        memset(image, 0, sizeof(*image));
+        return status;
+    }
+
+    image->data = (const unsigned char *)data;
+    image->start = region->start;
+
+    return LIBHACK_OK;
+}
+
+void libhack_image_unmap(struct libhack_image *image)
+{
+    if (!image || !image->data)
+        return;
+
+    munmap((void *)image->data, image->size);
+    memset(image, 0, sizeof(*image));
+}
+
+#endif // __linux__
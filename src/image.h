@@ -0,0 +1,82 @@
+/**
+ * @file image.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Local mappings of the files behind remote regions
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_IMAGE_H
+#define LIBHACK_IMAGE_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stddef.h>
+#include "init.h"
+#include "maps.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Read-only local mapping of the file behind a remote region
+ *
+ */
+struct libhack_image
+{
+	/**
+	 * @brief Bytes of the file mapped at the offset of the region
+	 *
+	 */
+	const unsigned char *data;
+
+	/**
+	 * @brief Size of the local mapping (bytes of the region backed by the file)
+	 *
+	 */
+	size_t size;
+
+	/**
+	 * @brief Remote address of data[0]
+	 *
+	 */
+	DWORD64 start;
+};
+
+/**
+ * @brief Maps locally the file behind a remote region
+ *
+ * The file is opened through /proc/<pid>/root, so targets in another mount
+ * namespace are supported, and must be the same inode on the same device as
+ * the one mapped by the process. Pages past the end of the file are left out
+ * of the image.
+ *
+ * @param handle Handle to libhack
+ * @param region File-backed region of the process
+ * @param image Receives the mapping
+ * @return long LIBHACK_OK on success or errno value (ESTALE if the file was replaced)
+ */
+long libhack_image_map(const struct libhack_handle *handle, const struct libhack_region *region,
+                       struct libhack_image *image);
+
+/**
+ * @brief Releases the mapping of an image
+ *
+ * @param image Image
+ */
+void libhack_image_unmap(struct libhack_image *image);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_IMAGE_H
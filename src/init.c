@@ -19,6 +19,7 @@
 
 #ifdef __linux__
 #include <errno.h>
+#include <unistd.h>
 #endif
 #include <string.h>
 #include <stdlib.h>
@@ -28,6 +29,12 @@
 #include "logger.h"
 #include "../autorevision.h"
 
+#ifdef __linux__
+#include "backend.h"
+#include "maps.h"
+#include "pagemap.h"
+#endif
+
 /**
  * @brief Contains version number
  *
@@ -154,15 +161,34 @@ struct libhack_handle *libhack_init(const char *process_name)
 
     // Initializes value for process ID
     lh->pid = -1;
+    lh->pidfd = -1;
 
     // Initializes default base address
     lh->base_addr = -1;
 
+    // Backend is selected once the process ID is known
+    lh->backend = NULL;
+    lh->mem_fd = -1;
+    lh->pagemap_fd = -1;
+
+    // Region table is parsed on first use
+    lh->maps = NULL;
+
     return lh;
 }
 
 void libhack_free(struct libhack_handle *lh)
 {
+    if (!lh)
+        return;
+
+    libhack_backend_detach(lh);
+    libhack_pagemap_close(lh);
+
+    if (lh->pidfd != -1)
+        close(lh->pidfd);
+
+    libhack_maps_free(lh->maps);
     free(lh);
 }
 
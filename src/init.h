@@ -165,6 +165,9 @@ LIBHACK_API const char *libhack_getversion();
 
 #elif defined(__linux__)
 
+struct libhack_backend;
+struct libhack_maps;
+
 struct libhack_handle {
 
 	/**
@@ -179,11 +182,41 @@ struct libhack_handle {
 	 */
 	pid_t pid;
 
+	/**
+	 * @brief Descriptor referring to the process (-1 if not available)
+	 *
+	 */
+	int pidfd;
+
 	/**
 	 * @brief Base address
 	 *
 	 */
 	long base_addr;
+
+	/**
+	 * @brief Memory access backend used for reads and writes
+	 *
+	 */
+	const struct libhack_backend *backend;
+
+	/**
+	 * @brief Descriptor of /proc/<pid>/mem (-1 if not opened)
+	 *
+	 */
+	int mem_fd;
+
+	/**
+	 * @brief Descriptor of /proc/<pid>/pagemap (-1 if not opened)
+	 *
+	 */
+	int pagemap_fd;
+
+	/**
+	 * @brief Cached region table (NULL until first used)
+	 *
+	 */
+	struct libhack_maps *maps;
 };
 
 struct libhack_handle *libhack_init(const char *process_name);
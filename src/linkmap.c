@@ -0,0 +1,563 @@
+/**
+ * @file linkmap.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Enumeration of loaded libraries through the dynamic loader's link_map
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <elf.h>
+#include <errno.h>
+#include <limits.h>
+#include <link.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "linkmap.h"
+#include "logger.h"
+#include "process.h"
+#include "status_codes.h"
+
+/**
+ * @brief Bytes of every name fetched by the batched read
+ *
+ */
+#define LINKMAP_NAME_CHUNK 256
+
+/**
+ * @brief Longest list accepted, guarding against corrupted or cyclic lists
+ *
+ */
+#define LINKMAP_MAX_ENTRIES 65536
+
+/**
+ * @brief struct r_debug of a 64-bit process
+ *
+ */
+struct libhack_remote_r_debug
+{
+	int32_t r_version;
+	int32_t pad;
+	uint64_t r_map;
+	uint64_t r_brk;
+	int32_t r_state;
+	int32_t pad2;
+	uint64_t r_ldbase;
+};
+
+/**
+ * @brief Public part of struct link_map of a 64-bit process
+ *
+ */
+struct libhack_remote_link_map
+{
+	uint64_t l_addr;
+	uint64_t l_name;
+	uint64_t l_ld;
+	uint64_t l_next;
+	uint64_t l_prev;
+};
+
+struct libhack_link_map
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Process r_debug belongs to
+	 *
+	 */
+	pid_t pid;
+
+	/**
+	 * @brief Remote address of r_debug (0 until located)
+	 *
+	 */
+	DWORD64 r_debug;
+
+	/**
+	 * @brief r_debug as seen by the last refresh
+	 *
+	 */
+	struct libhack_remote_r_debug state;
+
+	/**
+	 * @brief Libraries in load order
+	 *
+	 */
+	struct libhack_link_module *modules;
+
+	/**
+	 * @brief l_next and l_prev of every library as seen by the last refresh
+	 *
+	 */
+	uint64_t *links;
+
+	/**
+	 * @brief Number of libraries
+	 *
+	 */
+	size_t count;
+
+	/**
+	 * @brief Pool holding the names
+	 *
+	 */
+	char *names;
+};
+
+/**
+ * @brief Reads a whole range from the process
+ *
+ * @param handle Handle to libhack
+ * @param addr Remote address
+ * @param buffer Local buffer
+ * @param len Number of bytes
+ * @return long LIBHACK_OK if every byte was read or errno value
+ */
+static long libhack_link_map_read(struct libhack_handle *handle, DWORD64 addr, void *buffer,
+                                  size_t len)
+{
+    long status = libhack_read_bytes(handle, addr, buffer, len, NULL);
+
+    return status == EFAULT ? EIO : status;
+}
+
+/**
+ * @brief Reads a null terminated string, one page at a time
+ *
+ * @param handle Handle to libhack
+ * @param addr Remote address
+ * @param buffer Local buffer
+ * @param size Size of buffer (longer strings are truncated)
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_link_map_read_string(struct libhack_handle *handle, DWORD64 addr,
+                                         char *buffer, size_t size)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t pos = 0;
+
+    while (pos + 1 < size)
+    {
+        size_t n = page - (size_t)((addr + pos) & (page - 1));
+        long status;
+
+        if (n > size - 1 - pos)
+            n = size - 1 - pos;
+
+        status = libhack_link_map_read(handle, addr + pos, buffer + pos, n);
+        if (status != LIBHACK_OK)
+            return status;
+
+        if (memchr(buffer + pos, '\0', n))
+            return LIBHACK_OK;
+
+        pos += n;
+    }
+
+    buffer[size - 1] = '\0';
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Finds r_debug through DT_DEBUG of the main executable
+ *
+ * @param lm Library list
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_link_map_locate(struct libhack_link_map *lm)
+{
+    struct libhack_exe_layout layout;
+    Elf64_Dyn *dyn;
+    size_t dyn_count;
+    long status;
+
+    status = libhack_get_exe_layout(lm->handle, &layout);
+    if (status != LIBHACK_OK)
+        return status;
+
+    // Static executables have no dynamic section and no loader
+    dyn_count = layout.dynamic_size / sizeof(Elf64_Dyn);
+    if (dyn_count == 0)
+        return ENOENT;
+
+    dyn = (Elf64_Dyn *)malloc(dyn_count * sizeof(Elf64_Dyn));
+    if (!dyn)
+        return ENOMEM;
+
+    status = libhack_link_map_read(lm->handle, layout.dynamic, dyn, dyn_count * sizeof(Elf64_Dyn));
+    if (status == LIBHACK_OK)
+    {
+        status = ENOENT;
+
+        for (size_t i = 0; i < dyn_count && dyn[i].d_tag != DT_NULL; i++)
+        {
+            // Filled by the loader at startup
+            if (dyn[i].d_tag == DT_DEBUG && dyn[i].d_un.d_ptr != 0)
+            {
+                lm->r_debug = dyn[i].d_un.d_ptr;
+                status = LIBHACK_OK;
+                break;
+            }
+        }
+    }
+
+    free(dyn);
+
+    if (status == LIBHACK_OK)
+        libhack_debug("r_debug of %d is at %llx", lm->handle->pid, lm->r_debug);
+
+    return status;
+}
+
+/**
+ * @brief Reads the names of every library in one batched read
+ *
+ * Each name is read up to the end of its page so that a short name next to
+ * an unmapped page does not fail; names not ending there are completed one
+ * by one.
+ *
+ * @param lm Library list
+ * @param name_addrs Remote address of every name
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_link_map_read_names(struct libhack_link_map *lm, const uint64_t *name_addrs)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    struct libhack_mem_desc *descs;
+    long *status;
+    char *chunks;
+    size_t pool_len = 0;
+    long result = LIBHACK_OK;
+
+    descs = (struct libhack_mem_desc *)calloc(lm->count, sizeof(struct libhack_mem_desc));
+    status = (long *)calloc(lm->count, sizeof(long));
+    chunks = (char *)calloc(lm->count, LINKMAP_NAME_CHUNK);
+    if (!descs || !status || !chunks)
+    {
+        result = ENOMEM;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < lm->count; i++)
+    {
+        size_t left = page - (size_t)(name_addrs[i] & (page - 1));
+
+        descs[i].addr = name_addrs[i];
+        descs[i].buffer = chunks + i * LINKMAP_NAME_CHUNK;
+        descs[i].len = left < LINKMAP_NAME_CHUNK - 1 ? left : LINKMAP_NAME_CHUNK - 1;
+    }
+
+    libhack_read_batch(lm->handle, descs, lm->count, status);
+
+    for (size_t i = 0; i < lm->count; i++)
+    {
+        char *name = chunks + i * LINKMAP_NAME_CHUNK;
+        size_t len;
+
+        if (name_addrs[i] == 0 || status[i] != LIBHACK_OK)
+            name[0] = '\0';
+
+        // Names not ending in the chunk are read again in full
+        len = strnlen(name, descs[i].len);
+        pool_len += len == descs[i].len ? PATH_MAX : len + 1;
+    }
+
+    lm->names = (char *)malloc(pool_len);
+    if (!lm->names)
+    {
+        result = ENOMEM;
+        goto cleanup;
+    }
+
+    pool_len = 0;
+    for (size_t i = 0; i < lm->count; i++)
+    {
+        char *name = chunks + i * LINKMAP_NAME_CHUNK;
+        size_t len = strnlen(name, descs[i].len);
+
+        lm->modules[i].name = lm->names + pool_len;
+
+        if (len == descs[i].len)
+        {
+            long read_status = libhack_link_map_read_string(lm->handle, name_addrs[i],
+                                                            lm->names + pool_len, PATH_MAX);
+            if (read_status != LIBHACK_OK)
+                lm->names[pool_len] = '\0';
+
+            pool_len += strlen(lm->names + pool_len) + 1;
+            continue;
+        }
+
+        memcpy(lm->names + pool_len, name, len);
+        lm->names[pool_len + len] = '\0';
+        pool_len += len + 1;
+    }
+
+cleanup:
+    free(descs);
+    free(status);
+    free(chunks);
+
+    return result;
+}
+
+/**
+ * @brief Drops the libraries of the last refresh
+ *
+ * @param lm Library list
+ */
+static void libhack_link_map_clear(struct libhack_link_map *lm)
+{
+    free(lm->modules);
+    free(lm->links);
+    free(lm->names);
+
+    lm->modules = NULL;
+    lm->links = NULL;
+    lm->names = NULL;
+    lm->count = 0;
+}
+
+struct libhack_link_map *libhack_link_map_create(struct libhack_handle *handle)
+{
+    struct libhack_link_map *lm;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, NULL);
+
+    lm = (struct libhack_link_map *)calloc(1, sizeof(struct libhack_link_map));
+    if (!lm)
+        return NULL;
+
+    lm->handle = handle;
+    lm->pid = -1;
+
+    return lm;
+}
+
+long libhack_link_map_refresh(struct libhack_link_map *lm)
+{
+    struct libhack_remote_r_debug r_debug;
+    uint64_t *name_addrs = NULL;
+    size_t capacity = 0;
+    DWORD64 node;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(lm != NULL, -1);
+
+    if (lm->handle->pid == -1)
+        return ESRCH;
+
+    // r_debug is located once per process
+    if (lm->pid != lm->handle->pid)
+    {
+        lm->r_debug = 0;
+        lm->pid = lm->handle->pid;
+    }
+
+    if (lm->r_debug == 0)
+    {
+        status = libhack_link_map_locate(lm);
+        if (status != LIBHACK_OK)
+            return status;
+    }
+
+    status = libhack_link_map_read(lm->handle, lm->r_debug, &r_debug, sizeof(r_debug));
+    if (status != LIBHACK_OK)
+        return status;
+
+    if (r_debug.r_state != RT_CONSISTENT)
+        return EAGAIN;
+
+    libhack_link_map_clear(lm);
+
+    for (node = r_debug.r_map; node != 0; )
+    {
+        struct libhack_remote_link_map entry;
+
+        if (lm->count == LINKMAP_MAX_ENTRIES)
+        {
+            status = ELOOP;
+            goto error;
+        }
+
+        status = libhack_link_map_read(lm->handle, node, &entry, sizeof(entry));
+        if (status != LIBHACK_OK)
+            goto error;
+
+        if (lm->count == capacity)
+        {
+            size_t new_capacity = capacity ? capacity * 2 : 64;
+            struct libhack_link_module *modules;
+            uint64_t *links;
+            uint64_t *addrs;
+
+            modules = (struct libhack_link_module *)realloc(
+                lm->modules, new_capacity * sizeof(struct libhack_link_module));
+            if (modules)
+                lm->modules = modules;
+
+            links = (uint64_t *)realloc(lm->links, new_capacity * 2 * sizeof(uint64_t));
+            if (links)
+                lm->links = links;
+
+            addrs = (uint64_t *)realloc(name_addrs, new_capacity * sizeof(uint64_t));
+            if (addrs)
+                name_addrs = addrs;
+
+            if (!modules || !links || !addrs)
+            {
+                status = ENOMEM;
+                goto error;
+            }
+
+            capacity = new_capacity;
+        }
+
+        lm->modules[lm->count].name = NULL;
+        lm->modules[lm->count].bias = entry.l_addr;
+        lm->modules[lm->count].dynamic = entry.l_ld;
+        lm->modules[lm->count].node = node;
+        lm->links[lm->count * 2] = entry.l_next;
+        lm->links[lm->count * 2 + 1] = entry.l_prev;
+        name_addrs[lm->count] = entry.l_name;
+        lm->count++;
+
+        node = entry.l_next;
+    }
+
+    if (lm->count > 0)
+    {
+        status = libhack_link_map_read_names(lm, name_addrs);
+        if (status != LIBHACK_OK)
+            goto error;
+    }
+
+    free(name_addrs);
+    lm->state = r_debug;
+
+    libhack_debug("%zu libraries loaded by %d", lm->count, lm->handle->pid);
+
+    return LIBHACK_OK;
+
+error:
+    free(name_addrs);
+    libhack_link_map_clear(lm);
+
+    return status;
+}
+
+long libhack_link_map_changed(struct libhack_link_map *lm, bool *changed)
+{
+    struct libhack_remote_r_debug r_debug;
+    struct libhack_mem_desc *descs;
+    uint64_t *links;
+    long *status;
+    long result = LIBHACK_OK;
+
+    // Sanity checking
+    libhack_assert_or_return(lm != NULL && changed != NULL, -1);
+
+    *changed = true;
+
+    if (lm->r_debug == 0 || lm->pid != lm->handle->pid)
+        return LIBHACK_OK;
+
+    descs = (struct libhack_mem_desc *)malloc((lm->count + 1) * sizeof(struct libhack_mem_desc));
+    links = (uint64_t *)malloc((lm->count * 2 + 1) * sizeof(uint64_t));
+    status = (long *)malloc((lm->count + 1) * sizeof(long));
+    if (!descs || !links || !status)
+    {
+        result = ENOMEM;
+        goto cleanup;
+    }
+
+    descs[0].addr = lm->r_debug;
+    descs[0].buffer = &r_debug;
+    descs[0].len = sizeof(r_debug);
+
+    // l_next and l_prev are adjacent in every entry
+    for (size_t i = 0; i < lm->count; i++)
+    {
+        descs[i + 1].addr = lm->modules[i].node + offsetof(struct libhack_remote_link_map, l_next);
+        descs[i + 1].buffer = &links[i * 2];
+        descs[i + 1].len = 2 * sizeof(uint64_t);
+    }
+
+    libhack_read_batch(lm->handle, descs, lm->count + 1, status);
+
+    if (status[0] != LIBHACK_OK)
+    {
+        result = status[0];
+        goto cleanup;
+    }
+
+    if (r_debug.r_map != lm->state.r_map || r_debug.r_brk != lm->state.r_brk ||
+        r_debug.r_state != lm->state.r_state)
+        goto cleanup;
+
+    for (size_t i = 0; i < lm->count; i++)
+    {
+        // An entry that cannot be read anymore was unloaded
+        if (status[i + 1] != LIBHACK_OK || links[i * 2] != lm->links[i * 2] ||
+            links[i * 2 + 1] != lm->links[i * 2 + 1])
+            goto cleanup;
+    }
+
+    *changed = false;
+
+cleanup:
+    free(descs);
+    free(links);
+    free(status);
+
+    return result;
+}
+
+size_t libhack_link_map_count(const struct libhack_link_map *lm)
+{
+    return lm ? lm->count : 0;
+}
+
+const struct libhack_link_module *libhack_link_map_get(const struct libhack_link_map *lm,
+                                                       size_t index)
+{
+    if (!lm || index >= lm->count)
+        return NULL;
+
+    return &lm->modules[index];
+}
+
+DWORD64 libhack_link_map_brk(const struct libhack_link_map *lm)
+{
+    return lm ? lm->state.r_brk : 0;
+}
+
+void libhack_link_map_free(struct libhack_link_map *lm)
+{
+    if (!lm)
+        return;
+
+    libhack_link_map_clear(lm);
+    free(lm);
+}
+
+#endif // __linux__
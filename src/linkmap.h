@@ -0,0 +1,142 @@
+/**
+ * @file linkmap.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Enumeration of loaded libraries through the dynamic loader's link_map
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_LINKMAP_H
+#define LIBHACK_LINKMAP_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A library known to the dynamic loader of the process
+ *
+ */
+struct libhack_link_module
+{
+	/**
+	 * @brief Pathname as recorded by the loader ("" for the main executable)
+	 *
+	 */
+	const char *name;
+
+	/**
+	 * @brief Difference between runtime addresses and ELF virtual addresses (l_addr)
+	 *
+	 */
+	DWORD64 bias;
+
+	/**
+	 * @brief Runtime address of the dynamic section (l_ld)
+	 *
+	 */
+	DWORD64 dynamic;
+
+	/**
+	 * @brief Remote address of the link_map entry
+	 *
+	 */
+	DWORD64 node;
+};
+
+/**
+ * @brief Library list of a process, read from the loader's r_debug
+ *
+ * r_debug is located once through DT_DEBUG of the main executable, whose
+ * dynamic section is found with libhack_get_exe_layout, so the maps file is
+ * never parsed. Each refresh costs one read per library plus one batched
+ * read of every name.
+ *
+ */
+struct libhack_link_map;
+
+/**
+ * @brief Creates an empty library list bound to a handle
+ *
+ * @param handle Handle to libhack
+ * @return struct libhack_link_map* Library list or NULL on error
+ */
+struct libhack_link_map *libhack_link_map_create(struct libhack_handle *handle);
+
+/**
+ * @brief Reads the library list of the process
+ *
+ * @param lm Library list
+ * @return long LIBHACK_OK on success, EAGAIN if the loader is in the middle
+ * of a dlopen or dlclose, ENOENT if the executable has no DT_DEBUG (static
+ * binaries) or errno value
+ */
+long libhack_link_map_refresh(struct libhack_link_map *lm);
+
+/**
+ * @brief Checks if libraries were loaded or unloaded since the last refresh
+ *
+ * r_debug and the links of every known entry are read in a single batched
+ * read and compared with the ones seen by the last refresh.
+ *
+ * @param lm Library list
+ * @param changed Receives true if the list must be refreshed
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_link_map_changed(struct libhack_link_map *lm, bool *changed);
+
+/**
+ * @brief Gets the number of libraries
+ *
+ * @param lm Library list
+ * @return size_t Number of libraries
+ */
+size_t libhack_link_map_count(const struct libhack_link_map *lm);
+
+/**
+ * @brief Gets a library in load order (the main executable comes first)
+ *
+ * @param lm Library list
+ * @param index Index of the library
+ * @return const struct libhack_link_module* Library or NULL if index is out of range
+ */
+const struct libhack_link_module *libhack_link_map_get(const struct libhack_link_map *lm,
+                                                       size_t index);
+
+/**
+ * @brief Gets the address of the loader's notification function (r_brk)
+ *
+ * The loader calls it before and after every change of the list, so a
+ * breakpoint there reports dlopen and dlclose as they happen.
+ *
+ * @param lm Library list (refreshed at least once)
+ * @return DWORD64 Address of the function or 0 if unknown
+ */
+DWORD64 libhack_link_map_brk(const struct libhack_link_map *lm);
+
+/**
+ * @brief Releases a library list
+ *
+ * @param lm Library list
+ */
+void libhack_link_map_free(struct libhack_link_map *lm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_LINKMAP_H
@@ -0,0 +1,669 @@
+/**
+ * @file maps.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Parsed and indexed memory map of the remote process
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "logger.h"
+#include "maps.h"
+#include "process.h"
+#include "status_codes.h"
+
+/**
+ * @brief Initial size of the buffer used to read the maps text
+ *
+ */
+#define MAPS_INITIAL_BUFFER (64 * 1024)
+
+/**
+ * @brief Reads the whole /proc/<pid>/maps text
+ *
+ * procfs reports a size of 0 for this file, so the buffer grows as needed.
+ *
+ * @param pid Process ID
+ * @param text Receives the text (must be released with free)
+ * @param len Receives the length of the text
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_maps_read_text(pid_t pid, char **text, size_t *len)
+{
+    char maps_path[BUFLEN];
+    size_t capacity = MAPS_INITIAL_BUFFER;
+    size_t used = 0;
+    char *buffer;
+
+    snprintf(maps_path, arraySize(maps_path), "/proc/%d/maps", pid);
+
+    int fd = open(maps_path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        libhack_err("failed to open %s: %d", maps_path, errno);
+        return errno;
+    }
+
+    buffer = (char *)malloc(capacity);
+    if (!buffer)
+    {
+        close(fd);
+        return ENOMEM;
+    }
+
+    for (;;)
+    {
+        if (used == capacity)
+        {
+            char *bigger = (char *)realloc(buffer, capacity * 2);
+            if (!bigger)
+            {
+                free(buffer);
+                close(fd);
+                return ENOMEM;
+            }
+
+            buffer = bigger;
+            capacity *= 2;
+        }
+
+        ssize_t readed = read(fd, buffer + used, capacity - used);
+        if (readed == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            long err = errno;
+            libhack_err("failed to read %s: %d", maps_path, err);
+            free(buffer);
+            close(fd);
+            return err;
+        }
+
+        if (readed == 0)
+            break;
+
+        used += (size_t)readed;
+    }
+
+    close(fd);
+
+    *text = buffer;
+    *len = used;
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief FNV-1a hash of a buffer
+ *
+ * @param data Buffer
+ * @param len Length of buffer
+ * @return uint64_t Hash value
+ */
+static uint64_t libhack_maps_hash(const char *data, size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Pathname pool used while parsing
+ *
+ */
+struct libhack_string_pool
+{
+	char *data;
+	size_t len;
+	size_t capacity;
+	size_t *slots;
+	size_t slot_count;
+	size_t used_slots;
+};
+
+/**
+ * @brief Interns a string into the pool
+ *
+ * @param pool String pool
+ * @param str String (not null terminated)
+ * @param len Length of string
+ * @param offset Receives the offset of the interned string on the pool
+ * @return bool true on success false on allocation failure
+ */
+static bool libhack_pool_intern(struct libhack_string_pool *pool, const char *str,
+                                size_t len, size_t *offset)
+{
+    uint64_t hash = libhack_maps_hash(str, len);
+    size_t mask = pool->slot_count - 1;
+    size_t slot = (size_t)hash & mask;
+
+    // Slots hold offset + 1, so 0 marks an empty slot
+    while (pool->slots[slot] != 0)
+    {
+        const char *candidate = pool->data + pool->slots[slot] - 1;
+
+        if (strncmp(candidate, str, len) == 0 && candidate[len] == '\0')
+        {
+            *offset = pool->slots[slot] - 1;
+            return true;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    if (pool->len + len + 1 > pool->capacity)
+    {
+        size_t capacity = pool->capacity * 2;
+
+        while (pool->len + len + 1 > capacity)
+            capacity *= 2;
+
+        char *data = (char *)realloc(pool->data, capacity);
+        if (!data)
+            return false;
+
+        pool->data = data;
+        pool->capacity = capacity;
+    }
+
+    memcpy(pool->data + pool->len, str, len);
+    pool->data[pool->len + len] = '\0';
+    *offset = pool->len;
+    pool->slots[slot] = pool->len + 1;
+    pool->len += len + 1;
+
+    // Keep the load factor under one half
+    if (++pool->used_slots * 2 > pool->slot_count)
+    {
+        size_t count = pool->slot_count * 2;
+        size_t *slots = (size_t *)calloc(count, sizeof(size_t));
+        if (!slots)
+            return false;
+
+        for (size_t i = 0; i < pool->slot_count; i++)
+        {
+            if (pool->slots[i] == 0)
+                continue;
+
+            const char *s = pool->data + pool->slots[i] - 1;
+            size_t j = (size_t)libhack_maps_hash(s, strlen(s)) & (count - 1);
+
+            while (slots[j] != 0)
+                j = (j + 1) & (count - 1);
+
+            slots[j] = pool->slots[i];
+        }
+
+        free(pool->slots);
+        pool->slots = slots;
+        pool->slot_count = count;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parses a hexadecimal number
+ *
+ * @param p Cursor, advanced past the number
+ * @return DWORD64 Parsed value
+ */
+static DWORD64 libhack_parse_hex(const char **p)
+{
+    DWORD64 value = 0;
+
+    for (;; (*p)++)
+    {
+        char c = **p;
+
+        if (c >= '0' && c <= '9')
+            value = (value << 4) | (DWORD64)(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            value = (value << 4) | (DWORD64)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            value = (value << 4) | (DWORD64)(c - 'A' + 10);
+        else
+            break;
+    }
+
+    return value;
+}
+
+static int libhack_region_compare(const void *a, const void *b)
+{
+    const struct libhack_region *ra = (const struct libhack_region *)a;
+    const struct libhack_region *rb = (const struct libhack_region *)b;
+
+    return (ra->start > rb->start) - (ra->start < rb->start);
+}
+
+/**
+ * @brief Parses the maps text into a region table
+ *
+ * @param text Maps text
+ * @param len Length of text
+ * @param maps Receives the region table
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_maps_parse(const char *text, size_t len,
+                               struct libhack_maps *maps)
+{
+    struct libhack_string_pool pool;
+    size_t *offsets = NULL;
+    size_t capacity = 0;
+    size_t lines = 0;
+    bool sorted = true;
+    const char *p = text;
+    const char *limit = text + len;
+
+    for (size_t i = 0; i < len; i++)
+        lines += text[i] == '\n';
+
+    memset(&pool, 0, sizeof(pool));
+    pool.capacity = BUFLEN * 16;
+    pool.slot_count = 256;
+    pool.data = (char *)malloc(pool.capacity);
+    pool.slots = (size_t *)calloc(pool.slot_count, sizeof(size_t));
+
+    capacity = lines + 1;
+    maps->regions = (struct libhack_region *)calloc(capacity, sizeof(struct libhack_region));
+    offsets = (size_t *)malloc(capacity * sizeof(size_t));
+
+    if (!pool.data || !pool.slots || !maps->regions || !offsets)
+        goto nomem;
+
+    maps->count = 0;
+
+    while (p < limit)
+    {
+        const char *eol = memchr(p, '\n', (size_t)(limit - p));
+        struct libhack_region *region = &maps->regions[maps->count];
+
+        if (!eol)
+            eol = limit;
+
+        region->start = libhack_parse_hex(&p);
+        p++;
+        region->end = libhack_parse_hex(&p);
+        p++;
+
+        for (int i = 0; i < 4 && p < eol; i++)
+            region->perms[i] = *p++;
+
+        region->perms[4] = '\0';
+        p++;
+        region->offset = libhack_parse_hex(&p);
+        p++;
+        region->dev_major = (unsigned int)libhack_parse_hex(&p);
+        p++;
+        region->dev_minor = (unsigned int)libhack_parse_hex(&p);
+        p++;
+
+        region->inode = 0;
+        while (p < eol && *p >= '0' && *p <= '9')
+            region->inode = region->inode * 10 + (unsigned long)(*p++ - '0');
+
+        while (p < eol && *p == ' ')
+            p++;
+
+        if (!libhack_pool_intern(&pool, p, (size_t)(eol - p), &offsets[maps->count]))
+            goto nomem;
+
+        if (maps->count > 0 && region->start < maps->regions[maps->count - 1].start)
+            sorted = false;
+
+        maps->count++;
+        p = eol + 1;
+    }
+
+    // Pool is final now: convert offsets to pointers
+    for (size_t i = 0; i < maps->count; i++)
+        maps->regions[i].pathname = pool.data + offsets[i];
+
+    if (!sorted)
+        qsort(maps->regions, maps->count, sizeof(struct libhack_region),
+              libhack_region_compare);
+
+    maps->strings = pool.data;
+    free(pool.slots);
+    free(offsets);
+
+    return LIBHACK_OK;
+
+nomem:
+    free(pool.data);
+    free(pool.slots);
+    free(offsets);
+    free(maps->regions);
+    maps->regions = NULL;
+    maps->count = 0;
+
+    return ENOMEM;
+}
+
+/**
+ * @brief Gets the file name of a pathname
+ *
+ * @param path Pathname
+ * @return const char* File name
+ */
+static const char *libhack_maps_basename(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+
+    return slash ? slash + 1 : path;
+}
+
+/**
+ * @brief Finds the module slot of a pathname
+ *
+ * Pathnames are interned, so the module of a region is found by comparing
+ * pointers.
+ *
+ * @param maps Region table
+ * @param path Interned pathname
+ * @return size_t* Slot holding the module or the empty slot where it belongs
+ */
+static size_t *libhack_maps_module_slot(struct libhack_maps *maps, const char *path)
+{
+    const char *name = libhack_maps_basename(path);
+    size_t mask = maps->module_slot_count - 1;
+    size_t slot = (size_t)libhack_maps_hash(name, strlen(name)) & mask;
+
+    while (maps->module_slots[slot] != 0 &&
+           maps->modules[maps->module_slots[slot] - 1].path != path)
+        slot = (slot + 1) & mask;
+
+    return &maps->module_slots[slot];
+}
+
+/**
+ * @brief Groups the regions of every mapped file into the module index
+ *
+ * @param maps Region table, sorted
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_maps_index_modules(struct libhack_maps *maps)
+{
+    struct libhack_module *last = NULL;
+
+    maps->module_slot_count = 16;
+    while (maps->module_slot_count < maps->count * 2)
+        maps->module_slot_count *= 2;
+
+    maps->modules = (struct libhack_module *)calloc(maps->count + 1, sizeof(struct libhack_module));
+    maps->module_slots = (size_t *)calloc(maps->module_slot_count, sizeof(size_t));
+    if (!maps->modules || !maps->module_slots)
+        return ENOMEM;
+
+    for (size_t i = 0; i < maps->count; i++)
+    {
+        const struct libhack_region *region = &maps->regions[i];
+        struct libhack_module *module;
+        size_t *slot;
+
+        if (region->inode == 0 || region->pathname[0] != '/')
+        {
+            // Anonymous memory right after the data of a module is its bss
+            if (last && last->end_region == i && last->end == region->start &&
+                region->pathname[0] == '\0' && region->perms[1] == 'w')
+            {
+                last->bss_start = region->start;
+                last->bss_end = region->end;
+                last->end = region->end;
+                last->end_region = i + 1;
+            }
+
+            last = NULL;
+            continue;
+        }
+
+        slot = libhack_maps_module_slot(maps, region->pathname);
+        if (*slot == 0)
+        {
+            module = &maps->modules[maps->module_count++];
+            module->name = libhack_maps_basename(region->pathname);
+            module->path = region->pathname;
+            module->base = region->start;
+            module->first_region = i;
+            *slot = maps->module_count;
+        }
+        else
+        {
+            module = &maps->modules[*slot - 1];
+        }
+
+        module->end = region->end;
+        module->end_region = i + 1;
+
+        if (region->perms[2] == 'x')
+        {
+            if (module->text_start == 0)
+                module->text_start = region->start;
+
+            module->text_end = region->end;
+        }
+        else if (region->perms[1] == 'w')
+        {
+            if (module->data_start == 0)
+                module->data_start = region->start;
+
+            module->data_end = region->end;
+        }
+
+        last = module;
+    }
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Rebuilds the region table of the handle from the maps text
+ *
+ * @param handle Handle to libhack
+ * @param text Maps text
+ * @param len Length of the text
+ * @param hash Hash of the text
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_maps_rebuild(struct libhack_handle *handle, const char *text, size_t len,
+                                 uint64_t hash)
+{
+    struct libhack_maps *maps;
+    long status;
+
+    maps = (struct libhack_maps *)calloc(1, sizeof(struct libhack_maps));
+    if (!maps)
+        return ENOMEM;
+
+    status = libhack_maps_parse(text, len, maps);
+    if (status == LIBHACK_OK)
+        status = libhack_maps_index_modules(maps);
+
+    if (status != LIBHACK_OK)
+    {
+        libhack_maps_free(maps);
+        return status;
+    }
+
+    maps->hash = hash;
+    maps->generation = handle->maps ? handle->maps->generation + 1 : 1;
+
+    libhack_maps_free(handle->maps);
+    handle->maps = maps;
+
+    libhack_debug("parsed %zu regions and %zu modules of process %d", maps->count,
+                  maps->module_count, handle->pid);
+
+    return LIBHACK_OK;
+}
+
+long libhack_maps_refresh(struct libhack_handle *handle)
+{
+    char *text = NULL;
+    size_t len = 0;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, -1);
+
+    if (handle->pid == -1 && libhack_get_process_id(handle) == -1)
+        return ESRCH;
+
+    status = libhack_maps_read_text(handle->pid, &text, &len);
+    if (status != LIBHACK_OK)
+        return status;
+
+    status = libhack_maps_rebuild(handle, text, len, libhack_maps_hash(text, len));
+    free(text);
+
+    return status;
+}
+
+long libhack_maps_update(struct libhack_handle *handle, bool *changed)
+{
+    char *text = NULL;
+    size_t len = 0;
+    uint64_t hash;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, -1);
+
+    if (changed)
+        *changed = false;
+
+    if (handle->pid == -1 && libhack_get_process_id(handle) == -1)
+        return ESRCH;
+
+    status = libhack_maps_read_text(handle->pid, &text, &len);
+    if (status != LIBHACK_OK)
+        return status;
+
+    // The text is read once: parsing is skipped when it did not change
+    hash = libhack_maps_hash(text, len);
+    if (!handle->maps || hash != handle->maps->hash)
+    {
+        status = libhack_maps_rebuild(handle, text, len, hash);
+        if (status == LIBHACK_OK && changed)
+            *changed = true;
+    }
+
+    free(text);
+
+    return status;
+}
+
+const struct libhack_maps *libhack_get_maps(struct libhack_handle *handle)
+{
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, NULL);
+
+    if (!handle->maps && libhack_maps_refresh(handle) != LIBHACK_OK)
+        return NULL;
+
+    return handle->maps;
+}
+
+const struct libhack_region *libhack_maps_find(const struct libhack_maps *maps,
+                                               DWORD64 addr)
+{
+    size_t low = 0;
+    size_t high;
+
+    if (!maps)
+        return NULL;
+
+    high = maps->count;
+
+    // Finds the last region starting at or before addr
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+
+        if (maps->regions[mid].start <= addr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low == 0 || addr >= maps->regions[low - 1].end)
+        return NULL;
+
+    return &maps->regions[low - 1];
+}
+
+const struct libhack_module *libhack_maps_find_module(const struct libhack_maps *maps,
+                                                      const char *name)
+{
+    const char *file;
+    bool full_path;
+    size_t mask;
+    size_t slot;
+
+    if (!maps || !name || maps->module_slot_count == 0)
+        return NULL;
+
+    file = libhack_maps_basename(name);
+    full_path = file != name;
+    mask = maps->module_slot_count - 1;
+    slot = (size_t)libhack_maps_hash(file, strlen(file)) & mask;
+
+    // Modules sharing a file name were inserted in load order
+    for (; maps->module_slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const struct libhack_module *module = &maps->modules[maps->module_slots[slot] - 1];
+
+        if (strcmp(full_path ? module->path : module->name, name) == 0)
+            return module;
+    }
+
+    return NULL;
+}
+
+bool libhack_region_readable(const struct libhack_region *region)
+{
+    if (!region || region->perms[0] != 'r')
+        return false;
+
+    // Kernel provided pages which cannot be read by other processes
+    if (strncmp(region->pathname, "[vvar", 5) == 0 ||
+        strcmp(region->pathname, "[vsyscall]") == 0)
+        return false;
+
+    return true;
+}
+
+void libhack_maps_free(struct libhack_maps *maps)
+{
+    if (!maps)
+        return;
+
+    free(maps->modules);
+    free(maps->module_slots);
+    free(maps->regions);
+    free(maps->strings);
+    free(maps);
+}
+
+#endif // __linux__
@@ -0,0 +1,301 @@
+/**
+ * @file maps.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Parsed and indexed memory map of the remote process
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_MAPS_H
+#define LIBHACK_MAPS_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A single mapping of /proc/<pid>/maps
+ *
+ */
+struct libhack_region
+{
+	/**
+	 * @brief First address of the region
+	 *
+	 */
+	DWORD64 start;
+
+	/**
+	 * @brief Address right after the region
+	 *
+	 */
+	DWORD64 end;
+
+	/**
+	 * @brief Offset into the mapped file
+	 *
+	 */
+	DWORD64 offset;
+
+	/**
+	 * @brief Inode of the mapped file (0 for anonymous regions)
+	 *
+	 */
+	unsigned long inode;
+
+	/**
+	 * @brief Major number of the device holding the mapped file
+	 *
+	 */
+	unsigned int dev_major;
+
+	/**
+	 * @brief Minor number of the device holding the mapped file
+	 *
+	 */
+	unsigned int dev_minor;
+
+	/**
+	 * @brief Permissions ("rwxp" style)
+	 *
+	 */
+	char perms[5];
+
+	/**
+	 * @brief Interned pathname ("" for anonymous regions)
+	 *
+	 */
+	const char *pathname;
+};
+
+/**
+ * @brief A file mapped by the process (executable, shared library or data file)
+ *
+ */
+struct libhack_module
+{
+	/**
+	 * @brief File name (points into the pathname)
+	 *
+	 */
+	const char *name;
+
+	/**
+	 * @brief Full pathname
+	 *
+	 */
+	const char *path;
+
+	/**
+	 * @brief Load address (start of the lowest region)
+	 *
+	 */
+	DWORD64 base;
+
+	/**
+	 * @brief End of the highest region, bss included
+	 *
+	 */
+	DWORD64 end;
+
+	/**
+	 * @brief Start of the executable regions (0 if there are none)
+	 *
+	 */
+	DWORD64 text_start;
+
+	/**
+	 * @brief End of the executable regions
+	 *
+	 */
+	DWORD64 text_end;
+
+	/**
+	 * @brief Start of the writable file-backed regions (0 if there are none)
+	 *
+	 */
+	DWORD64 data_start;
+
+	/**
+	 * @brief End of the writable file-backed regions
+	 *
+	 */
+	DWORD64 data_end;
+
+	/**
+	 * @brief Start of the anonymous region right after the data (0 if there is none)
+	 *
+	 */
+	DWORD64 bss_start;
+
+	/**
+	 * @brief End of the bss region
+	 *
+	 */
+	DWORD64 bss_end;
+
+	/**
+	 * @brief Index of the first region of the module
+	 *
+	 */
+	size_t first_region;
+
+	/**
+	 * @brief Index past the last region of the module
+	 *
+	 */
+	size_t end_region;
+};
+
+/**
+ * @brief Region table of a process, sorted by address
+ *
+ */
+struct libhack_maps
+{
+	/**
+	 * @brief Regions sorted by start address
+	 *
+	 */
+	struct libhack_region *regions;
+
+	/**
+	 * @brief Number of regions
+	 *
+	 */
+	size_t count;
+
+	/**
+	 * @brief Pool holding every distinct pathname once
+	 *
+	 */
+	char *strings;
+
+	/**
+	 * @brief Hash of the raw maps text, used to detect changes
+	 *
+	 */
+	uint64_t hash;
+
+	/**
+	 * @brief Incremented every time the table is rebuilt
+	 *
+	 */
+	unsigned long generation;
+
+	/**
+	 * @brief Modules sorted by load address
+	 *
+	 */
+	struct libhack_module *modules;
+
+	/**
+	 * @brief Number of modules
+	 *
+	 */
+	size_t module_count;
+
+	/**
+	 * @brief Open addressing table of module indexes + 1, hashed by file name
+	 *
+	 */
+	size_t *module_slots;
+
+	/**
+	 * @brief Number of module slots (power of two)
+	 *
+	 */
+	size_t module_slot_count;
+};
+
+/**
+ * @brief Parses /proc/<pid>/maps and rebuilds the region table of the handle
+ *
+ * @param handle Handle to libhack
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_maps_refresh(struct libhack_handle *handle);
+
+/**
+ * @brief Rebuilds the region table of the handle only if the process changed its mappings
+ *
+ * The maps text is read once and hashed; it is only parsed when the hash
+ * differs from the one of the current table, which is otherwise kept as is
+ * (same generation). procfs keeps no change counter for the mappings, so the
+ * kernel still formats every mapping: for a process with thousands of
+ * mappings this costs about half of libhack_maps_refresh. Keep it off
+ * per-access paths.
+ *
+ * @param handle Handle to libhack
+ * @param changed Receives true if the table was rebuilt (may be NULL)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_maps_update(struct libhack_handle *handle, bool *changed);
+
+/**
+ * @brief Gets the region table of the handle, loading it if needed
+ *
+ * @param handle Handle to libhack
+ * @return const struct libhack_maps* Region table or NULL on error
+ */
+const struct libhack_maps *libhack_get_maps(struct libhack_handle *handle);
+
+/**
+ * @brief Finds the region containing an address (binary search)
+ *
+ * @param maps Region table
+ * @param addr Address to be searched
+ * @return const struct libhack_region* Region or NULL if the address is not mapped
+ */
+const struct libhack_region *libhack_maps_find(const struct libhack_maps *maps, DWORD64 addr);
+
+/**
+ * @brief Finds a module by file name ("libc.so.6") or full pathname
+ *
+ * If several files share the same name, the one loaded first is returned.
+ *
+ * @param maps Region table
+ * @param name File name or pathname
+ * @return const struct libhack_module* Module or NULL if it is not loaded
+ */
+const struct libhack_module *libhack_maps_find_module(const struct libhack_maps *maps,
+                                                      const char *name);
+
+/**
+ * @brief Checks if a region can be read by another process
+ *
+ * The region must be readable and must not be one of the kernel provided
+ * mappings ([vvar], [vvar_vclock], [vsyscall]) which process_vm_readv and
+ * /proc/<pid>/mem refuse.
+ *
+ * @param region Region
+ * @return bool true if the region can be read
+ */
+bool libhack_region_readable(const struct libhack_region *region);
+
+/**
+ * @brief Releases a region table
+ *
+ * @param maps Region table
+ */
+void libhack_maps_free(struct libhack_maps *maps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_MAPS_H
@@ -0,0 +1,286 @@
+/**
+ * @file notify.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Exit notifications for many attached processes
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "logger.h"
+#include "notify.h"
+#include "status_codes.h"
+
+/**
+ * @brief Maximum number of events fetched by a single epoll_wait
+ *
+ */
+#define NOTIFIER_MAX_EVENTS 64
+
+/**
+ * @brief A watched handle
+ *
+ */
+struct libhack_notifier_entry
+{
+	/**
+	 * @brief Identifier carried by the epoll events of the entry (never reused)
+	 *
+	 */
+	uint64_t id;
+
+	/**
+	 * @brief Watched handle
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Function called when the process exits
+	 *
+	 */
+	libhack_exit_callback callback;
+
+	/**
+	 * @brief Argument passed to callback
+	 *
+	 */
+	void *userdata;
+};
+
+struct libhack_notifier
+{
+	/**
+	 * @brief epoll descriptor holding every pidfd
+	 *
+	 */
+	int epfd;
+
+	/**
+	 * @brief Watched handles
+	 *
+	 */
+	struct libhack_notifier_entry **entries;
+
+	/**
+	 * @brief Number of watched handles
+	 *
+	 */
+	size_t count;
+
+	/**
+	 * @brief Capacity of entries
+	 *
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief Identifier of the next entry
+	 *
+	 */
+	uint64_t next_id;
+};
+
+struct libhack_notifier *libhack_notifier_create()
+{
+    struct libhack_notifier *notifier;
+
+    notifier = (struct libhack_notifier *)calloc(1, sizeof(struct libhack_notifier));
+    if (!notifier)
+    {
+        libhack_err("failed to allocate memory");
+        return NULL;
+    }
+
+    notifier->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (notifier->epfd == -1)
+    {
+        libhack_err("failed to create epoll descriptor: %d", errno);
+        free(notifier);
+        return NULL;
+    }
+
+    return notifier;
+}
+
+long libhack_notifier_add(struct libhack_notifier *notifier,
+                          struct libhack_handle *handle,
+                          libhack_exit_callback callback, void *userdata)
+{
+    struct libhack_notifier_entry *entry;
+    struct epoll_event event;
+
+    // Sanity checking
+    libhack_assert_or_return(notifier != NULL && handle != NULL, -1);
+
+    if (handle->pidfd == -1)
+    {
+        libhack_err("process %d has no pidfd to be watched", handle->pid);
+        return EBADF;
+    }
+
+    if (notifier->count == notifier->capacity)
+    {
+        size_t capacity = notifier->capacity ? notifier->capacity * 2 : 16;
+        struct libhack_notifier_entry **entries = (struct libhack_notifier_entry **)realloc(
+            notifier->entries, capacity * sizeof(*entries));
+
+        if (!entries)
+            return ENOMEM;
+
+        notifier->entries = entries;
+        notifier->capacity = capacity;
+    }
+
+    entry = (struct libhack_notifier_entry *)malloc(sizeof(struct libhack_notifier_entry));
+    if (!entry)
+        return ENOMEM;
+
+    entry->id = ++notifier->next_id;
+    entry->handle = handle;
+    entry->callback = callback;
+    entry->userdata = userdata;
+
+    // An address could be reused by an entry added after this one is removed
+    event.events = EPOLLIN;
+    event.data.u64 = entry->id;
+
+    if (epoll_ctl(notifier->epfd, EPOLL_CTL_ADD, handle->pidfd, &event) == -1)
+    {
+        long err = errno;
+
+        libhack_err("failed to watch process %d: %d", handle->pid, err);
+        free(entry);
+        return err;
+    }
+
+    notifier->entries[notifier->count++] = entry;
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Unregisters the entry at the specified position
+ *
+ * @param notifier Notifier
+ * @param index Position of entry
+ */
+static void libhack_notifier_drop(struct libhack_notifier *notifier, size_t index)
+{
+    struct libhack_notifier_entry *entry = notifier->entries[index];
+
+    epoll_ctl(notifier->epfd, EPOLL_CTL_DEL, entry->handle->pidfd, NULL);
+    free(entry);
+
+    notifier->entries[index] = notifier->entries[--notifier->count];
+}
+
+long libhack_notifier_remove(struct libhack_notifier *notifier,
+                             struct libhack_handle *handle)
+{
+    // Sanity checking
+    libhack_assert_or_return(notifier != NULL && handle != NULL, -1);
+
+    for (size_t i = 0; i < notifier->count; i++)
+    {
+        if (notifier->entries[i]->handle == handle)
+        {
+            libhack_notifier_drop(notifier, i);
+            return LIBHACK_OK;
+        }
+    }
+
+    return ENOENT;
+}
+
+int libhack_notifier_get_fd(const struct libhack_notifier *notifier)
+{
+    libhack_assert_or_return(notifier != NULL, -1);
+
+    return notifier->epfd;
+}
+
+int libhack_notifier_dispatch(struct libhack_notifier *notifier, int timeout_ms)
+{
+    struct epoll_event events[NOTIFIER_MAX_EVENTS];
+    int ready;
+    int dispatched = 0;
+
+    // Sanity checking
+    libhack_assert_or_return(notifier != NULL, -1);
+
+    do
+    {
+        ready = epoll_wait(notifier->epfd, events, NOTIFIER_MAX_EVENTS, timeout_ms);
+    } while (ready == -1 && errno == EINTR);
+
+    if (ready == -1)
+    {
+        libhack_err("failed to wait for process exits: %d", errno);
+        return -1;
+    }
+
+    for (int i = 0; i < ready; i++)
+    {
+        struct libhack_notifier_entry *entry;
+        size_t index = 0;
+
+        // An earlier callback may have removed this entry already
+        while (index < notifier->count && notifier->entries[index]->id != events[i].data.u64)
+            index++;
+
+        if (index == notifier->count)
+            continue;
+
+        entry = notifier->entries[index];
+
+        struct libhack_handle *handle = entry->handle;
+        libhack_exit_callback callback = entry->callback;
+        void *userdata = entry->userdata;
+
+        // A pidfd stays readable forever, so the entry is dropped first
+        libhack_notifier_drop(notifier, index);
+
+        libhack_debug("process %d has exited", handle->pid);
+
+        if (callback)
+            callback(handle, userdata);
+
+        dispatched++;
+    }
+
+    return dispatched;
+}
+
+size_t libhack_notifier_count(const struct libhack_notifier *notifier)
+{
+    return notifier ? notifier->count : 0;
+}
+
+void libhack_notifier_free(struct libhack_notifier *notifier)
+{
+    if (!notifier)
+        return;
+
+    for (size_t i = 0; i < notifier->count; i++)
+        free(notifier->entries[i]);
+
+    close(notifier->epfd);
+    free(notifier->entries);
+    free(notifier);
+}
+
+#endif // __linux__
@@ -0,0 +1,111 @@
+/**
+ * @file notify.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Exit notifications for many attached processes
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_NOTIFY_H
+#define LIBHACK_NOTIFY_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include "init.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Function called when a watched process exits
+ *
+ */
+typedef void (*libhack_exit_callback)(struct libhack_handle *handle, void *userdata);
+
+/**
+ * @brief Set of handles watched through a single epoll descriptor
+ *
+ */
+struct libhack_notifier;
+
+/**
+ * @brief Creates an exit notifier
+ *
+ * @return struct libhack_notifier* Notifier or NULL on error
+ */
+struct libhack_notifier *libhack_notifier_create();
+
+/**
+ * @brief Starts watching a handle
+ *
+ * The handle must be attached (see libhack_attach_pid) and must stay valid
+ * while it is registered.
+ *
+ * @param notifier Notifier
+ * @param handle Handle to libhack
+ * @param callback Function called once the process exits (may be NULL)
+ * @param userdata Argument passed to callback
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_notifier_add(struct libhack_notifier *notifier, struct libhack_handle *handle,
+						  libhack_exit_callback callback, void *userdata);
+
+/**
+ * @brief Stops watching a handle
+ *
+ * @param notifier Notifier
+ * @param handle Handle to libhack
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_notifier_remove(struct libhack_notifier *notifier, struct libhack_handle *handle);
+
+/**
+ * @brief Gets the descriptor which becomes readable when a process exits
+ *
+ * It may be added to the caller's own event loop, which then calls
+ * libhack_notifier_dispatch with a zero timeout.
+ *
+ * @param notifier Notifier
+ * @return int epoll descriptor
+ */
+int libhack_notifier_get_fd(const struct libhack_notifier *notifier);
+
+/**
+ * @brief Waits for exits and runs the callbacks of the exited processes
+ *
+ * Handles are unregistered once their callback has run.
+ *
+ * @param notifier Notifier
+ * @param timeout_ms Time to wait in milliseconds (-1 waits forever, 0 does not block)
+ * @return int Number of exits dispatched or -1 on error
+ */
+int libhack_notifier_dispatch(struct libhack_notifier *notifier, int timeout_ms);
+
+/**
+ * @brief Gets the number of handles being watched
+ *
+ * @param notifier Notifier
+ * @return size_t Number of handles
+ */
+size_t libhack_notifier_count(const struct libhack_notifier *notifier);
+
+/**
+ * @brief Releases the notifier (registered handles are not freed)
+ *
+ * @param notifier Notifier
+ */
+void libhack_notifier_free(struct libhack_notifier *notifier);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_NOTIFY_H
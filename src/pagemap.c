@@ -0,0 +1,218 @@
+/**
+ * @file pagemap.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Page state of the remote process through /proc/<pid>/pagemap
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "logger.h"
+#include "pagemap.h"
+#include "status_codes.h"
+
+long libhack_pagemap_read(struct libhack_handle *handle, DWORD64 addr, size_t count, uint64_t *entries)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    off_t offset = (off_t)(addr / page * sizeof(uint64_t));
+    size_t len = count * sizeof(uint64_t);
+    size_t done = 0;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && entries != NULL, -1);
+
+    if (handle->pid == -1)
+        return ESRCH;
+
+    if (handle->pagemap_fd == -1)
+    {
+        char path[BUFLEN];
+
+        snprintf(path, arraySize(path), "/proc/%d/pagemap", handle->pid);
+
+        handle->pagemap_fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (handle->pagemap_fd == -1)
+        {
+            libhack_debug("failed to open %s: %d", path, errno);
+            return errno;
+        }
+    }
+
+    while (done < len)
+    {
+        ssize_t n = pread(handle->pagemap_fd, (char *)entries + done, len - done, offset + (off_t)done);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n <= 0)
+            return n == 0 ? EFAULT : errno;
+
+        done += (size_t)n;
+    }
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Finds the page frame number of the zero page through our own pagemap
+ *
+ * @return uint64_t Page frame number or 0 if it is not visible
+ */
+static uint64_t libhack_pagemap_zero_pfn(void)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uint64_t entry = 0;
+    volatile unsigned char *probe;
+    int fd;
+
+    probe = (volatile unsigned char *)mmap(NULL, page, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (probe == MAP_FAILED)
+        return 0;
+
+    // A read fault on fresh anonymous memory maps the zero page
+    (void)probe[0];
+
+    fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (fd != -1)
+    {
+        if (pread(fd, &entry, sizeof(entry), (off_t)((uintptr_t)probe / page * sizeof(entry))) !=
+            sizeof(entry))
+            entry = 0;
+
+        close(fd);
+    }
+
+    munmap((void *)probe, page);
+
+    return (entry & LIBHACK_PAGEMAP_PRESENT) ? entry & LIBHACK_PAGEMAP_PFN_MASK : 0;
+}
+
+bool libhack_pagemap_is_zero_page(uint64_t entry)
+{
+    static uint64_t zero_pfn = (uint64_t)-1;
+    uint64_t pfn = __atomic_load_n(&zero_pfn, __ATOMIC_RELAXED);
+
+    if (pfn == (uint64_t)-1)
+    {
+        pfn = libhack_pagemap_zero_pfn();
+        __atomic_store_n(&zero_pfn, pfn, __ATOMIC_RELAXED);
+    }
+
+    return pfn != 0 && (entry & LIBHACK_PAGEMAP_PRESENT) &&
+           (entry & LIBHACK_PAGEMAP_PFN_MASK) == pfn;
+}
+
+/**
+ * @brief Checks on our own memory if written pages report the soft-dirty bit
+ *
+ * @return bool true if the bit is reported
+ */
+static bool libhack_pagemap_probe_soft_dirty(void)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uint64_t entry = 0;
+    volatile unsigned char *probe;
+    int fd;
+
+    probe = (volatile unsigned char *)mmap(NULL, page, PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (probe == MAP_FAILED)
+        return false;
+
+    // New mappings and written pages are soft-dirty on kernels tracking it
+    probe[0] = 1;
+
+    fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (fd != -1)
+    {
+        if (pread(fd, &entry, sizeof(entry), (off_t)((uintptr_t)probe / page * sizeof(entry))) !=
+            sizeof(entry))
+            entry = 0;
+
+        close(fd);
+    }
+
+    munmap((void *)probe, page);
+
+    return (entry & LIBHACK_PAGEMAP_SOFT_DIRTY) != 0;
+}
+
+bool libhack_pagemap_soft_dirty_supported(void)
+{
+    static int supported = -1;
+    int value = __atomic_load_n(&supported, __ATOMIC_RELAXED);
+
+    if (value == -1)
+    {
+        value = libhack_pagemap_probe_soft_dirty();
+        __atomic_store_n(&supported, value, __ATOMIC_RELAXED);
+    }
+
+    return value != 0;
+}
+
+long libhack_pagemap_clear_soft_dirty(struct libhack_handle *handle)
+{
+    char path[BUFLEN];
+    ssize_t written;
+    int fd;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, -1);
+
+    if (handle->pid == -1)
+        return ESRCH;
+
+    snprintf(path, arraySize(path), "/proc/%d/clear_refs", handle->pid);
+
+    fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        libhack_debug("failed to open %s: %d", path, errno);
+        return errno;
+    }
+
+    // "4" clears the soft-dirty bits only
+    do
+    {
+        written = write(fd, "4", 1);
+    } while (written == -1 && errno == EINTR);
+
+    if (written != 1)
+    {
+        long status = errno;
+
+        close(fd);
+        return status;
+    }
+
+    close(fd);
+
+    return LIBHACK_OK;
+}
+
+void libhack_pagemap_close(struct libhack_handle *handle)
+{
+    if (!handle || handle->pagemap_fd == -1)
+        return;
+
+    close(handle->pagemap_fd);
+    handle->pagemap_fd = -1;
+}
+
+#endif // __linux__
@@ -0,0 +1,127 @@
+/**
+ * @file pagemap.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Page state of the remote process through /proc/<pid>/pagemap
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_PAGEMAP_H
+#define LIBHACK_PAGEMAP_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Page is present in RAM
+ *
+ */
+#define LIBHACK_PAGEMAP_PRESENT (1ULL << 63)
+
+/**
+ * @brief Page is swapped out
+ *
+ */
+#define LIBHACK_PAGEMAP_SWAPPED (1ULL << 62)
+
+/**
+ * @brief Page is a file page or shared anonymous page
+ *
+ */
+#define LIBHACK_PAGEMAP_FILE_SHARED (1ULL << 61)
+
+/**
+ * @brief Page is mapped only by this process
+ *
+ */
+#define LIBHACK_PAGEMAP_EXCLUSIVE (1ULL << 56)
+
+/**
+ * @brief Page was written since the soft-dirty bits were last cleared
+ *
+ */
+#define LIBHACK_PAGEMAP_SOFT_DIRTY (1ULL << 55)
+
+/**
+ * @brief Page frame number bits (zero unless the caller has CAP_SYS_ADMIN)
+ *
+ */
+#define LIBHACK_PAGEMAP_PFN_MASK ((1ULL << 55) - 1)
+
+/**
+ * @brief Pagemap entries read at once by callers walking whole regions
+ *
+ */
+#define LIBHACK_PAGEMAP_BATCH 4096
+
+/**
+ * @brief Reads the pagemap entries of consecutive pages
+ *
+ * The descriptor of /proc/<pid>/pagemap is opened on first use and kept in
+ * the handle.
+ *
+ * @param handle Handle to libhack
+ * @param addr Address inside the first page
+ * @param count Number of pages
+ * @param entries Receives one entry per page (LIBHACK_PAGEMAP_* flags)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_pagemap_read(struct libhack_handle *handle, DWORD64 addr, size_t count, uint64_t *entries);
+
+/**
+ * @brief Checks if a present page maps the shared zero page
+ *
+ * Reading a page that was never written maps the zero page, which then shows
+ * up as present. It can only be told apart when page frame numbers are
+ * visible.
+ *
+ * @param entry Pagemap entry
+ * @return bool true if the page was never written
+ */
+bool libhack_pagemap_is_zero_page(uint64_t entry);
+
+/**
+ * @brief Checks if the kernel tracks soft-dirty bits
+ *
+ * @return bool true if LIBHACK_PAGEMAP_SOFT_DIRTY is reported
+ */
+bool libhack_pagemap_soft_dirty_supported(void);
+
+/**
+ * @brief Clears the soft-dirty bits of every page of the process
+ *
+ * Pages written after this call report LIBHACK_PAGEMAP_SOFT_DIRTY again.
+ *
+ * @param handle Handle to libhack
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_pagemap_clear_soft_dirty(struct libhack_handle *handle);
+
+/**
+ * @brief Closes the pagemap descriptor of a handle
+ *
+ * @param handle Handle to libhack
+ */
+void libhack_pagemap_close(struct libhack_handle *handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_PAGEMAP_H
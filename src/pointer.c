@@ -0,0 +1,430 @@
+/**
+ * @file pointer.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Multi-level pointer path resolution
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "logger.h"
+#include "maps.h"
+#include "pointer.h"
+#include "process.h"
+#include "status_codes.h"
+
+/**
+ * @brief Initial number of slots of the pointer cache
+ *
+ */
+#define POINTER_CACHE_INITIAL_SLOTS 1024
+
+/**
+ * @brief A cached pointer value
+ *
+ */
+struct libhack_pointer_slot
+{
+	/**
+	 * @brief Address holding the pointer (0 marks an empty slot)
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Pointer value read from addr
+	 *
+	 */
+	DWORD64 value;
+
+	/**
+	 * @brief Generation in which the value was read
+	 *
+	 */
+	unsigned long generation;
+};
+
+struct libhack_pointer_resolver
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Open addressing table of cached pointers
+	 *
+	 */
+	struct libhack_pointer_slot *slots;
+
+	/**
+	 * @brief Number of slots (power of two)
+	 *
+	 */
+	size_t slot_count;
+
+	/**
+	 * @brief Number of occupied slots, including stale ones
+	 *
+	 */
+	size_t used;
+
+	/**
+	 * @brief Current generation
+	 *
+	 */
+	unsigned long generation;
+};
+
+static size_t libhack_pointer_hash(DWORD64 addr)
+{
+    addr ^= addr >> 33;
+    addr *= 0xff51afd7ed558ccdULL;
+    addr ^= addr >> 33;
+
+    return (size_t)addr;
+}
+
+static bool libhack_pointer_cache_get(const struct libhack_pointer_resolver *resolver,
+                                      DWORD64 addr, DWORD64 *value)
+{
+    size_t mask = resolver->slot_count - 1;
+    size_t i = libhack_pointer_hash(addr) & mask;
+
+    while (resolver->slots[i].addr != 0)
+    {
+        if (resolver->slots[i].addr == addr)
+        {
+            if (resolver->slots[i].generation != resolver->generation)
+                return false;
+
+            *value = resolver->slots[i].value;
+            return true;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Rebuilds the cache keeping only entries of the current generation
+ *
+ * @param resolver Pointer resolver
+ * @return bool true on success false on allocation failure
+ */
+static bool libhack_pointer_cache_rehash(struct libhack_pointer_resolver *resolver)
+{
+    size_t live = 0;
+    size_t count = resolver->slot_count;
+
+    for (size_t i = 0; i < resolver->slot_count; i++)
+        live += resolver->slots[i].addr != 0 &&
+                resolver->slots[i].generation == resolver->generation;
+
+    // Grow only if current entries fill more than a quarter of the table
+    if (live * 4 > count)
+        count *= 2;
+
+    struct libhack_pointer_slot *slots =
+        (struct libhack_pointer_slot *)calloc(count, sizeof(struct libhack_pointer_slot));
+    if (!slots)
+        return false;
+
+    for (size_t i = 0; i < resolver->slot_count; i++)
+    {
+        const struct libhack_pointer_slot *slot = &resolver->slots[i];
+
+        if (slot->addr == 0 || slot->generation != resolver->generation)
+            continue;
+
+        size_t j = libhack_pointer_hash(slot->addr) & (count - 1);
+        while (slots[j].addr != 0)
+            j = (j + 1) & (count - 1);
+
+        slots[j] = *slot;
+    }
+
+    free(resolver->slots);
+    resolver->slots = slots;
+    resolver->slot_count = count;
+    resolver->used = live;
+
+    return true;
+}
+
+static void libhack_pointer_cache_put(struct libhack_pointer_resolver *resolver,
+                                      DWORD64 addr, DWORD64 value)
+{
+    if ((resolver->used + 1) * 2 > resolver->slot_count &&
+        !libhack_pointer_cache_rehash(resolver))
+        return;
+
+    size_t mask = resolver->slot_count - 1;
+    size_t i = libhack_pointer_hash(addr) & mask;
+
+    while (resolver->slots[i].addr != 0 && resolver->slots[i].addr != addr)
+        i = (i + 1) & mask;
+
+    if (resolver->slots[i].addr == 0)
+        resolver->used++;
+
+    resolver->slots[i].addr = addr;
+    resolver->slots[i].value = value;
+    resolver->slots[i].generation = resolver->generation;
+}
+
+/**
+ * @brief Gets the load address of a module
+ *
+ * @param resolver Pointer resolver
+ * @param name Module name (NULL for the main executable)
+ * @param base Receives the load address
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_pointer_module_base(struct libhack_pointer_resolver *resolver,
+                                        const char *name, DWORD64 *base)
+{
+    const struct libhack_maps *maps;
+    const struct libhack_module *module;
+
+    if (name == NULL)
+    {
+        long addr = libhack_get_base_addr(resolver->handle);
+        if (addr <= 0)
+            return ENOENT;
+
+        *base = (DWORD64)addr;
+        return LIBHACK_OK;
+    }
+
+    maps = libhack_get_maps(resolver->handle);
+    if (!maps)
+        return ESRCH;
+
+    module = libhack_maps_find_module(maps, name);
+    if (!module)
+    {
+        libhack_err("module %s is not loaded", name);
+        return ENOENT;
+    }
+
+    *base = module->base;
+
+    return LIBHACK_OK;
+}
+
+static int libhack_addr_compare(const void *a, const void *b)
+{
+    DWORD64 x = *(const DWORD64 *)a;
+    DWORD64 y = *(const DWORD64 *)b;
+
+    return (x > y) - (x < y);
+}
+
+struct libhack_pointer_resolver *libhack_pointer_resolver_create(struct libhack_handle *handle)
+{
+    struct libhack_pointer_resolver *resolver;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, NULL);
+
+    resolver = (struct libhack_pointer_resolver *)calloc(1, sizeof(struct libhack_pointer_resolver));
+    if (!resolver)
+        return NULL;
+
+    resolver->slot_count = POINTER_CACHE_INITIAL_SLOTS;
+    resolver->slots = (struct libhack_pointer_slot *)calloc(resolver->slot_count,
+                                                            sizeof(struct libhack_pointer_slot));
+    if (!resolver->slots)
+    {
+        free(resolver);
+        return NULL;
+    }
+
+    resolver->handle = handle;
+    resolver->generation = 1;
+
+    return resolver;
+}
+
+long libhack_pointer_resolve(struct libhack_pointer_resolver *resolver,
+                             const struct libhack_pointer_path *paths,
+                             size_t count, DWORD64 *results, long *status)
+{
+    DWORD64 *pending = NULL;
+    DWORD64 *values = NULL;
+    long *read_status = NULL;
+    long *path_status = status;
+    struct libhack_mem_desc *descs = NULL;
+    size_t depth = 0;
+    long result = LIBHACK_OK;
+
+    // Sanity checking
+    libhack_assert_or_return(resolver != NULL && (count == 0 || (paths != NULL && results != NULL)), -1);
+
+    if (count == 0)
+        return LIBHACK_OK;
+
+    if (!path_status)
+        path_status = (long *)malloc(count * sizeof(long));
+
+    pending = (DWORD64 *)malloc(count * sizeof(DWORD64));
+    values = (DWORD64 *)malloc(count * sizeof(DWORD64));
+    read_status = (long *)malloc(count * sizeof(long));
+    descs = (struct libhack_mem_desc *)malloc(count * sizeof(struct libhack_mem_desc));
+
+    if (!path_status || !pending || !values || !read_status || !descs)
+    {
+        result = ENOMEM;
+        goto cleanup;
+    }
+
+    // Level 0: module base plus base offset
+    for (size_t i = 0; i < count; i++)
+    {
+        DWORD64 base = 0;
+
+        path_status[i] = libhack_pointer_module_base(resolver, paths[i].module, &base);
+        results[i] = base + paths[i].base_offset;
+
+        if (paths[i].offset_count > depth)
+            depth = paths[i].offset_count;
+    }
+
+    for (size_t level = 0; level < depth; level++)
+    {
+        size_t misses = 0;
+        DWORD64 value;
+
+        // Collect the pointers of this depth which are not cached yet
+        for (size_t i = 0; i < count; i++)
+        {
+            if (path_status[i] != LIBHACK_OK || level >= paths[i].offset_count)
+                continue;
+
+            if (results[i] == 0)
+                path_status[i] = EFAULT;
+            else if (!libhack_pointer_cache_get(resolver, results[i], &value))
+                pending[misses++] = results[i];
+        }
+
+        // Paths sharing a prefix point to the same addresses: read them once
+        qsort(pending, misses, sizeof(DWORD64), libhack_addr_compare);
+
+        size_t unique = 0;
+        for (size_t i = 0; i < misses; i++)
+        {
+            if (unique == 0 || pending[unique - 1] != pending[i])
+                pending[unique++] = pending[i];
+        }
+
+        for (size_t i = 0; i < unique; i++)
+        {
+            descs[i].addr = pending[i];
+            descs[i].buffer = &values[i];
+            descs[i].len = sizeof(DWORD64);
+        }
+
+        if (unique > 0)
+        {
+            long err = libhack_read_batch(resolver->handle, descs, unique, read_status);
+            if (err == ESRCH || err == EPERM || err == ENOMEM)
+            {
+                result = err;
+                goto cleanup;
+            }
+
+            for (size_t i = 0; i < unique; i++)
+            {
+                if (read_status[i] == LIBHACK_OK)
+                    libhack_pointer_cache_put(resolver, pending[i], values[i]);
+            }
+        }
+
+        // Follow one level on every path
+        for (size_t i = 0; i < count; i++)
+        {
+            if (path_status[i] != LIBHACK_OK || level >= paths[i].offset_count)
+                continue;
+
+            if (libhack_pointer_cache_get(resolver, results[i], &value))
+            {
+                results[i] = value + (DWORD64)paths[i].offsets[level];
+                continue;
+            }
+
+            // The cache may be full, so fall back to the values just read
+            const DWORD64 *found = (const DWORD64 *)bsearch(&results[i], pending, unique,
+                                                            sizeof(DWORD64), libhack_addr_compare);
+            if (!found)
+            {
+                path_status[i] = EFAULT;
+            }
+            else if (read_status[found - pending] != LIBHACK_OK)
+            {
+                path_status[i] = read_status[found - pending];
+            }
+            else
+            {
+                results[i] = values[found - pending] + (DWORD64)paths[i].offsets[level];
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (path_status[i] != LIBHACK_OK)
+        {
+            result = path_status[i];
+            break;
+        }
+    }
+
+cleanup:
+    if (path_status != status)
+        free(path_status);
+
+    free(pending);
+    free(values);
+    free(read_status);
+    free(descs);
+
+    return result;
+}
+
+void libhack_pointer_resolver_invalidate(struct libhack_pointer_resolver *resolver)
+{
+    if (resolver)
+        resolver->generation++;
+}
+
+unsigned long libhack_pointer_resolver_generation(const struct libhack_pointer_resolver *resolver)
+{
+    return resolver ? resolver->generation : 0;
+}
+
+void libhack_pointer_resolver_free(struct libhack_pointer_resolver *resolver)
+{
+    if (!resolver)
+        return;
+
+    free(resolver->slots);
+    free(resolver);
+}
+
+#endif // __linux__
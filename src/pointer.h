@@ -0,0 +1,118 @@
+/**
+ * @file pointer.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Multi-level pointer path resolution
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_POINTER_H
+#define LIBHACK_POINTER_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A pointer path: [[[module + base_offset] + offsets[0]] + ...] + offsets[n - 1]
+ *
+ */
+struct libhack_pointer_path
+{
+	/**
+	 * @brief Name of the module holding the base pointer (NULL for the main executable)
+	 *
+	 */
+	const char *module;
+
+	/**
+	 * @brief Offset of the base pointer from the module load address
+	 *
+	 */
+	DWORD64 base_offset;
+
+	/**
+	 * @brief Offsets added after each dereference
+	 *
+	 */
+	const int64_t *offsets;
+
+	/**
+	 * @brief Number of offsets (one dereference per offset)
+	 *
+	 */
+	size_t offset_count;
+};
+
+/**
+ * @brief Resolves many pointer paths level by level
+ *
+ */
+struct libhack_pointer_resolver;
+
+/**
+ * @brief Creates a pointer resolver bound to a handle
+ *
+ * @param handle Handle to libhack
+ * @return struct libhack_pointer_resolver* Resolver or NULL on error
+ */
+struct libhack_pointer_resolver *libhack_pointer_resolver_create(struct libhack_handle *handle);
+
+/**
+ * @brief Resolves pointer paths to their final address
+ *
+ * Every dereference of the same depth is sent as one batched read. Paths
+ * sharing a prefix share the reads of that prefix, and intermediate pointers
+ * are cached until libhack_pointer_resolver_invalidate is called.
+ *
+ * @param resolver Pointer resolver
+ * @param paths Paths to be resolved
+ * @param count Number of paths
+ * @param results Receives the final address of each path
+ * @param status Receives LIBHACK_OK or an errno value for each path (may be NULL)
+ * @return long LIBHACK_OK if every path was resolved, the first error code otherwise
+ */
+long libhack_pointer_resolve(struct libhack_pointer_resolver *resolver,
+							 const struct libhack_pointer_path *paths, size_t count,
+							 DWORD64 *results, long *status);
+
+/**
+ * @brief Drops every cached pointer by starting a new generation
+ *
+ * @param resolver Pointer resolver
+ */
+void libhack_pointer_resolver_invalidate(struct libhack_pointer_resolver *resolver);
+
+/**
+ * @brief Gets the current cache generation
+ *
+ * @param resolver Pointer resolver
+ * @return unsigned long Generation counter
+ */
+unsigned long libhack_pointer_resolver_generation(const struct libhack_pointer_resolver *resolver);
+
+/**
+ * @brief Releases a pointer resolver
+ *
+ * @param resolver Pointer resolver
+ */
+void libhack_pointer_resolver_free(struct libhack_pointer_resolver *resolver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_POINTER_H
@@ -28,14 +28,28 @@
 #define _GNU_SOURCE
 #define __USE_GNU
 #define __USE_POSIX
+#include <dirent.h>
 #include <dlfcn.h>
+#include <elf.h>
 #include <errno.h>
 #include <fcntl.h>
-#include <proc/readproc.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+#ifndef IOV_MAX
+#define IOV_MAX UIO_MAXIOV
+#endif
 
 #endif
 
@@ -48,6 +62,13 @@
 #include "logger.h"
 #include "process.h"
 
+#ifdef __linux__
+#include "backend.h"
+#include "maps.h"
+#include "pagemap.h"
+#include "procfs.h"
+#endif
+
 #undef UNICODE
 
 /**
@@ -885,48 +906,100 @@ bool libhack_is64bit_process(struct libhack_handle *handle, DWORD *error)
 
 pid_t libhack_get_process_id(struct libhack_handle *handle)
 {
-    PROCTAB *proc = NULL;
-    proc_t proc_info;
-
     // Sanity check
     libhack_assert_or_return(handle != NULL, -1);
 
     if (handle->pid == -1)
     {
-        proc = openproc(PROC_FILLMEM | PROC_FILLSTAT | PROC_FILLSTATUS);
+        pid_t pid = libhack_find_process(handle->process_name, LIBHACK_MATCH_COMM);
+        long status;
 
-        if (!proc)
+        if (pid == -1)
         {
-            libhack_err("Failed to list processes: %d", errno);
+            libhack_err("process %s was not found", handle->process_name);
             return -1;
         }
 
-        // Allocates memory
-        memset(&proc_info, 0, sizeof(proc_info));
-
-        // Iterates through process list
-        libhack_notice("reading process list ...");
+        libhack_notice("pid of %s: %d", handle->process_name, pid);
 
-        while (readproc(proc, &proc_info) != NULL)
+        status = libhack_attach_pid(handle, pid);
+        if (status != LIBHACK_OK)
         {
-            if (strncmp(proc_info.cmd, handle->process_name, strlen(proc_info.cmd)) ==
-                0)
-            {
-                handle->pid = proc_info.tid;
-                libhack_notice("pid of %s: %hi", proc_info.cmd, handle->pid);
-                libhack_debug("start code, end code, start stack: %#lx, %#lx, %#lx",
-                              proc_info.start_code, proc_info.end_code,
-                              proc_info.start_stack);
-                break;
-            }
+            libhack_err("failed to attach to %s (%d): %ld", handle->process_name, pid, status);
+            return -1;
         }
+    }
+
+    return handle->pid;
+}
+
+long libhack_attach_pid(struct libhack_handle *handle, pid_t pid)
+{
+    long status;
 
-        libhack_notice("cleaning up resources");
+    // Sanity check
+    libhack_assert_or_return(handle != NULL && pid > 0, -1);
 
-        closeproc(proc);
+    if (handle->pidfd != -1)
+    {
+        close(handle->pidfd);
+        handle->pidfd = -1;
     }
 
-    return handle->pid;
+    // Nothing opened or cached for the previous process may be reused
+    libhack_backend_detach(handle);
+    libhack_pagemap_close(handle);
+    libhack_maps_free(handle->maps);
+    handle->maps = NULL;
+    handle->pid = pid;
+    handle->base_addr = -1;
+
+    // The pidfd keeps referring to this process even if the PID is reused
+    handle->pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+    if (handle->pidfd == -1)
+    {
+        libhack_debug("pidfd_open is not available for %d: %d", pid, errno);
+    }
+
+    status = libhack_backend_attach(handle);
+    if (status != LIBHACK_OK)
+    {
+        // Leave the handle detached rather than half attached
+        libhack_backend_detach(handle);
+        if (handle->pidfd != -1)
+        {
+            close(handle->pidfd);
+            handle->pidfd = -1;
+        }
+
+        handle->pid = -1;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Checks if the target process has exited
+ *
+ * A pidfd becomes readable once the process terminates, so a zero timeout
+ * poll tells if it is still alive without blocking.
+ *
+ * @param handle Handle to libhack
+ * @return true If the process is known to have exited
+ * @return false If the process is alive or no pidfd is available
+ */
+static bool libhack_target_exited(const struct libhack_handle *handle)
+{
+    struct pollfd pfd;
+
+    if (handle->pidfd == -1)
+        return false;
+
+    pfd.fd = handle->pidfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    return poll(&pfd, 1, 0) == 1;
 }
 
 long libhack_read_int_from_addr(const struct libhack_handle *handle, DWORD addr,
@@ -935,99 +1008,127 @@ long libhack_read_int_from_addr(const struct libhack_handle *handle, DWORD addr,
     return libhack_read_int_from_addr64(handle, (DWORD64)addr, value);
 }
 
-long libhack_get_base_addr(struct libhack_handle *handle)
+long libhack_get_exe_layout(struct libhack_handle *handle, struct libhack_exe_layout *layout)
 {
-    pid_t pid;
-    char maps_path[BUFLEN];
-    char *line;
-    char *file_content;
-    size_t line_len = 1024;
-    struct stat st;
+    DWORD64 auxv[LIBHACK_AUXV_ENTRIES];
+    DWORD64 min_vaddr = (DWORD64)-1;
+    DWORD64 page = (DWORD64)sysconf(_SC_PAGESIZE);
+    Elf64_Phdr *phdrs;
+    bool has_phdr = false;
+    long status;
 
-    // Santity checking
-    libhack_assert_or_return(handle != NULL, -1);
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && layout != NULL, -1);
 
-    // Get process ID
     if (handle->pid == -1)
+        return ESRCH;
+
+    status = libhack_read_auxv(handle->pid, auxv, LIBHACK_AUXV_ENTRIES);
+    if (status != LIBHACK_OK)
+        return status;
+
+    if (auxv[AT_PHDR] == 0 || auxv[AT_PHNUM] == 0 || auxv[AT_PHENT] != sizeof(Elf64_Phdr))
+        return ENOEXEC;
+
+    phdrs = (Elf64_Phdr *)malloc(auxv[AT_PHNUM] * sizeof(Elf64_Phdr));
+    if (!phdrs)
+        return ENOMEM;
+
+    status = libhack_read_bytes(handle, auxv[AT_PHDR], phdrs, auxv[AT_PHNUM] * sizeof(Elf64_Phdr), NULL);
+    if (status != LIBHACK_OK)
     {
-        pid = libhack_get_process_id(handle);
+        free(phdrs);
+        return status == EFAULT ? EIO : status;
     }
-    else
+
+    memset(layout, 0, sizeof(*layout));
+    layout->entry = auxv[AT_ENTRY];
+    layout->phdr = auxv[AT_PHDR];
+    layout->phnum = (size_t)auxv[AT_PHNUM];
+    layout->interp_base = auxv[AT_BASE];
+
+    // PT_PHDR gives the virtual address the program headers were linked at
+    for (size_t i = 0; i < layout->phnum; i++)
     {
-        pid = handle->pid;
+        if (phdrs[i].p_type == PT_PHDR)
+        {
+            layout->bias = auxv[AT_PHDR] - phdrs[i].p_vaddr;
+            has_phdr = true;
+            break;
+        }
     }
 
-    // check if we already have a base address
-    if (handle->base_addr > 0)
+    for (size_t i = 0; i < layout->phnum && has_phdr; i++)
     {
-        return handle->base_addr;
+        if (phdrs[i].p_type == PT_LOAD && phdrs[i].p_vaddr - phdrs[i].p_offset < min_vaddr)
+            min_vaddr = phdrs[i].p_vaddr - phdrs[i].p_offset;
+
+        if (phdrs[i].p_type == PT_DYNAMIC)
+        {
+            layout->dynamic = layout->bias + phdrs[i].p_vaddr;
+            layout->dynamic_size = (size_t)phdrs[i].p_memsz;
+        }
     }
 
-    line = (char *)malloc(sizeof(char) * line_len);
-    libhack_assert_or_return(line != NULL, -1);
+    free(phdrs);
 
-    snprintf(maps_path, arraySize(maps_path), "/proc/%d/maps", pid);
+    if (!has_phdr || min_vaddr == (DWORD64)-1)
+        return ENOEXEC;
 
-    // Get file size
-    if (stat(maps_path, &st) == -1)
-    {
-        libhack_err("failed to stat %s: %d\n", maps_path, errno);
-        free(line);
-        return errno;
-    }
+    layout->base = (layout->bias + min_vaddr) & ~(page - 1);
+
+    return LIBHACK_OK;
+}
 
-    file_content = (char *)malloc(sizeof(char) * st.st_size);
-    libhack_assert_or_return(file_content != NULL, -1)
+long libhack_get_base_addr(struct libhack_handle *handle)
+{
+    const struct libhack_maps *maps;
+    struct libhack_exe_layout layout;
+
+    // Santity checking
+    libhack_assert_or_return(handle != NULL, -1);
 
-        int fd = open(maps_path, O_RDONLY);
-    if (fd == -1)
+    // Get process ID, so the auxiliary vector can be read
+    if (handle->pid == -1 && libhack_get_process_id(handle) == -1)
     {
-        // cleanup resources
-        free(line);
-        free(file_content);
-        return errno;
+        return -1;
     }
 
-    FILE *fp = fdopen(fd, "r");
-    if (fp == NULL)
+    // check if we already have a base address
+    if (handle->base_addr > 0)
     {
-        libhack_err("failed to open %s: %d\n", maps_path, errno);
-        free(line);
-        free(file_content);
-        close(fd);
-        return errno;
+        return handle->base_addr;
     }
 
-    unsigned long start = 0, end = 0;
-    char flags[32];
-    char pathname[BUFLEN];
+    if (libhack_get_exe_layout(handle, &layout) == LIBHACK_OK)
+    {
+        libhack_debug("base address: %llx (auxv)", layout.base);
+        handle->base_addr = (long)layout.base;
+        return handle->base_addr;
+    }
 
-    memset(flags, 0, sizeof(flags));
+    maps = libhack_get_maps(handle);
+    if (maps == NULL)
+    {
+        libhack_err("failed to read memory map of %s", handle->process_name);
+        return -1;
+    }
 
-    // read all contents of file, line by line
-    while ((getline(&line, &line_len, fp)) > 0)
+    // The first readable region belonging to the process image
+    for (size_t i = 0; i < maps->count; i++)
     {
-        sscanf(line, "%lx-%lx %31s %*x %*x:%*x %*u %255s", &start, &end, flags,
-               &pathname[0]);
+        const struct libhack_region *region = &maps->regions[i];
 
-        // The address must be readable
-        if ((strstr(pathname, handle->process_name) != NULL) && flags[0] == 'r')
+        if (region->perms[0] == 'r' &&
+            strstr(region->pathname, handle->process_name) != NULL)
         {
-            libhack_debug("base address: %lx", start);
-            break;
+            libhack_debug("base address: %llx", region->start);
+            handle->base_addr = (long)region->start;
+            return handle->base_addr;
         }
     }
 
-    // close file and release resources
-    fclose(fp);
-    close(fd);
-    free(file_content);
-    free(line);
-
-    // set base address
-    handle->base_addr = (long)start;
-
-    return start;
+    return 0;
 }
 
 long libhack_get_base_addr64(struct libhack_handle *handle)
@@ -1035,6 +1136,42 @@ long libhack_get_base_addr64(struct libhack_handle *handle)
     return libhack_get_base_addr(handle);
 }
 
+long libhack_getsubmodule_addr(struct libhack_handle *handle, const char *module_name)
+{
+    return libhack_getsubmodule_addr64(handle, module_name);
+}
+
+long libhack_getsubmodule_addr64(struct libhack_handle *handle, const char *module_name)
+{
+    const struct libhack_maps *maps;
+    const struct libhack_module *module;
+    bool changed = false;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && module_name != NULL, -1);
+
+    maps = libhack_get_maps(handle);
+    if (maps == NULL)
+    {
+        libhack_err("failed to read memory map of %s", handle->process_name);
+        return -1;
+    }
+
+    module = libhack_maps_find_module(maps, module_name);
+
+    // The module may have been loaded after the index was built
+    if (!module && libhack_maps_update(handle, &changed) == LIBHACK_OK && changed)
+        module = libhack_maps_find_module(handle->maps, module_name);
+
+    if (!module)
+    {
+        libhack_debug("module %s is not loaded", module_name);
+        return 0;
+    }
+
+    return (long)module->base;
+}
+
 long libhack_read_int_from_addr64(const struct libhack_handle *handle,
                                   DWORD64 addr, int *value)
 {
@@ -1044,12 +1181,16 @@ long libhack_read_int_from_addr64(const struct libhack_handle *handle,
     // Sanity checking
     libhack_assert_or_return(handle != NULL && value != NULL, -1);
 
+    // Fail fast once the target is gone
+    if (libhack_target_exited(handle))
+        return ESRCH;
+
     local.iov_base = value;
     local.iov_len = sizeof(int);
-    remote.iov_base = &addr;
+    remote.iov_base = (void *)(uintptr_t)addr;
     remote.iov_len = sizeof(int);
 
-    ssize_t readed = process_vm_readv(handle->pid, &local, 1, &remote, 1, 0);
+    ssize_t readed = libhack_get_backend(handle)->readv(handle, &local, &remote, 1);
     if (readed == -1 || readed != sizeof(int))
     {
         libhack_err("Failed to read memory at address %lx from %d: %d\n", addr,
@@ -1075,13 +1216,17 @@ long libhack_write_int_to_addr64(const struct libhack_handle *handle,
     // Sanity check
     libhack_assert_or_return(handle != NULL, -1);
 
+    // Fail fast once the target is gone
+    if (libhack_target_exited(handle))
+        return ESRCH;
+
     local.iov_base = &value;
     local.iov_len = sizeof(value);
-    remote.iov_base = &addr;
+    remote.iov_base = (void *)(uintptr_t)addr;
     remote.iov_len = sizeof(value);
 
     libhack_notice("writing address %lx on %d", addr, handle->pid);
-    ssize_t written = process_vm_writev(handle->pid, &local, 1, &remote, 1, 0);
+    ssize_t written = libhack_get_backend(handle)->writev(handle, &local, &remote, 1);
     if (written == -1 || (written != sizeof(value)))
     {
         libhack_debug("Failed to write memory: %d (addr: %llx)", errno, addr);
@@ -1103,7 +1248,12 @@ bool libhack_process_is_running(struct libhack_handle *handle)
 
     // Get process ID
     pid = libhack_get_process_id(handle);
-    libhack_assert_or_return(handle != NULL, false);
+    libhack_assert_or_return(pid != -1, false);
+
+    if (handle->pidfd != -1)
+    {
+        return !libhack_target_exited(handle);
+    }
 
     // Build process path on filesystem
     snprintf(image_path, arraySize(image_path), "/proc/%d", pid);
@@ -1137,13 +1287,17 @@ int libhack_write_string_to_addr64(const struct libhack_handle *handle,
     // Sanity check
     libhack_assert_or_return(handle != NULL, -1);
 
-    local.iov_base = &string;
+    // Fail fast once the target is gone
+    if (libhack_target_exited(handle))
+        return ESRCH;
+
+    local.iov_base = (void *)string;
     local.iov_len = string_len;
-    remote.iov_base = &addr;
+    remote.iov_base = (void *)(uintptr_t)addr;
     remote.iov_len = string_len;
 
     libhack_notice("writing address %lx on %d", addr, handle->pid);
-    ssize_t written = process_vm_writev(handle->pid, &local, 1, &remote, 1, 0);
+    ssize_t written = libhack_get_backend(handle)->writev(handle, &local, &remote, 1);
     if (written == -1 || (written != (ssize_t)string_len))
     {
         libhack_debug("Failed to write memory: %d (addr: %llx)", errno, addr);
@@ -1162,12 +1316,16 @@ __int64_t libhack_read_int64_from_addr64(const struct libhack_handle *handle,
 
     libhack_assert_or_return(handle, -1);
 
+    // Fail fast once the target is gone
+    if (libhack_target_exited(handle))
+        return ESRCH;
+
     local.iov_base = &local_value;
     local.iov_len = sizeof(__int64_t);
-    remote.iov_base = &addr;
+    remote.iov_base = (void *)(uintptr_t)addr;
     remote.iov_len = sizeof(__int64_t);
 
-    if (process_vm_readv(handle->pid, &local, 1, &remote, 1, 0) !=
+    if (libhack_get_backend(handle)->readv(handle, &local, &remote, 1) !=
         (ssize_t)sizeof(__int64_t))
     {
         libhack_err("failed to read address %llx: %d", addr, errno);
@@ -1177,4 +1335,346 @@ __int64_t libhack_read_int64_from_addr64(const struct libhack_handle *handle,
     return local_value;
 }
 
+/**
+ * @brief Gets the page size of the running system
+ *
+ * @return size_t Page size in bytes
+ */
+static size_t libhack_page_size()
+{
+    static size_t page_size = 0;
+
+    if (page_size == 0)
+    {
+        long value = sysconf(_SC_PAGESIZE);
+        page_size = value > 0 ? (size_t)value : 4096;
+    }
+
+    return page_size;
+}
+
+/**
+ * @brief Sets the status of every descriptor of a batch which failed as a whole
+ *
+ * @param status Status of each descriptor (may be NULL)
+ * @param count Number of descriptors
+ * @param err Error of the batch
+ * @return long err
+ */
+static long libhack_fail_batch(long *status, size_t count, long err)
+{
+    if (status)
+    {
+        for (size_t i = 0; i < count; i++)
+            status[i] = err;
+    }
+
+    return err;
+}
+
+/**
+ * @brief Transfers a set of descriptors using vectored backend calls
+ *
+ * The kernel stops a vectored transfer at the first remote iovec that faults,
+ * so the call is restarted right after the failing descriptor until every
+ * descriptor has a status.
+ *
+ * @param handle Handle to libhack
+ * @param descs Descriptors to be transferred
+ * @param count Number of descriptors
+ * @param status Receives the status of each descriptor
+ * @param write true to write the descriptors, false to read them
+ * @return long LIBHACK_OK if every descriptor was transferred, the first error otherwise
+ */
+static long libhack_transfer_batch(const struct libhack_handle *handle,
+                                   const struct libhack_mem_desc *descs,
+                                   size_t count, long *status, bool write)
+{
+    struct iovec *local;
+    struct iovec *remote;
+    size_t *index;
+    size_t cursor = 0;
+    size_t slots = count < IOV_MAX ? count : IOV_MAX;
+    long result = LIBHACK_OK;
+
+    local = (struct iovec *)malloc(sizeof(struct iovec) * slots);
+    remote = (struct iovec *)malloc(sizeof(struct iovec) * slots);
+    index = (size_t *)malloc(sizeof(size_t) * slots);
+
+    if (!local || !remote || !index)
+    {
+        libhack_err("failed to allocate memory for batch of %zu entries", count);
+        free(local);
+        free(remote);
+        free(index);
+        return libhack_fail_batch(status, count, ENOMEM);
+    }
+
+    while (cursor < count)
+    {
+        size_t n = 0;
+        size_t next = cursor;
+
+        // Pack as many non-empty descriptors as allowed in a single call
+        while (next < count && n < slots)
+        {
+            if (descs[next].len > 0)
+            {
+                local[n].iov_base = descs[next].buffer;
+                local[n].iov_len = descs[next].len;
+                remote[n].iov_base = (void *)(uintptr_t)descs[next].addr;
+                remote[n].iov_len = descs[next].len;
+                index[n++] = next;
+            }
+            else
+            {
+                status[next] = LIBHACK_OK;
+            }
+
+            next++;
+        }
+
+        if (n == 0)
+            break;
+
+        ssize_t done = write
+            ? libhack_get_backend(handle)->writev(handle, local, remote, n)
+            : libhack_get_backend(handle)->readv(handle, local, remote, n);
+
+        if (done == -1 && errno != EFAULT)
+        {
+            // The whole call failed (process gone, permission denied, ...)
+            long err = errno;
+
+            for (size_t i = 0; i < n; i++)
+                status[index[i]] = err;
+
+            for (; next < count; next++)
+                status[next] = err;
+
+            if (result == LIBHACK_OK)
+                result = err;
+
+            break;
+        }
+
+        // Account for every descriptor completed before the fault
+        size_t i = 0;
+        size_t transferred = done > 0 ? (size_t)done : 0;
+
+        while (i < n && transferred >= remote[i].iov_len)
+        {
+            transferred -= remote[i].iov_len;
+            status[index[i++]] = LIBHACK_OK;
+        }
+
+        if (i < n)
+        {
+            // Skip the faulting descriptor and restart after it
+            status[index[i]] = EFAULT;
+            if (result == LIBHACK_OK)
+                result = EFAULT;
+
+            cursor = index[i] + 1;
+        }
+        else
+        {
+            cursor = next;
+        }
+    }
+
+    free(local);
+    free(remote);
+    free(index);
+
+    return result;
+}
+
+long libhack_read_batch(const struct libhack_handle *handle,
+                        const struct libhack_mem_desc *descs, size_t count,
+                        long *status)
+{
+    long *results = status;
+    long ret;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && (descs != NULL || count == 0), -1);
+
+    if (count == 0)
+        return LIBHACK_OK;
+
+    // Fail fast once the target is gone
+    if (libhack_target_exited(handle))
+        return libhack_fail_batch(status, count, ESRCH);
+
+    if (!results)
+    {
+        results = (long *)malloc(sizeof(long) * count);
+        libhack_assert_or_return(results != NULL, ENOMEM);
+    }
+
+    ret = libhack_transfer_batch(handle, descs, count, results, false);
+
+    if (results != status)
+        free(results);
+
+    return ret;
+}
+
+long libhack_write_batch(const struct libhack_handle *handle,
+                         const struct libhack_mem_desc *descs, size_t count,
+                         long *status)
+{
+    long *results = status;
+    long ret;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && (descs != NULL || count == 0), -1);
+
+    if (count == 0)
+        return LIBHACK_OK;
+
+    // Fail fast once the target is gone
+    if (libhack_target_exited(handle))
+        return libhack_fail_batch(status, count, ESRCH);
+
+    if (!results)
+    {
+        results = (long *)malloc(sizeof(long) * count);
+        libhack_assert_or_return(results != NULL, ENOMEM);
+    }
+
+    libhack_debug("writing %zu entries on %d", count, handle->pid);
+    ret = libhack_transfer_batch(handle, descs, count, results, true);
+
+    if (results != status)
+        free(results);
+
+    return ret;
+}
+
+size_t libhack_page_bitmap_size(DWORD64 addr, size_t len)
+{
+    size_t page = libhack_page_size();
+    DWORD64 first = addr & ~((DWORD64)page - 1);
+    size_t pages = (size_t)((addr + len - first + page - 1) / page);
+
+    return (pages + 7) / 8;
+}
+
+/**
+ * @brief Finds where the unreadable range holding a faulting address ends
+ *
+ * The cached region table gives the end of an unmapped hole or of an
+ * unreadable region in one lookup. Without a table, or if the table still
+ * lists the address as readable (it is outdated), only its page is skipped.
+ *
+ * @param handle Handle to libhack
+ * @param fault Address which could not be read
+ * @param page Page size
+ * @return DWORD64 First address which may be readable
+ */
+static DWORD64 libhack_unreadable_end(const struct libhack_handle *handle, DWORD64 fault,
+                                      size_t page)
+{
+    const struct libhack_maps *maps = handle->maps;
+    const struct libhack_region *region;
+    DWORD64 next_page = (fault & ~((DWORD64)page - 1)) + page;
+    size_t low = 0;
+    size_t high;
+
+    if (!maps)
+        return next_page;
+
+    region = libhack_maps_find(maps, fault);
+    if (region)
+        return libhack_region_readable(region) ? next_page : region->end;
+
+    // A hole between two regions ends where the next region starts
+    high = maps->count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+
+        if (maps->regions[mid].start <= fault)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low < maps->count ? maps->regions[low].start : (DWORD64)-1;
+}
+
+long libhack_read_bytes(const struct libhack_handle *handle, DWORD64 addr,
+                        void *buffer, size_t len, unsigned char *bad_pages)
+{
+    unsigned char *local_buffer = (unsigned char *)buffer;
+    size_t page = libhack_page_size();
+    DWORD64 first_page = addr & ~((DWORD64)page - 1);
+    size_t pos = 0;
+    long result = LIBHACK_OK;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && (buffer != NULL || len == 0), -1);
+
+    // Fail fast once the target is gone
+    if (libhack_target_exited(handle))
+        return ESRCH;
+
+    if (bad_pages)
+        memset(bad_pages, 0, libhack_page_bitmap_size(addr, len));
+
+    while (pos < len)
+    {
+        struct iovec local;
+        struct iovec remote;
+        size_t chunk = len - pos;
+
+        if (chunk > LIBHACK_BULK_READ_CHUNK)
+            chunk = LIBHACK_BULK_READ_CHUNK;
+
+        local.iov_base = local_buffer + pos;
+        local.iov_len = chunk;
+        remote.iov_base = (void *)(uintptr_t)(addr + pos);
+        remote.iov_len = chunk;
+
+        ssize_t readed = libhack_get_backend(handle)->readv(handle, &local, &remote, 1);
+        if (readed == -1 && errno != EFAULT)
+        {
+            libhack_err("failed to read %zu bytes at %llx from %d: %d", chunk,
+                        addr + pos, handle->pid, errno);
+            return errno;
+        }
+
+        if (readed > 0)
+            pos += (size_t)readed;
+
+        if (readed == (ssize_t)chunk)
+            continue;
+
+        // The read stopped at an unreadable page: skip the whole hole and carry on
+        DWORD64 fault = addr + pos;
+        DWORD64 resume = libhack_unreadable_end(handle, fault, page);
+        size_t skip = len - pos;
+
+        if (resume - fault < skip)
+            skip = (size_t)(resume - fault);
+
+        memset(local_buffer + pos, 0, skip);
+
+        if (bad_pages)
+        {
+            size_t last = (size_t)((fault + skip - 1 - first_page) / page);
+
+            for (size_t index = (size_t)((fault - first_page) / page); index <= last; index++)
+                bad_pages[index / 8] |= (unsigned char)(1 << (index % 8));
+        }
+
+        result = EFAULT;
+        pos += skip;
+    }
+
+    return result;
+}
+
 #endif
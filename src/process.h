@@ -184,6 +184,19 @@ LIBHACK_API __int64 libhack_read_int64_from_addr64(struct libhack_handle *handle
 
 pid_t libhack_get_process_id(struct libhack_handle *handle);
 
+/**
+ * @brief Attaches the handle to a known process ID
+ *
+ * Opens a pidfd referring to the process and selects the memory backend.
+ * Reads and writes fail with ESRCH once the process has exited. If no
+ * backend is able to read the process, the handle is left detached.
+ *
+ * @param handle Handle to libhack
+ * @param pid Process ID
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_attach_pid(struct libhack_handle *handle, pid_t pid);
+
 
 
 long libhack_read_int_from_addr(const struct libhack_handle *handle, DWORD addr, int *value);
@@ -191,9 +204,98 @@ long libhack_read_int_from_addr64(const struct libhack_handle *handle, DWORD64 a
 long libhack_write_int_to_addr(const struct libhack_handle *handle, DWORD addr, int value);
 long libhack_write_int_to_addr64(const struct libhack_handle *handle, DWORD64 addr, int value);
 
+/**
+ * @brief Where the kernel loaded the main executable and its interpreter
+ *
+ */
+struct libhack_exe_layout
+{
+	/**
+	 * @brief Address of the first loadable segment of the executable
+	 *
+	 */
+	DWORD64 base;
+
+	/**
+	 * @brief Difference between runtime addresses and ELF virtual addresses (0 unless PIE)
+	 *
+	 */
+	DWORD64 bias;
+
+	/**
+	 * @brief Entry point of the executable (AT_ENTRY)
+	 *
+	 */
+	DWORD64 entry;
+
+	/**
+	 * @brief Program headers of the executable (AT_PHDR)
+	 *
+	 */
+	DWORD64 phdr;
+
+	/**
+	 * @brief Number of program headers (AT_PHNUM)
+	 *
+	 */
+	size_t phnum;
+
+	/**
+	 * @brief Dynamic section of the executable (0 for static executables)
+	 *
+	 */
+	DWORD64 dynamic;
+
+	/**
+	 * @brief Size in bytes of the dynamic section
+	 *
+	 */
+	size_t dynamic_size;
+
+	/**
+	 * @brief Load address of the dynamic loader (AT_BASE, 0 for static executables)
+	 *
+	 */
+	DWORD64 interp_base;
+};
+
+/**
+ * @brief Gets the layout of the main executable from the auxiliary vector
+ *
+ * Only /proc/<pid>/auxv and the program headers are read, so the result does
+ * not depend on the name of the process or on its memory map.
+ *
+ * @param handle Handle to libhack
+ * @param layout Receives the layout
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_get_exe_layout(struct libhack_handle *handle, struct libhack_exe_layout *layout);
+
+/**
+ * @brief Gets the load address of the main executable
+ *
+ * The auxiliary vector is used first; the memory map is searched for the
+ * process name only if it cannot be read. The result is cached in the handle.
+ *
+ * @param handle Handle to libhack
+ * @return long Load address, 0 if it was not found or -1 on error
+ */
 long libhack_get_base_addr(struct libhack_handle *handle);
 long libhack_get_base_addr64(struct libhack_handle *handle);
 
+/**
+ * @brief Gets the load address of a module loaded by the process
+ *
+ * Modules are looked up in the index built with the region table, so only
+ * the first call after the process maps or unmaps files parses its maps.
+ *
+ * @param handle Handle to libhack
+ * @param module_name File name ("libc.so.6") or full pathname of the module
+ * @return long Load address, 0 if the module is not loaded or -1 on error
+ */
+long libhack_getsubmodule_addr(struct libhack_handle *handle, const char *module_name);
+long libhack_getsubmodule_addr64(struct libhack_handle *handle, const char *module_name);
+
 bool libhack_process_is_running(struct libhack_handle *handle);
 
 int libhack_write_string_to_addr(const struct libhack_handle *handle, DWORD addr, const char *string, size_t string_len);
@@ -201,6 +303,90 @@ int libhack_write_string_to_addr64(const struct libhack_handle *handle, DWORD64
 
 __int64_t libhack_read_int64_from_addr64(const struct libhack_handle *handle, DWORD64 addr);
 
+/**
+ * @brief Describes a single remote memory transfer used by batched operations
+ *
+ */
+struct libhack_mem_desc
+{
+	/**
+	 * @brief Address on the remote process
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Local buffer (destination for reads, source for writes)
+	 *
+	 */
+	void *buffer;
+
+	/**
+	 * @brief Number of bytes to be transferred
+	 *
+	 */
+	size_t len;
+};
+
+/**
+ * @brief Reads many remote addresses using as few syscalls as possible
+ *
+ * Descriptors are packed up to IOV_MAX per process_vm_readv call. A descriptor
+ * that cannot be read does not prevent the remaining ones from being read.
+ *
+ * @param handle Handle to libhack
+ * @param descs Array of descriptors to be read
+ * @param count Number of descriptors
+ * @param status Receives LIBHACK_OK or an errno value for each descriptor, also set when
+ * the whole batch fails (may be NULL)
+ * @return long LIBHACK_OK if every descriptor was read, the first error code otherwise
+ */
+long libhack_read_batch(const struct libhack_handle *handle, const struct libhack_mem_desc *descs, size_t count, long *status);
+
+/**
+ * @brief Writes many remote addresses using as few syscalls as possible
+ *
+ * Descriptors are flushed through process_vm_writev calls chunked at IOV_MAX.
+ * A descriptor that cannot be written does not prevent the remaining ones from
+ * being written.
+ *
+ * @param handle Handle to libhack
+ * @param descs Array of descriptors to be written
+ * @param count Number of descriptors
+ * @param status Receives LIBHACK_OK or an errno value for each descriptor, also set when
+ * the whole batch fails (may be NULL)
+ * @return long LIBHACK_OK if every descriptor was written, the first error code otherwise
+ */
+long libhack_write_batch(const struct libhack_handle *handle, const struct libhack_mem_desc *descs, size_t count, long *status);
+
+/**
+ * @brief Gets the size in bytes of the bitmap needed by libhack_read_bytes
+ *
+ * @param addr First address to be read
+ * @param len Number of bytes to be read
+ * @return size_t Size of bitmap, one bit per page touched by the range
+ */
+size_t libhack_page_bitmap_size(DWORD64 addr, size_t len);
+
+/**
+ * @brief Reads an arbitrary amount of bytes from the remote process
+ *
+ * The range is streamed in chunks of LIBHACK_BULK_READ_CHUNK bytes. Pages that
+ * cannot be read (unmapped or guard pages) are skipped and zero-filled on the
+ * local buffer instead of aborting the whole read. With a region table loaded
+ * on the handle, a hole is skipped up to the next readable region at once;
+ * without one it is skipped page by page, one syscall per page. An outdated
+ * table may make readable pages mapped since then be skipped as well.
+ *
+ * @param handle Handle to libhack
+ * @param addr Address to read from
+ * @param buffer Local buffer with at least len bytes
+ * @param len Number of bytes to be read
+ * @param bad_pages Bitmap which receives the pages that could not be read (may be NULL)
+ * @return long LIBHACK_OK if the range was fully read, EFAULT if some pages were skipped, errno otherwise
+ */
+long libhack_read_bytes(const struct libhack_handle *handle, DWORD64 addr, void *buffer, size_t len, unsigned char *bad_pages);
+
 #endif
 
 #ifdef __cplusplus
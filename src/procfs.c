@@ -0,0 +1,259 @@
+/**
+ * @file procfs.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Process discovery through /proc
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "consts.h"
+#include "logger.h"
+#include "procfs.h"
+#include "status_codes.h"
+
+/**
+ * @brief Maximum length of /proc/<pid>/comm without the null terminator
+ *
+ */
+#define COMM_MAX_LEN 15
+
+/**
+ * @brief Reads a small file into a buffer
+ *
+ * @param path File path
+ * @param buffer Buffer
+ * @param len Size of buffer
+ * @return ssize_t Number of bytes read or -1 on error
+ */
+static ssize_t libhack_read_small_file(const char *path, char *buffer, size_t len)
+{
+    ssize_t readed;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return -1;
+
+    do
+    {
+        readed = read(fd, buffer, len);
+    } while (readed == -1 && errno == EINTR);
+
+    close(fd);
+
+    return readed;
+}
+
+/**
+ * @brief Gets the file name part of a path
+ *
+ * @param path Path
+ * @return const char* File name
+ */
+static const char *libhack_basename(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+
+    return slash ? slash + 1 : path;
+}
+
+static bool libhack_match_comm(const char *pid_dir, const char *name, size_t name_len)
+{
+    char path[BUFLEN];
+    char comm[COMM_MAX_LEN + 2];
+
+    snprintf(path, sizeof(path), "%s/comm", pid_dir);
+
+    ssize_t readed = libhack_read_small_file(path, comm, sizeof(comm) - 1);
+    if (readed <= 0)
+        return false;
+
+    if (comm[readed - 1] == '\n')
+        readed--;
+
+    comm[readed] = '\0';
+
+    // The kernel truncates long names, so only the prefix can be compared
+    if (name_len > COMM_MAX_LEN)
+        name_len = COMM_MAX_LEN;
+
+    return (size_t)readed == name_len && memcmp(comm, name, name_len) == 0;
+}
+
+static bool libhack_match_exe(const char *pid_dir, const char *name)
+{
+    char path[BUFLEN];
+    char target[PATH_MAX];
+
+    snprintf(path, sizeof(path), "%s/exe", pid_dir);
+
+    ssize_t len = readlink(path, target, sizeof(target) - 1);
+    if (len <= 0)
+        return false;
+
+    target[len] = '\0';
+
+    // Executables replaced on disk are reported as "path (deleted)"
+    char *deleted = strstr(target, " (deleted)");
+    if (deleted && deleted[10] == '\0')
+        *deleted = '\0';
+
+    return strcmp(libhack_basename(target), name) == 0;
+}
+
+static bool libhack_match_cmdline(const char *pid_dir, const char *name)
+{
+    char path[BUFLEN];
+    char cmdline[PATH_MAX];
+
+    snprintf(path, sizeof(path), "%s/cmdline", pid_dir);
+
+    ssize_t readed = libhack_read_small_file(path, cmdline, sizeof(cmdline) - 1);
+    if (readed <= 0)
+        return false;
+
+    // Only argv[0] is compared: it ends at the first null byte
+    cmdline[readed] = '\0';
+
+    return strcmp(libhack_basename(cmdline), name) == 0;
+}
+
+size_t libhack_find_processes(const char *name, int flags, pid_t *pids,
+                              size_t max_pids)
+{
+    struct dirent *entry;
+    size_t found = 0;
+    size_t name_len;
+
+    // Sanity checking
+    if (!name || !pids || max_pids == 0)
+        return 0;
+
+    if (flags == 0)
+        flags = LIBHACK_MATCH_COMM;
+
+    name_len = strlen(name);
+
+    DIR *proc = opendir("/proc");
+    if (proc == NULL)
+    {
+        libhack_err("failed to open /proc: %d", errno);
+        return 0;
+    }
+
+    while (found < max_pids && (entry = readdir(proc)) != NULL)
+    {
+        char pid_dir[32];
+        char *end;
+
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9')
+            continue;
+
+        long pid = strtol(entry->d_name, &end, 10);
+        if (*end != '\0')
+            continue;
+
+        snprintf(pid_dir, sizeof(pid_dir), "/proc/%ld", pid);
+
+        if (((flags & LIBHACK_MATCH_COMM) && libhack_match_comm(pid_dir, name, name_len)) ||
+            ((flags & LIBHACK_MATCH_EXE) && libhack_match_exe(pid_dir, name)) ||
+            ((flags & LIBHACK_MATCH_CMDLINE) && libhack_match_cmdline(pid_dir, name)))
+        {
+            pids[found++] = (pid_t)pid;
+        }
+    }
+
+    closedir(proc);
+
+    return found;
+}
+
+pid_t libhack_find_process(const char *name, int flags)
+{
+    pid_t pid;
+
+    if (libhack_find_processes(name, flags, &pid, 1) == 0)
+        return -1;
+
+    return pid;
+}
+
+size_t libhack_list_threads(pid_t pid, pid_t *tids, size_t max_tids)
+{
+    struct dirent *entry;
+    char path[BUFLEN];
+    size_t found = 0;
+    DIR *task;
+
+    // Sanity checking
+    if (!tids || max_tids == 0)
+        return 0;
+
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+
+    task = opendir(path);
+    if (task == NULL)
+        return 0;
+
+    while (found < max_tids && (entry = readdir(task)) != NULL)
+    {
+        char *end;
+        long tid = strtol(entry->d_name, &end, 10);
+
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9' || *end != '\0')
+            continue;
+
+        tids[found++] = (pid_t)tid;
+    }
+
+    closedir(task);
+
+    return found;
+}
+
+long libhack_read_auxv(pid_t pid, DWORD64 *values, size_t count)
+{
+    char path[BUFLEN];
+    DWORD64 auxv[BUFLEN];
+    ssize_t readed;
+
+    // Sanity checking
+    if (!values)
+        return EINVAL;
+
+    snprintf(path, sizeof(path), "/proc/%d/auxv", pid);
+
+    readed = libhack_read_small_file(path, (char *)auxv, sizeof(auxv));
+    if (readed <= 0)
+        return readed == 0 ? EIO : errno;
+
+    memset(values, 0, count * sizeof(DWORD64));
+
+    // Pairs of type and value, ended by AT_NULL
+    for (size_t i = 0; i + 1 < (size_t)readed / sizeof(DWORD64) && auxv[i] != 0; i += 2)
+    {
+        if (auxv[i] < count)
+            values[auxv[i]] = auxv[i + 1];
+    }
+
+    return LIBHACK_OK;
+}
+
+#endif // __linux__
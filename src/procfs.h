@@ -0,0 +1,101 @@
+/**
+ * @file procfs.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Process discovery through /proc
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_PROCFS_H
+#define LIBHACK_PROCFS_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stddef.h>
+#include <sys/types.h>
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Match against /proc/<pid>/comm (names are truncated to 15 characters)
+ *
+ */
+#define LIBHACK_MATCH_COMM 0x1
+
+/**
+ * @brief Match against the file name of /proc/<pid>/exe
+ *
+ */
+#define LIBHACK_MATCH_EXE 0x2
+
+/**
+ * @brief Match against the file name of argv[0] on /proc/<pid>/cmdline
+ *
+ */
+#define LIBHACK_MATCH_CMDLINE 0x4
+
+/**
+ * @brief Finds the processes with the specified name
+ *
+ * Only the files selected by flags are read for each process. The search stops
+ * as soon as max_pids processes were found.
+ *
+ * @param name Process name
+ * @param flags Combination of LIBHACK_MATCH_* flags
+ * @param pids Receives the process IDs found
+ * @param max_pids Capacity of pids
+ * @return size_t Number of process IDs stored in pids
+ */
+size_t libhack_find_processes(const char *name, int flags, pid_t *pids, size_t max_pids);
+
+/**
+ * @brief Finds the first process with the specified name
+ *
+ * @param name Process name
+ * @param flags Combination of LIBHACK_MATCH_* flags
+ * @return pid_t Process ID or -1 if no process was found
+ */
+pid_t libhack_find_process(const char *name, int flags);
+
+/**
+ * @brief Lists the threads of a process
+ *
+ * @param pid Process ID
+ * @param tids Receives the thread IDs
+ * @param max_tids Capacity of tids (the list stops there)
+ * @return size_t Number of thread IDs stored in tids (0 if the process is gone)
+ */
+size_t libhack_list_threads(pid_t pid, pid_t *tids, size_t max_tids);
+
+/**
+ * @brief Number of AT_* types covered by libhack_read_auxv callers
+ *
+ */
+#define LIBHACK_AUXV_ENTRIES 64
+
+/**
+ * @brief Reads the auxiliary vector the kernel passed to a process
+ *
+ * @param pid Process ID
+ * @param values Array indexed by AT_* type, receiving the value of each entry
+ * (0 for entries the process did not get)
+ * @param count Number of entries of values (types from count on are ignored)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_read_auxv(pid_t pid, DWORD64 *values, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_PROCFS_H
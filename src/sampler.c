@@ -0,0 +1,634 @@
+/**
+ * @file sampler.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Fixed-rate sampling of a watch list into ring buffers
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "logger.h"
+#include "process.h"
+#include "sampler.h"
+#include "status_codes.h"
+
+/**
+ * @brief Words of a struct libhack_sample, copied with atomic accesses
+ *
+ */
+#define SAMPLE_WORDS (sizeof(struct libhack_sample) / sizeof(uint64_t))
+
+/**
+ * @brief Nanoseconds per second
+ *
+ */
+#define NSEC_PER_SEC 1000000000ULL
+
+/**
+ * @brief A slot of a ring buffer, guarded by its sequence number
+ *
+ */
+struct libhack_sample_slot
+{
+	/**
+	 * @brief Sequence number of the sample plus one (0 while the slot is written)
+	 *
+	 */
+	uint64_t seq;
+
+	/**
+	 * @brief The sample
+	 *
+	 */
+	uint64_t words[SAMPLE_WORDS];
+};
+
+/**
+ * @brief Ring buffer with a single producer and any number of readers
+ *
+ * Readers never modify the ring: each one follows its own cursor and checks
+ * the sequence number of a slot before and after copying it, so a sample
+ * overwritten while it is read is detected.
+ *
+ */
+struct libhack_sample_ring
+{
+	/**
+	 * @brief Slots
+	 *
+	 */
+	struct libhack_sample_slot *slots;
+
+	/**
+	 * @brief Number of slots minus one (a power of two minus one)
+	 *
+	 */
+	uint64_t mask;
+
+	/**
+	 * @brief Sequence number of the next sample to be written
+	 *
+	 */
+	uint64_t head;
+};
+
+/**
+ * @brief An address of the watch list
+ *
+ */
+struct libhack_sampler_watch
+{
+	/**
+	 * @brief Address on the remote process
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Number of bytes read
+	 *
+	 */
+	size_t size;
+};
+
+struct libhack_sampler
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Nanoseconds between two ticks
+	 *
+	 */
+	uint64_t period;
+
+	/**
+	 * @brief Watch list
+	 *
+	 */
+	struct libhack_sampler_watch *watches;
+
+	/**
+	 * @brief Number of watches
+	 *
+	 */
+	size_t count;
+
+	/**
+	 * @brief Capacity of watches
+	 *
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief Read descriptors of the watch list, pointing to values
+	 *
+	 */
+	struct libhack_mem_desc *descs;
+
+	/**
+	 * @brief Status of each descriptor of the last tick
+	 *
+	 */
+	long *status;
+
+	/**
+	 * @brief Values read by the last tick
+	 *
+	 */
+	uint64_t *values;
+
+	/**
+	 * @brief Last value read of each watch
+	 *
+	 */
+	uint64_t *previous;
+
+	/**
+	 * @brief previous holds a value (the watch was read at least once)
+	 *
+	 */
+	bool *known;
+
+	/**
+	 * @brief Every sample
+	 *
+	 */
+	struct libhack_sample_ring all;
+
+	/**
+	 * @brief Samples whose value changed
+	 *
+	 */
+	struct libhack_sample_ring changes;
+
+	/**
+	 * @brief Sampling thread
+	 *
+	 */
+	pthread_t thread;
+
+	/**
+	 * @brief The sampling thread was started and not joined yet
+	 *
+	 */
+	bool started;
+
+	/**
+	 * @brief Cleared to stop the sampling thread
+	 *
+	 */
+	bool running;
+
+	/**
+	 * @brief Statistics, updated by the sampling thread
+	 *
+	 */
+	struct libhack_sampler_stats stats;
+};
+
+struct libhack_sampler_sub
+{
+	/**
+	 * @brief Ring followed
+	 *
+	 */
+	const struct libhack_sample_ring *ring;
+
+	/**
+	 * @brief Sequence number of the next sample to be read
+	 *
+	 */
+	uint64_t cursor;
+
+	/**
+	 * @brief Samples overwritten before they were read
+	 *
+	 */
+	uint64_t missed;
+};
+
+static long libhack_sample_ring_init(struct libhack_sample_ring *ring, size_t size)
+{
+    size_t slots = 1;
+
+    while (slots < size)
+        slots <<= 1;
+
+    ring->slots = (struct libhack_sample_slot *)calloc(slots, sizeof(struct libhack_sample_slot));
+    if (!ring->slots)
+        return ENOMEM;
+
+    ring->mask = slots - 1;
+    ring->head = 0;
+
+    return LIBHACK_OK;
+}
+
+static void libhack_sample_ring_push(struct libhack_sample_ring *ring,
+                                     const struct libhack_sample *sample)
+{
+    uint64_t seq = ring->head;
+    struct libhack_sample_slot *slot = &ring->slots[seq & ring->mask];
+    uint64_t words[SAMPLE_WORDS];
+
+    memcpy(words, sample, sizeof(words));
+
+    // Readers of the previous sample of the slot see it change under them
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    for (size_t i = 0; i < SAMPLE_WORDS; i++)
+        __atomic_store_n(&slot->words[i], words[i], __ATOMIC_RELAXED);
+
+    __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->head, seq + 1, __ATOMIC_RELEASE);
+}
+
+static uint64_t libhack_sampler_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * NSEC_PER_SEC + (uint64_t)now.tv_nsec;
+}
+
+struct libhack_sampler *libhack_sampler_create(struct libhack_handle *handle,
+                                               const struct libhack_sampler_options *options)
+{
+    struct libhack_sampler *sampler;
+    unsigned int rate = options && options->rate ? options->rate : LIBHACK_SAMPLER_RATE;
+    size_t ring_size = options && options->ring_size ? options->ring_size : LIBHACK_SAMPLER_RING_SIZE;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, NULL);
+
+    sampler = (struct libhack_sampler *)calloc(1, sizeof(struct libhack_sampler));
+    if (!sampler)
+        return NULL;
+
+    sampler->handle = handle;
+    sampler->period = NSEC_PER_SEC / rate;
+
+    if (libhack_sample_ring_init(&sampler->all, ring_size) != LIBHACK_OK ||
+        libhack_sample_ring_init(&sampler->changes, ring_size) != LIBHACK_OK)
+    {
+        libhack_sampler_free(sampler);
+        return NULL;
+    }
+
+    return sampler;
+}
+
+/**
+ * @brief Doubles the capacity of the watch list
+ *
+ * @param sampler Sampler
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_sampler_grow(struct libhack_sampler *sampler)
+{
+    size_t capacity = sampler->capacity ? sampler->capacity * 2 : 64;
+    void *grown;
+
+    grown = realloc(sampler->watches, capacity * sizeof(struct libhack_sampler_watch));
+    if (!grown)
+        return ENOMEM;
+    sampler->watches = (struct libhack_sampler_watch *)grown;
+
+    grown = realloc(sampler->descs, capacity * sizeof(struct libhack_mem_desc));
+    if (!grown)
+        return ENOMEM;
+    sampler->descs = (struct libhack_mem_desc *)grown;
+
+    grown = realloc(sampler->status, capacity * sizeof(long));
+    if (!grown)
+        return ENOMEM;
+    sampler->status = (long *)grown;
+
+    grown = realloc(sampler->values, capacity * sizeof(uint64_t));
+    if (!grown)
+        return ENOMEM;
+    sampler->values = (uint64_t *)grown;
+
+    grown = realloc(sampler->previous, capacity * sizeof(uint64_t));
+    if (!grown)
+        return ENOMEM;
+    sampler->previous = (uint64_t *)grown;
+
+    grown = realloc(sampler->known, capacity * sizeof(bool));
+    if (!grown)
+        return ENOMEM;
+    sampler->known = (bool *)grown;
+
+    // Values may have moved
+
+    for (size_t i = 0; i < sampler->count; i++)
+        sampler->descs[i].buffer = &sampler->values[i];
+
+    sampler->capacity = capacity;
+
+    return LIBHACK_OK;
+}
+
+long libhack_sampler_add(struct libhack_sampler *sampler, DWORD64 addr, size_t size,
+                         uint32_t *watch)
+{
+    size_t index;
+
+    // Sanity checking
+    libhack_assert_or_return(sampler != NULL && watch != NULL, -1);
+
+    if (size == 0 || size > sizeof(uint64_t))
+        return EINVAL;
+
+    if (sampler->started)
+        return EBUSY;
+
+    if (sampler->count == sampler->capacity)
+    {
+        long status = libhack_sampler_grow(sampler);
+        if (status != LIBHACK_OK)
+            return status;
+    }
+
+    index = sampler->count++;
+    sampler->watches[index].addr = addr;
+    sampler->watches[index].size = size;
+    sampler->descs[index].addr = addr;
+    sampler->descs[index].buffer = &sampler->values[index];
+    sampler->descs[index].len = size;
+
+    *watch = (uint32_t)index;
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Reads the watch list and appends its samples
+ *
+ * @param sampler Sampler
+ * @return long LIBHACK_OK or ESRCH if the process is gone
+ */
+static long libhack_sampler_tick(struct libhack_sampler *sampler)
+{
+    struct libhack_sample sample;
+    uint64_t failed = 0;
+    long ret;
+
+    // Partial reads leave the bytes above the size untouched
+    memset(sampler->values, 0, sampler->count * sizeof(uint64_t));
+
+    sample.time = libhack_sampler_now();
+
+    ret = libhack_read_batch(sampler->handle, sampler->descs, sampler->count, sampler->status);
+    if (ret == ESRCH)
+        return ESRCH;
+
+    for (size_t i = 0; i < sampler->count; i++)
+    {
+        if (sampler->status[i] != LIBHACK_OK)
+        {
+            failed++;
+            continue;
+        }
+
+        sample.watch = (uint32_t)i;
+        sample.size = (uint32_t)sampler->watches[i].size;
+        sample.value = sampler->values[i];
+
+        libhack_sample_ring_push(&sampler->all, &sample);
+
+        if (!sampler->known[i] || sample.value != sampler->previous[i])
+            libhack_sample_ring_push(&sampler->changes, &sample);
+
+        sampler->previous[i] = sample.value;
+        sampler->known[i] = true;
+    }
+
+    __atomic_add_fetch(&sampler->stats.ticks, 1, __ATOMIC_RELAXED);
+
+    if (failed)
+        __atomic_add_fetch(&sampler->stats.failed_reads, failed, __ATOMIC_RELAXED);
+
+    return LIBHACK_OK;
+}
+
+static void *libhack_sampler_thread(void *arg)
+{
+    struct libhack_sampler *sampler = (struct libhack_sampler *)arg;
+    uint64_t next = libhack_sampler_now();
+
+    while (__atomic_load_n(&sampler->running, __ATOMIC_ACQUIRE))
+    {
+        struct timespec deadline;
+        uint64_t now;
+
+        if (libhack_sampler_tick(sampler) != LIBHACK_OK)
+        {
+            libhack_debug("sampler of %d stopped: process is gone", sampler->handle->pid);
+            __atomic_store_n(&sampler->stats.status, ESRCH, __ATOMIC_RELAXED);
+            break;
+        }
+
+        next += sampler->period;
+
+        // Ticks are kept on the grid of the first one: missed ticks are dropped, not bunched up
+        now = libhack_sampler_now();
+        if (now >= next)
+        {
+            uint64_t behind = (now - next) / sampler->period + 1;
+
+            __atomic_add_fetch(&sampler->stats.late_ticks, behind, __ATOMIC_RELAXED);
+            next += behind * sampler->period;
+        }
+
+        deadline.tv_sec = (time_t)(next / NSEC_PER_SEC);
+        deadline.tv_nsec = (long)(next % NSEC_PER_SEC);
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+            ;
+    }
+
+    return NULL;
+}
+
+long libhack_sampler_start(struct libhack_sampler *sampler)
+{
+    int error;
+
+    // Sanity checking
+    libhack_assert_or_return(sampler != NULL, -1);
+
+    if (sampler->started)
+        return EBUSY;
+
+    if (sampler->handle->pid == -1)
+        return ESRCH;
+
+    // The first tick reports every value
+    if (sampler->count > 0)
+        memset(sampler->known, 0, sampler->count * sizeof(bool));
+
+    sampler->stats.status = LIBHACK_OK;
+    sampler->running = true;
+
+    error = pthread_create(&sampler->thread, NULL, libhack_sampler_thread, sampler);
+    if (error != 0)
+    {
+        libhack_err("failed to start sampler thread: %d", error);
+        sampler->running = false;
+        return error;
+    }
+
+    sampler->started = true;
+
+    libhack_debug("sampling %zu addresses of %d every %llu ns", sampler->count,
+                  sampler->handle->pid, (unsigned long long)sampler->period);
+
+    return LIBHACK_OK;
+}
+
+void libhack_sampler_stop(struct libhack_sampler *sampler)
+{
+    if (!sampler || !sampler->started)
+        return;
+
+    __atomic_store_n(&sampler->running, false, __ATOMIC_RELEASE);
+    pthread_join(sampler->thread, NULL);
+
+    sampler->started = false;
+}
+
+void libhack_sampler_get_stats(const struct libhack_sampler *sampler,
+                               struct libhack_sampler_stats *stats)
+{
+    if (!sampler || !stats)
+        return;
+
+    stats->ticks = __atomic_load_n(&sampler->stats.ticks, __ATOMIC_RELAXED);
+    stats->late_ticks = __atomic_load_n(&sampler->stats.late_ticks, __ATOMIC_RELAXED);
+    stats->failed_reads = __atomic_load_n(&sampler->stats.failed_reads, __ATOMIC_RELAXED);
+    stats->status = __atomic_load_n(&sampler->stats.status, __ATOMIC_RELAXED);
+}
+
+struct libhack_sampler_sub *libhack_sampler_subscribe(struct libhack_sampler *sampler,
+                                                      bool changes_only)
+{
+    struct libhack_sampler_sub *sub;
+
+    // Sanity checking
+    libhack_assert_or_return(sampler != NULL, NULL);
+
+    sub = (struct libhack_sampler_sub *)calloc(1, sizeof(struct libhack_sampler_sub));
+    if (!sub)
+        return NULL;
+
+    sub->ring = changes_only ? &sampler->changes : &sampler->all;
+    sub->cursor = __atomic_load_n(&sub->ring->head, __ATOMIC_ACQUIRE);
+
+    return sub;
+}
+
+/**
+ * @brief Moves the cursor of a subscription past the samples already overwritten
+ *
+ * @param sub Subscription
+ * @param head Head of the ring
+ */
+static void libhack_sampler_skip_lost(struct libhack_sampler_sub *sub, uint64_t head)
+{
+    uint64_t size = sub->ring->mask + 1;
+
+    // The oldest slot may be under rewrite by the next sample
+    if (head >= size && sub->cursor < head - size + 1)
+    {
+        sub->missed += head - size + 1 - sub->cursor;
+        sub->cursor = head - size + 1;
+    }
+}
+
+size_t libhack_sampler_read(struct libhack_sampler_sub *sub, struct libhack_sample *samples,
+                            size_t max)
+{
+    uint64_t head;
+    size_t count = 0;
+
+    // Sanity checking
+    libhack_assert_or_return(sub != NULL && samples != NULL, 0);
+
+    head = __atomic_load_n(&sub->ring->head, __ATOMIC_ACQUIRE);
+    libhack_sampler_skip_lost(sub, head);
+
+    while (sub->cursor < head && count < max)
+    {
+        const struct libhack_sample_slot *slot = &sub->ring->slots[sub->cursor & sub->ring->mask];
+        uint64_t words[SAMPLE_WORDS];
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+        for (size_t i = 0; i < SAMPLE_WORDS; i++)
+            words[i] = __atomic_load_n(&slot->words[i], __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (seq != sub->cursor + 1 || __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq)
+        {
+            // Overwritten while it was copied: the producer lapped us
+            head = __atomic_load_n(&sub->ring->head, __ATOMIC_ACQUIRE);
+            libhack_sampler_skip_lost(sub, head);
+            continue;
+        }
+
+        memcpy(&samples[count++], words, sizeof(words));
+        sub->cursor++;
+    }
+
+    return count;
+}
+
+uint64_t libhack_sampler_missed(const struct libhack_sampler_sub *sub)
+{
+    return sub ? sub->missed : 0;
+}
+
+void libhack_sampler_unsubscribe(struct libhack_sampler_sub *sub)
+{
+    free(sub);
+}
+
+void libhack_sampler_free(struct libhack_sampler *sampler)
+{
+    if (!sampler)
+        return;
+
+    libhack_sampler_stop(sampler);
+
+    free(sampler->all.slots);
+    free(sampler->changes.slots);
+    free(sampler->watches);
+    free(sampler->descs);
+    free(sampler->status);
+    free(sampler->values);
+    free(sampler->previous);
+    free(sampler->known);
+    free(sampler);
+}
+
+#endif // __linux__
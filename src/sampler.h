@@ -0,0 +1,240 @@
+/**
+ * @file sampler.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Fixed-rate sampling of a watch list into ring buffers
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_SAMPLER_H
+#define LIBHACK_SAMPLER_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default sampling rate in ticks per second
+ *
+ */
+#define LIBHACK_SAMPLER_RATE 60
+
+/**
+ * @brief Default number of samples kept by each ring buffer
+ *
+ */
+#define LIBHACK_SAMPLER_RING_SIZE 65536
+
+/**
+ * @brief Options of a sampler (zeroed options select the defaults)
+ *
+ */
+struct libhack_sampler_options
+{
+	/**
+	 * @brief Ticks per second (0 uses LIBHACK_SAMPLER_RATE)
+	 *
+	 */
+	unsigned int rate;
+
+	/**
+	 * @brief Samples kept by each ring buffer, rounded up to a power of two
+	 * (0 uses LIBHACK_SAMPLER_RING_SIZE)
+	 *
+	 */
+	size_t ring_size;
+};
+
+/**
+ * @brief Value of a watched address at a tick
+ *
+ */
+struct libhack_sample
+{
+	/**
+	 * @brief Time of the tick in nanoseconds (CLOCK_MONOTONIC)
+	 *
+	 */
+	uint64_t time;
+
+	/**
+	 * @brief Watch returned by libhack_sampler_add
+	 *
+	 */
+	uint32_t watch;
+
+	/**
+	 * @brief Number of bytes of value read from the process
+	 *
+	 */
+	uint32_t size;
+
+	/**
+	 * @brief Bytes read, in the byte order of the process (unused bytes are zero)
+	 *
+	 */
+	uint64_t value;
+};
+
+/**
+ * @brief Statistics of a sampler
+ *
+ */
+struct libhack_sampler_stats
+{
+	/**
+	 * @brief Ticks sampled
+	 *
+	 */
+	uint64_t ticks;
+
+	/**
+	 * @brief Ticks skipped because the sampler fell behind the rate
+	 *
+	 */
+	uint64_t late_ticks;
+
+	/**
+	 * @brief Addresses which could not be read (summed over the ticks)
+	 *
+	 */
+	uint64_t failed_reads;
+
+	/**
+	 * @brief LIBHACK_OK or the error which stopped the sampler
+	 *
+	 */
+	long status;
+};
+
+/**
+ * @brief Thread reading a list of addresses at a fixed rate
+ *
+ * Every tick reads the whole list with a single batched read and appends a
+ * sample per address to a ring buffer, and a sample per changed value to a
+ * second one. Rings never block the sampler: consumers which fall behind
+ * lose the oldest samples.
+ *
+ */
+struct libhack_sampler;
+
+/**
+ * @brief A consumer of the samples of a sampler
+ *
+ * Every subscription sees every sample of its ring from the moment it was
+ * made. A subscription must only be read by one thread at a time.
+ *
+ */
+struct libhack_sampler_sub;
+
+/**
+ * @brief Creates a stopped sampler with an empty watch list
+ *
+ * @param handle Handle to libhack
+ * @param options Options (may be NULL)
+ * @return struct libhack_sampler* Sampler or NULL on error
+ */
+struct libhack_sampler *libhack_sampler_create(struct libhack_handle *handle,
+											   const struct libhack_sampler_options *options);
+
+/**
+ * @brief Adds an address to the watch list (the sampler must be stopped)
+ *
+ * @param sampler Sampler
+ * @param addr Address on the remote process
+ * @param size Number of bytes to be read (1 to 8)
+ * @param watch Receives the index of the watch
+ * @return long LIBHACK_OK on success, EBUSY if the sampler is running or errno value
+ */
+long libhack_sampler_add(struct libhack_sampler *sampler, DWORD64 addr, size_t size,
+						 uint32_t *watch);
+
+/**
+ * @brief Starts the sampling thread
+ *
+ * The first tick reports every value as changed.
+ *
+ * @param sampler Sampler
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_sampler_start(struct libhack_sampler *sampler);
+
+/**
+ * @brief Stops the sampling thread, waiting for the current tick
+ *
+ * @param sampler Sampler
+ */
+void libhack_sampler_stop(struct libhack_sampler *sampler);
+
+/**
+ * @brief Gets the statistics of a sampler
+ *
+ * @param sampler Sampler
+ * @param stats Receives the statistics
+ */
+void libhack_sampler_get_stats(const struct libhack_sampler *sampler,
+							   struct libhack_sampler_stats *stats);
+
+/**
+ * @brief Subscribes to the samples of a sampler
+ *
+ * @param sampler Sampler
+ * @param changes_only true to receive only the values which changed since the previous tick
+ * @return struct libhack_sampler_sub* Subscription or NULL on error
+ */
+struct libhack_sampler_sub *libhack_sampler_subscribe(struct libhack_sampler *sampler,
+													  bool changes_only);
+
+/**
+ * @brief Takes the samples appended since the last read, oldest first
+ *
+ * @param sub Subscription
+ * @param samples Receives the samples
+ * @param max Capacity of samples (samples left are returned by the next read)
+ * @return size_t Number of samples stored in samples
+ */
+size_t libhack_sampler_read(struct libhack_sampler_sub *sub, struct libhack_sample *samples,
+							size_t max);
+
+/**
+ * @brief Gets the number of samples overwritten before the subscription read them
+ *
+ * @param sub Subscription
+ * @return uint64_t Number of samples missed so far
+ */
+uint64_t libhack_sampler_missed(const struct libhack_sampler_sub *sub);
+
+/**
+ * @brief Releases a subscription
+ *
+ * @param sub Subscription
+ */
+void libhack_sampler_unsubscribe(struct libhack_sampler_sub *sub);
+
+/**
+ * @brief Stops a sampler and releases it (subscriptions must be released first)
+ *
+ * @param sampler Sampler
+ */
+void libhack_sampler_free(struct libhack_sampler *sampler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_SAMPLER_H
@@ -0,0 +1,743 @@
+/**
+ * @file scan.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Multithreaded value scanner
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "compare.h"
+#include "logger.h"
+#include "maps.h"
+#include "pagemap.h"
+#include "process.h"
+#include "scan.h"
+#include "status_codes.h"
+
+/**
+ * @brief A piece of a region scanned by a single worker
+ *
+ */
+struct libhack_scan_chunk
+{
+	/**
+	 * @brief First address of the chunk
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Number of candidate bytes of the chunk
+	 *
+	 */
+	size_t len;
+
+	/**
+	 * @brief Number of bytes to be read (len plus the overlap with the next chunk)
+	 *
+	 */
+	size_t read_len;
+};
+
+/**
+ * @brief A region to be scanned and its accesses in the heatmap
+ *
+ */
+struct libhack_scan_region_heat
+{
+	/**
+	 * @brief Index of the region in the region table
+	 *
+	 */
+	size_t region;
+
+	/**
+	 * @brief Accessed pages (SIZE_MAX if the heatmap does not know the region)
+	 *
+	 */
+	size_t accesses;
+};
+
+/**
+ * @brief State shared by every worker of a scan
+ *
+ */
+struct libhack_scan_job
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Comparison against the searched value
+	 *
+	 */
+	struct libhack_compare compare;
+
+	/**
+	 * @brief Distance between candidate addresses
+	 *
+	 */
+	size_t alignment;
+
+	/**
+	 * @brief Chunks to be scanned
+	 *
+	 */
+	struct libhack_scan_chunk *chunks;
+
+	/**
+	 * @brief Number of chunks
+	 *
+	 */
+	size_t chunk_count;
+
+	/**
+	 * @brief Index of the next chunk to be taken by a worker
+	 *
+	 */
+	size_t next_chunk;
+
+	/**
+	 * @brief Size of the biggest chunk read
+	 *
+	 */
+	size_t max_read_len;
+};
+
+/**
+ * @brief A worker thread and the addresses it found
+ *
+ */
+struct libhack_scan_worker
+{
+	/**
+	 * @brief Worker thread
+	 *
+	 */
+	pthread_t thread;
+
+	/**
+	 * @brief Shared scan state
+	 *
+	 */
+	struct libhack_scan_job *job;
+
+	/**
+	 * @brief Addresses found by this worker
+	 *
+	 */
+	DWORD64 *addrs;
+
+	/**
+	 * @brief Number of addresses found
+	 *
+	 */
+	size_t count;
+
+	/**
+	 * @brief Capacity of addrs
+	 *
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief LIBHACK_OK or the error which stopped the worker
+	 *
+	 */
+	long status;
+};
+
+static bool libhack_scan_push(struct libhack_scan_worker *worker, DWORD64 addr)
+{
+    if (worker->count == worker->capacity)
+    {
+        size_t capacity = worker->capacity ? worker->capacity * 2 : 1024;
+        DWORD64 *addrs = (DWORD64 *)realloc(worker->addrs, capacity * sizeof(DWORD64));
+
+        if (!addrs)
+            return false;
+
+        worker->addrs = addrs;
+        worker->capacity = capacity;
+    }
+
+    worker->addrs[worker->count++] = addr;
+
+    return true;
+}
+
+/**
+ * @brief Checks if a value read from a chunk lies on an unreadable page
+ *
+ * @param chunk Chunk
+ * @param offset Offset of the value into the chunk
+ * @param size Size of the value
+ * @param bad_pages Bitmap returned by libhack_read_bytes
+ * @return bool true if any byte of the value could not be read
+ */
+static bool libhack_scan_on_bad_page(const struct libhack_scan_chunk *chunk, size_t offset,
+                                     size_t size, const unsigned char *bad_pages)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    DWORD64 first_page = chunk->addr & ~((DWORD64)page - 1);
+    size_t first = (size_t)((chunk->addr + offset - first_page) / page);
+    size_t last = (size_t)((chunk->addr + offset + size - 1 - first_page) / page);
+
+    for (size_t i = first; i <= last; i++)
+    {
+        if (bad_pages[i / 8] & (1 << (i % 8)))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Compares the bytes of a chunk against the searched value
+ *
+ * @param worker Worker
+ * @param chunk Chunk
+ * @param buffer Bytes of the chunk
+ * @param bad_pages Pages that could not be read (NULL if every page was read)
+ * @param mask Scratch bitmap with one bit per candidate offset of the chunk
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_scan_compare(struct libhack_scan_worker *worker,
+                                 const struct libhack_scan_chunk *chunk,
+                                 const unsigned char *buffer,
+                                 const unsigned char *bad_pages,
+                                 uint64_t *mask)
+{
+    const struct libhack_scan_job *job = worker->job;
+    size_t size = libhack_value_size(job->compare.type);
+    size_t count;
+
+    if (chunk->read_len < size)
+        return LIBHACK_OK;
+
+    // Candidate offsets lie inside the chunk and their value was fully read
+    count = (chunk->read_len - size) / job->alignment + 1;
+    if (count > (chunk->len + job->alignment - 1) / job->alignment)
+        count = (chunk->len + job->alignment - 1) / job->alignment;
+
+    if (libhack_compare_block(&job->compare, buffer, count, job->alignment, mask) == 0)
+        return LIBHACK_OK;
+
+    for (size_t word = 0; word < (count + 63) / 64; word++)
+    {
+        uint64_t bits = mask[word];
+
+        while (bits)
+        {
+            size_t offset = (word * 64 + (size_t)__builtin_ctzll(bits)) * job->alignment;
+            bits &= bits - 1;
+
+            if (bad_pages && libhack_scan_on_bad_page(chunk, offset, size, bad_pages))
+                continue;
+
+            if (!libhack_scan_push(worker, chunk->addr + offset))
+                return ENOMEM;
+        }
+    }
+
+    return LIBHACK_OK;
+}
+
+static void *libhack_scan_thread(void *arg)
+{
+    struct libhack_scan_worker *worker = (struct libhack_scan_worker *)arg;
+    struct libhack_scan_job *job = worker->job;
+    unsigned char *buffer;
+    unsigned char *bad_pages;
+    uint64_t *mask;
+
+    buffer = (unsigned char *)malloc(job->max_read_len);
+    bad_pages = (unsigned char *)malloc(libhack_page_bitmap_size(0, job->max_read_len) + 1);
+    mask = (uint64_t *)malloc((job->max_read_len / job->alignment / 64 + 1) * sizeof(uint64_t));
+
+    if (!buffer || !bad_pages || !mask)
+    {
+        worker->status = ENOMEM;
+        free(buffer);
+        free(bad_pages);
+        free(mask);
+        return NULL;
+    }
+
+    for (;;)
+    {
+        size_t index = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (index >= job->chunk_count)
+            break;
+
+        const struct libhack_scan_chunk *chunk = &job->chunks[index];
+
+        long status = libhack_read_bytes(job->handle, chunk->addr, buffer,
+                                         chunk->read_len, bad_pages);
+
+        // Regions may vanish while they are scanned: only stop if the process is gone
+        if (status != LIBHACK_OK && status != EFAULT)
+        {
+            if (status == ESRCH)
+            {
+                worker->status = status;
+                break;
+            }
+
+            continue;
+        }
+
+        status = libhack_scan_compare(worker, chunk, buffer,
+                                      status == EFAULT ? bad_pages : NULL, mask);
+        if (status != LIBHACK_OK)
+        {
+            worker->status = status;
+            break;
+        }
+    }
+
+    free(buffer);
+    free(bad_pages);
+    free(mask);
+
+    return NULL;
+}
+
+/**
+ * @brief Checks if a region must be scanned
+ *
+ * @param region Region
+ * @param options Scan options
+ * @return bool true if the region must be scanned
+ */
+static bool libhack_scan_region_wanted(const struct libhack_region *region,
+                                       const struct libhack_scan_options *options)
+{
+    if (!libhack_region_readable(region))
+        return false;
+
+    return !options->writable_only || region->perms[1] == 'w';
+}
+
+/**
+ * @brief Appends the chunks covering a range
+ *
+ * @param job Scan job
+ * @param capacity Capacity of job->chunks
+ * @param start First address of the range
+ * @param end End of the range
+ * @param read_end Reads of values crossing the end of the range stop here
+ * @param chunk_size Size of every chunk
+ * @param value_size Size of the value
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_scan_add_range(struct libhack_scan_job *job, size_t *capacity, DWORD64 start,
+                                   DWORD64 end, DWORD64 read_end, size_t chunk_size,
+                                   size_t value_size)
+{
+    for (DWORD64 addr = start; addr < end; addr += chunk_size)
+    {
+        struct libhack_scan_chunk *chunk;
+        size_t left = (size_t)(end - addr);
+
+        if (job->chunk_count == *capacity)
+        {
+            size_t new_capacity = *capacity ? *capacity * 2 : 256;
+            struct libhack_scan_chunk *chunks = (struct libhack_scan_chunk *)realloc(
+                job->chunks, new_capacity * sizeof(struct libhack_scan_chunk));
+
+            if (!chunks)
+                return ENOMEM;
+
+            job->chunks = chunks;
+            *capacity = new_capacity;
+        }
+
+        chunk = &job->chunks[job->chunk_count++];
+        chunk->addr = addr;
+        chunk->len = left < chunk_size ? left : chunk_size;
+
+        // Values crossing into the next chunk are still found
+        chunk->read_len = chunk->len + value_size - 1;
+        if (chunk->read_len > (size_t)(read_end - addr))
+            chunk->read_len = (size_t)(read_end - addr);
+
+        if (chunk->read_len > job->max_read_len)
+            job->max_read_len = chunk->read_len;
+    }
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Checks if the pages of a region can be filtered through pagemap
+ *
+ * A page of a file or shared mapping that is not mapped by the process may
+ * still hold data, so only private anonymous regions are filtered.
+ *
+ * @param region Region
+ * @return bool true if non-present pages of the region can only hold zeros
+ */
+static bool libhack_scan_region_filtered(const struct libhack_region *region)
+{
+    if (region->inode != 0 || region->perms[3] != 'p')
+        return false;
+
+    // [vdso] and friends are not ordinary anonymous memory
+    return strncmp(region->pathname, "[v", 2) != 0;
+}
+
+/**
+ * @brief Appends the chunks of a region, leaving out the pages to be skipped
+ *
+ * @param handle Handle to libhack
+ * @param region Region
+ * @param options Scan options
+ * @param value_size Size of the value
+ * @param job Scan job
+ * @param capacity Capacity of job->chunks
+ * @param skipped Incremented by the number of pages left out
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_scan_add_region(struct libhack_handle *handle,
+                                    const struct libhack_region *region,
+                                    const struct libhack_scan_options *options, size_t value_size,
+                                    struct libhack_scan_job *job, size_t *capacity,
+                                    size_t *skipped)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uint64_t entries[LIBHACK_PAGEMAP_BATCH];
+    DWORD64 run = 0;
+    bool in_run = false;
+    long status;
+
+    if ((!options->resident_only && !options->skip_swapped) ||
+        !libhack_scan_region_filtered(region))
+        return libhack_scan_add_range(job, capacity, region->start, region->end, region->end,
+                                      options->chunk_size, value_size);
+
+    for (DWORD64 addr = region->start; addr < region->end; addr += LIBHACK_PAGEMAP_BATCH * page)
+    {
+        size_t count = (size_t)((region->end - addr) / page);
+
+        if (count > LIBHACK_PAGEMAP_BATCH)
+            count = LIBHACK_PAGEMAP_BATCH;
+
+        // Without pagemap every page is scanned
+        if (libhack_pagemap_read(handle, addr, count, entries) != LIBHACK_OK)
+        {
+            for (size_t i = 0; i < count; i++)
+                entries[i] = LIBHACK_PAGEMAP_PRESENT;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            DWORD64 page_addr = addr + i * page;
+            bool swapped = (entries[i] & LIBHACK_PAGEMAP_SWAPPED) != 0;
+            bool untouched = !(entries[i] & LIBHACK_PAGEMAP_PRESENT) ||
+                             libhack_pagemap_is_zero_page(entries[i]);
+            bool keep = swapped ? !options->skip_swapped : !untouched || !options->resident_only;
+
+            if (keep && !in_run)
+            {
+                run = page_addr;
+                in_run = true;
+            }
+            else if (!keep && in_run)
+            {
+                // Untouched pages read as zeros without being allocated, swapped ones would be
+                // brought back in
+                status = libhack_scan_add_range(job, capacity, run, page_addr,
+                                                swapped ? page_addr : region->end,
+                                                options->chunk_size, value_size);
+                if (status != LIBHACK_OK)
+                    return status;
+
+                in_run = false;
+            }
+
+            if (!keep)
+                (*skipped)++;
+        }
+    }
+
+    if (in_run)
+        return libhack_scan_add_range(job, capacity, run, region->end, region->end,
+                                      options->chunk_size, value_size);
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Gets the accesses recorded by the heatmap for a region
+ *
+ * @param heatmap Heatmap
+ * @param region Region
+ * @return size_t Accessed pages or SIZE_MAX if the heatmap has no sampled page of the region
+ */
+static size_t libhack_scan_region_accesses(const struct libhack_heatmap *heatmap,
+                                           const struct libhack_region *region)
+{
+    const struct libhack_heatmap_region *heat = libhack_heatmap_find(heatmap, region->start);
+
+    // Regions mapped after the last sample or holding only shared pages are unknown
+    if (!heat || heat->start != region->start || heat->end != region->end || heat->sampled == 0)
+        return SIZE_MAX;
+
+    return heat->accessed;
+}
+
+static int libhack_scan_heat_compare(const void *a, const void *b)
+{
+    const struct libhack_scan_region_heat *x = (const struct libhack_scan_region_heat *)a;
+    const struct libhack_scan_region_heat *y = (const struct libhack_scan_region_heat *)b;
+
+    // Hottest first, then by address
+    if (x->accesses != y->accesses)
+        return x->accesses > y->accesses ? -1 : 1;
+
+    return (x->region > y->region) - (x->region < y->region);
+}
+
+/**
+ * @brief Splits the wanted regions in chunks
+ *
+ * @param handle Handle to libhack
+ * @param maps Region table
+ * @param options Scan options
+ * @param value_size Size of the value
+ * @param job Receives the chunks
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_scan_build_chunks(struct libhack_handle *handle,
+                                      const struct libhack_maps *maps,
+                                      const struct libhack_scan_options *options,
+                                      size_t value_size, struct libhack_scan_job *job)
+{
+    struct libhack_scan_region_heat *order;
+    size_t capacity = 0;
+    size_t skipped = 0;
+    size_t cold = 0;
+    size_t count = 0;
+    long status = LIBHACK_OK;
+
+    job->chunks = NULL;
+    job->chunk_count = 0;
+    job->max_read_len = 0;
+
+    order = (struct libhack_scan_region_heat *)malloc((maps->count + 1) *
+                                                      sizeof(struct libhack_scan_region_heat));
+    if (!order)
+        return ENOMEM;
+
+    for (size_t i = 0; i < maps->count; i++)
+    {
+        const struct libhack_region *region = &maps->regions[i];
+        size_t accesses = 0;
+
+        if (!libhack_scan_region_wanted(region, options))
+            continue;
+
+        if (options->heatmap)
+        {
+            accesses = libhack_scan_region_accesses(options->heatmap, region);
+            if (accesses < options->min_accesses)
+            {
+                cold++;
+                continue;
+            }
+        }
+
+        order[count].region = i;
+        order[count].accesses = accesses;
+        count++;
+    }
+
+    if (options->heatmap)
+        qsort(order, count, sizeof(struct libhack_scan_region_heat), libhack_scan_heat_compare);
+
+    for (size_t i = 0; i < count && status == LIBHACK_OK; i++)
+        status = libhack_scan_add_region(handle, &maps->regions[order[i].region], options,
+                                         value_size, job, &capacity, &skipped);
+
+    free(order);
+
+    if (status != LIBHACK_OK)
+    {
+        free(job->chunks);
+        job->chunks = NULL;
+        return status;
+    }
+
+    if (cold > 0)
+        libhack_debug("scan skips %zu regions below %zu accesses", cold, options->min_accesses);
+
+    if (skipped > 0)
+        libhack_debug("scan skips %zu pages which are not resident", skipped);
+
+    return LIBHACK_OK;
+}
+
+static int libhack_scan_addr_compare(const void *a, const void *b)
+{
+    DWORD64 x = *(const DWORD64 *)a;
+    DWORD64 y = *(const DWORD64 *)b;
+
+    return (x > y) - (x < y);
+}
+
+long libhack_scan_exact(struct libhack_handle *handle, enum libhack_value_type type,
+                        const void *value, const struct libhack_scan_options *options,
+                        struct libhack_scan_result *result)
+{
+    struct libhack_scan_options opts;
+    struct libhack_scan_worker *workers;
+    struct libhack_scan_job job;
+    const struct libhack_maps *maps;
+    size_t value_size = libhack_value_size(type);
+    size_t started = 0;
+    size_t total = 0;
+    long status = LIBHACK_OK;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && value != NULL && result != NULL && value_size > 0, -1);
+
+    memset(result, 0, sizeof(*result));
+    memset(&opts, 0, sizeof(opts));
+    if (options)
+        opts = *options;
+
+    if (opts.threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        opts.threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+
+    if (opts.alignment == 0)
+        opts.alignment = value_size;
+
+    if (opts.chunk_size == 0)
+        opts.chunk_size = LIBHACK_SCAN_CHUNK;
+
+    // Scan the current memory layout
+    if (libhack_maps_update(handle, NULL) != LIBHACK_OK)
+        return ESRCH;
+
+    maps = libhack_get_maps(handle);
+    if (!maps)
+        return ESRCH;
+
+    memset(&job, 0, sizeof(job));
+    job.handle = handle;
+    job.alignment = opts.alignment;
+    job.compare.type = type;
+    job.compare.op = LIBHACK_CMP_EQ;
+    memcpy(&job.compare.a, value, value_size);
+
+    status = libhack_scan_build_chunks(handle, maps, &opts, value_size, &job);
+    if (status != LIBHACK_OK)
+        return status;
+
+    if (job.chunk_count == 0)
+        return LIBHACK_OK;
+
+    if (opts.threads > job.chunk_count)
+        opts.threads = job.chunk_count ? job.chunk_count : 1;
+
+    workers = (struct libhack_scan_worker *)calloc(opts.threads, sizeof(struct libhack_scan_worker));
+    if (!workers)
+    {
+        free(job.chunks);
+        return ENOMEM;
+    }
+
+    for (size_t i = 0; i < opts.threads; i++)
+    {
+        workers[i].job = &job;
+
+        if (pthread_create(&workers[i].thread, NULL, libhack_scan_thread, &workers[i]) != 0)
+        {
+            libhack_err("failed to start scan worker %zu: %d", i, errno);
+            break;
+        }
+
+        started++;
+    }
+
+    // The calling thread takes part if no worker could be started
+    if (started == 0)
+    {
+        libhack_scan_thread(&workers[0]);
+    }
+
+    for (size_t i = 0; i < started; i++)
+        pthread_join(workers[i].thread, NULL);
+
+    for (size_t i = 0; i < opts.threads; i++)
+    {
+        total += workers[i].count;
+
+        if (workers[i].status != LIBHACK_OK && status == LIBHACK_OK)
+            status = workers[i].status;
+    }
+
+    if (status == LIBHACK_OK && total > 0)
+    {
+        result->addrs = (DWORD64 *)malloc(total * sizeof(DWORD64));
+        if (!result->addrs)
+        {
+            status = ENOMEM;
+        }
+        else
+        {
+            for (size_t i = 0; i < opts.threads; i++)
+            {
+                memcpy(result->addrs + result->count, workers[i].addrs,
+                       workers[i].count * sizeof(DWORD64));
+                result->count += workers[i].count;
+            }
+
+            qsort(result->addrs, result->count, sizeof(DWORD64), libhack_scan_addr_compare);
+        }
+    }
+
+    for (size_t i = 0; i < opts.threads; i++)
+        free(workers[i].addrs);
+
+    free(workers);
+    free(job.chunks);
+
+    libhack_debug("scan found %zu addresses on %d", result->count, handle->pid);
+
+    return status;
+}
+
+void libhack_scan_result_free(struct libhack_scan_result *result)
+{
+    if (!result)
+        return;
+
+    free(result->addrs);
+    result->addrs = NULL;
+    result->count = 0;
+}
+
+#endif // __linux__
@@ -0,0 +1,138 @@
+/**
+ * @file scan.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Multithreaded value scanner
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_SCAN_H
+#define LIBHACK_SCAN_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "compare.h"
+#include "heatmap.h"
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Options of a scan (zeroed options select the defaults)
+ *
+ */
+struct libhack_scan_options
+{
+	/**
+	 * @brief Number of worker threads (0 uses one per online CPU)
+	 *
+	 */
+	size_t threads;
+
+	/**
+	 * @brief Distance between candidate addresses (0 uses the size of the value)
+	 *
+	 */
+	size_t alignment;
+
+	/**
+	 * @brief Bytes read and compared at once by a worker (0 uses LIBHACK_SCAN_CHUNK)
+	 *
+	 */
+	size_t chunk_size;
+
+	/**
+	 * @brief Scan only writable regions
+	 *
+	 */
+	bool writable_only;
+
+	/**
+	 * @brief Skip pages of private anonymous regions that the process never wrote to
+	 * (they can only hold zeros)
+	 *
+	 */
+	bool resident_only;
+
+	/**
+	 * @brief Skip swapped out pages, so the scan does not bring them back into memory
+	 *
+	 */
+	bool skip_swapped;
+
+	/**
+	 * @brief Heatmap giving the order of the regions, hottest first (may be NULL)
+	 *
+	 */
+	const struct libhack_heatmap *heatmap;
+
+	/**
+	 * @brief Skip regions with fewer accessed pages in the heatmap
+	 * (regions it has not sampled are kept and scanned first)
+	 *
+	 */
+	size_t min_accesses;
+};
+
+/**
+ * @brief Sorted list of matching addresses
+ *
+ */
+struct libhack_scan_result
+{
+	/**
+	 * @brief Matching addresses
+	 *
+	 */
+	DWORD64 *addrs;
+
+	/**
+	 * @brief Number of matching addresses
+	 *
+	 */
+	size_t count;
+};
+
+/**
+ * @brief Scans every readable region for an exact value
+ *
+ * Regions are split in chunks which are read and compared by a pool of
+ * worker threads. With resident_only or skip_swapped, /proc/<pid>/pagemap is
+ * read first and chunks only cover the pages that must be scanned. With a
+ * heatmap, workers take the chunks of the most accessed regions first.
+ *
+ * @param handle Handle to libhack
+ * @param type Type of value
+ * @param value Pointer to the value to be searched
+ * @param options Scan options (may be NULL)
+ * @param result Receives the matching addresses (release with libhack_scan_result_free)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_scan_exact(struct libhack_handle *handle, enum libhack_value_type type,
+						const void *value, const struct libhack_scan_options *options,
+						struct libhack_scan_result *result);
+
+/**
+ * @brief Releases the addresses of a scan result
+ *
+ * @param result Scan result
+ */
+void libhack_scan_result_free(struct libhack_scan_result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_SCAN_H
@@ -0,0 +1,1662 @@
+/**
+ * @file signature.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Byte signature (array of bytes) scanning
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "compare.h"
+#include "image.h"
+#include "logger.h"
+#include "maps.h"
+#include "pagemap.h"
+#include "process.h"
+#include "signature.h"
+#include "status_codes.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LIBHACK_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Average shift from which the skip table beats the SIMD prefilter
+ *
+ */
+#define SIGNATURE_SKIP_THRESHOLD 16
+
+struct libhack_signature
+{
+	/**
+	 * @brief Expected bytes, already masked
+	 *
+	 */
+	unsigned char *bytes;
+
+	/**
+	 * @brief Bits of each byte that must match
+	 *
+	 */
+	unsigned char *mask;
+
+	/**
+	 * @brief Number of bytes
+	 *
+	 */
+	size_t length;
+
+	/**
+	 * @brief Offset of the rarest fully known byte
+	 *
+	 */
+	size_t anchor;
+
+	/**
+	 * @brief Offset of the second rarest fully known byte (anchor if there is only one)
+	 *
+	 */
+	size_t second;
+
+	/**
+	 * @brief Search with the skip table instead of the prefilter
+	 *
+	 */
+	bool use_skip;
+
+	/**
+	 * @brief Horspool shift for each value of the last byte of the window
+	 *
+	 */
+	size_t shift[256];
+};
+
+/**
+ * @brief Callback receiving the offset of each match
+ *
+ * @return bool false to stop the search
+ */
+typedef bool (*libhack_signature_hit)(void *ctx, size_t offset);
+
+/**
+ * @brief Rough frequency of a byte in x86 machine code and data
+ *
+ * @param byte Byte value
+ * @return int Higher values are more common
+ */
+static int libhack_signature_byte_rank(unsigned char byte)
+{
+    switch (byte)
+    {
+    case 0x00:
+        return 255;
+    case 0xFF:
+        return 200;
+    case 0xCC:
+        return 180;
+    case 0x48:
+        return 170;
+    case 0x8B:
+        return 160;
+    case 0x89:
+        return 150;
+    case 0x24:
+    case 0x4C:
+        return 120;
+    case 0x0F:
+    case 0x83:
+        return 110;
+    case 0x85:
+    case 0x8D:
+    case 0xE8:
+        return 100;
+    case 0x01:
+        return 90;
+    case 0x41:
+    case 0x74:
+    case 0x75:
+    case 0xC3:
+        return 80;
+    case 0x44:
+    case 0x90:
+        return 70;
+    case 0x45:
+    case 0x49:
+    case 0xC0:
+        return 60;
+    case 0x08:
+    case 0x10:
+    case 0x20:
+    case 0x40:
+    case 0x80:
+        return 50;
+    }
+
+    return 10;
+}
+
+static int libhack_signature_nibble(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+
+    c = (char)tolower((unsigned char)c);
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    return -1;
+}
+
+static inline bool libhack_signature_verify(const struct libhack_signature *sig,
+                                            const unsigned char *buffer)
+{
+    for (size_t i = 0; i < sig->length; i++)
+    {
+        if ((buffer[i] & sig->mask[i]) != sig->bytes[i])
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Chooses the search strategy and builds the skip table
+ *
+ * @param sig Signature
+ */
+static void libhack_signature_prepare(struct libhack_signature *sig)
+{
+    size_t m = sig->length;
+    size_t total = 0;
+    int best = 1000;
+    int next = 1000;
+
+    // The two rarest known bytes drive the prefilter
+    for (size_t i = 0; i < m; i++)
+    {
+        int rank;
+
+        if (sig->mask[i] != 0xFF)
+            continue;
+
+        rank = libhack_signature_byte_rank(sig->bytes[i]);
+        if (rank < best)
+        {
+            if (best < 1000)
+            {
+                next = best;
+                sig->second = sig->anchor;
+            }
+
+            best = rank;
+            sig->anchor = i;
+        }
+        else if (rank < next)
+        {
+            next = rank;
+            sig->second = i;
+        }
+    }
+
+    if (next == 1000)
+        sig->second = sig->anchor;
+
+    // Horspool: distance from the last window byte to its rightmost possible match
+    for (size_t b = 0; b < 256; b++)
+    {
+        sig->shift[b] = m;
+
+        for (size_t i = 0; i + 1 < m; i++)
+        {
+            if (((unsigned char)b & sig->mask[i]) == sig->bytes[i])
+                sig->shift[b] = m - 1 - i;
+        }
+
+        total += sig->shift[b];
+    }
+
+    sig->use_skip = total / 256 >= SIGNATURE_SKIP_THRESHOLD;
+}
+
+struct libhack_signature *libhack_signature_compile(const char *pattern)
+{
+    struct libhack_signature *sig;
+    size_t capacity;
+    bool known = false;
+
+    // Sanity checking
+    libhack_assert_or_return(pattern != NULL, NULL);
+
+    sig = (struct libhack_signature *)calloc(1, sizeof(struct libhack_signature));
+    if (!sig)
+        return NULL;
+
+    // Every byte takes at least two characters including its separator
+    capacity = strlen(pattern) / 2 + 1;
+    sig->bytes = (unsigned char *)malloc(capacity);
+    sig->mask = (unsigned char *)malloc(capacity);
+    if (!sig->bytes || !sig->mask)
+    {
+        libhack_signature_free(sig);
+        return NULL;
+    }
+
+    for (const char *p = pattern; *p;)
+    {
+        unsigned char value = 0;
+        unsigned char mask = 0;
+        size_t len = 0;
+
+        if (isspace((unsigned char)*p))
+        {
+            p++;
+            continue;
+        }
+
+        while (p[len] && !isspace((unsigned char)p[len]))
+            len++;
+
+        if (len == 1 && p[0] == '?')
+        {
+            // Single question mark matches a whole byte
+        }
+        else if (len == 2)
+        {
+            for (size_t n = 0; n < 2; n++)
+            {
+                int nibble = libhack_signature_nibble(p[n]);
+
+                if (p[n] == '?')
+                    continue;
+
+                if (nibble < 0)
+                {
+                    len = 0;
+                    break;
+                }
+
+                value |= (unsigned char)(nibble << (n == 0 ? 4 : 0));
+                mask |= (unsigned char)(n == 0 ? 0xF0 : 0x0F);
+            }
+        }
+        else
+        {
+            len = 0;
+        }
+
+        if (len == 0)
+        {
+            libhack_err("invalid byte in signature: %s", pattern);
+            libhack_signature_free(sig);
+            return NULL;
+        }
+
+        known |= mask == 0xFF;
+        sig->bytes[sig->length] = value;
+        sig->mask[sig->length] = mask;
+        sig->length++;
+        p += len;
+    }
+
+    if (!known)
+    {
+        libhack_err("signature has no fully known byte: %s", pattern);
+        libhack_signature_free(sig);
+        return NULL;
+    }
+
+    libhack_signature_prepare(sig);
+
+    return sig;
+}
+
+size_t libhack_signature_length(const struct libhack_signature *sig)
+{
+    return sig ? sig->length : 0;
+}
+
+bool libhack_signature_match(const struct libhack_signature *sig, const unsigned char *buffer)
+{
+    if (!sig || !buffer)
+        return false;
+
+    return libhack_signature_verify(sig, buffer);
+}
+
+static size_t libhack_signature_search_skip(const struct libhack_signature *sig,
+                                            const unsigned char *buffer, size_t len,
+                                            libhack_signature_hit hit, void *ctx)
+{
+    size_t m = sig->length;
+    size_t found = 0;
+
+    for (size_t pos = 0; pos + m <= len; pos += sig->shift[buffer[pos + m - 1]])
+    {
+        if (!libhack_signature_verify(sig, buffer + pos))
+            continue;
+
+        found++;
+        if (!hit(ctx, pos))
+            break;
+    }
+
+    return found;
+}
+
+/**
+ * @brief Scalar prefilter, also used for the tail of the SIMD ones
+ *
+ */
+static size_t libhack_signature_search_scalar(const struct libhack_signature *sig,
+                                              const unsigned char *buffer, size_t start,
+                                              size_t len, libhack_signature_hit hit, void *ctx)
+{
+    const unsigned char a = sig->bytes[sig->anchor];
+    const unsigned char b = sig->bytes[sig->second];
+    size_t found = 0;
+
+    for (size_t pos = start; pos + sig->length <= len; pos++)
+    {
+        if (buffer[pos + sig->anchor] != a || buffer[pos + sig->second] != b)
+            continue;
+
+        if (!libhack_signature_verify(sig, buffer + pos))
+            continue;
+
+        found++;
+        if (!hit(ctx, pos))
+            break;
+    }
+
+    return found;
+}
+
+#ifdef LIBHACK_X86
+
+#define DEFINE_PREFILTER(NAME, ATTR, VTYPE, WIDTH, LOAD, SET1, CMPEQ, AND, MOVEMASK)       \
+    static ATTR size_t NAME(const struct libhack_signature *sig, const unsigned char *buffer, \
+                            size_t len, libhack_signature_hit hit, void *ctx)               \
+    {                                                                                       \
+        const VTYPE a = SET1((char)sig->bytes[sig->anchor]);                                \
+        const VTYPE b = SET1((char)sig->bytes[sig->second]);                                \
+        size_t found = 0;                                                                   \
+        size_t pos = 0;                                                                     \
+                                                                                            \
+        for (; pos + sig->length + WIDTH - 1 <= len; pos += WIDTH)                          \
+        {                                                                                   \
+            VTYPE va = LOAD((const VTYPE *)(buffer + pos + sig->anchor));                   \
+            VTYPE vb = LOAD((const VTYPE *)(buffer + pos + sig->second));                   \
+            uint32_t bits = (uint32_t)MOVEMASK(AND(CMPEQ(va, a), CMPEQ(vb, b)));            \
+                                                                                            \
+            while (bits)                                                                    \
+            {                                                                               \
+                size_t at = pos + (size_t)__builtin_ctz(bits);                              \
+                bits &= bits - 1;                                                           \
+                                                                                            \
+                if (!libhack_signature_verify(sig, buffer + at))                            \
+                    continue;                                                               \
+                                                                                            \
+                found++;                                                                    \
+                if (!hit(ctx, at))                                                          \
+                    return found;                                                           \
+            }                                                                               \
+        }                                                                                   \
+                                                                                            \
+        return found + libhack_signature_search_scalar(sig, buffer, pos, len, hit, ctx);    \
+    }
+
+DEFINE_PREFILTER(libhack_signature_search_sse2, , __m128i, 16, _mm_loadu_si128, _mm_set1_epi8,
+                 _mm_cmpeq_epi8, _mm_and_si128, _mm_movemask_epi8)
+
+DEFINE_PREFILTER(libhack_signature_search_avx2, __attribute__((target("avx2"))), __m256i, 32,
+                 _mm256_loadu_si256, _mm256_set1_epi8, _mm256_cmpeq_epi8, _mm256_and_si256,
+                 _mm256_movemask_epi8)
+
+#endif // LIBHACK_X86
+
+/**
+ * @brief Runs the search strategy chosen for a signature
+ *
+ * @param sig Signature
+ * @param buffer Buffer to be searched
+ * @param len Size of buffer
+ * @param hit Callback receiving each match
+ * @param ctx Argument of the callback
+ * @return size_t Number of matches
+ */
+static size_t libhack_signature_run(const struct libhack_signature *sig, const unsigned char *buffer,
+                                    size_t len, libhack_signature_hit hit, void *ctx)
+{
+    if (len < sig->length)
+        return 0;
+
+    if (sig->use_skip)
+        return libhack_signature_search_skip(sig, buffer, len, hit, ctx);
+
+#ifdef LIBHACK_X86
+    if (libhack_simd_detect() >= LIBHACK_SIMD_AVX2)
+        return libhack_signature_search_avx2(sig, buffer, len, hit, ctx);
+
+    return libhack_signature_search_sse2(sig, buffer, len, hit, ctx);
+#else
+    return libhack_signature_search_scalar(sig, buffer, 0, len, hit, ctx);
+#endif
+}
+
+/**
+ * @brief Matches collected by libhack_signature_search
+ *
+ */
+struct libhack_signature_array
+{
+	/**
+	 * @brief Receives the offsets (may be NULL)
+	 *
+	 */
+	size_t *offsets;
+
+	/**
+	 * @brief Capacity of offsets
+	 *
+	 */
+	size_t max;
+
+	/**
+	 * @brief Number of matches found
+	 *
+	 */
+	size_t count;
+};
+
+static bool libhack_signature_collect(void *ctx, size_t offset)
+{
+    struct libhack_signature_array *array = (struct libhack_signature_array *)ctx;
+
+    if (array->offsets && array->count < array->max)
+        array->offsets[array->count] = offset;
+
+    array->count++;
+
+    return true;
+}
+
+size_t libhack_signature_search(const struct libhack_signature *sig, const unsigned char *buffer,
+                                size_t len, size_t *offsets, size_t max)
+{
+    struct libhack_signature_array array = {offsets, max, 0};
+
+    if (!sig || !buffer)
+        return 0;
+
+    libhack_signature_run(sig, buffer, len, libhack_signature_collect, &array);
+
+    return array.count;
+}
+
+/**
+ * @brief Callback searching a chunk read from the process
+ *
+ * @param ctx Argument of the callback
+ * @param addr Address of the chunk
+ * @param buffer Bytes of the chunk
+ * @param len Size of buffer
+ * @param limit Matches must start before this offset (the rest is overlap)
+ * @param bad_pages Pages that could not be read (NULL if every page was read)
+ * @return bool false to stop the scan
+ */
+typedef bool (*libhack_signature_chunk)(void *ctx, DWORD64 addr, const unsigned char *buffer,
+                                        size_t len, size_t limit, const unsigned char *bad_pages);
+
+/**
+ * @brief Checks if a match covers a page that could not be read
+ *
+ * Zero-filled holes can still look like a match.
+ *
+ * @param addr Address of the chunk
+ * @param offset Offset of the match into the chunk
+ * @param length Length of the match
+ * @param bad_pages Bitmap returned by libhack_read_bytes (may be NULL)
+ * @return bool true if any byte of the match could not be read
+ */
+static bool libhack_signature_on_bad_page(DWORD64 addr, size_t offset, size_t length,
+                                          const unsigned char *bad_pages)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    DWORD64 first_page = addr & ~((DWORD64)page - 1);
+    size_t first = (size_t)((addr + offset - first_page) / page);
+    size_t last = (size_t)((addr + offset + length - 1 - first_page) / page);
+
+    if (!bad_pages)
+        return false;
+
+    for (size_t i = first; i <= last; i++)
+    {
+        if (bad_pages[i / 8] & (1 << (i % 8)))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Gets the address reported for a match
+ *
+ * @param options Options of the signature
+ * @param addr Address of the match
+ * @param match Bytes of the match
+ * @return DWORD64 Match address or the target of its RIP-relative operand
+ */
+static DWORD64 libhack_signature_target(const struct libhack_signature_options *options,
+                                        DWORD64 addr, const unsigned char *match)
+{
+    size_t end;
+    int32_t disp;
+
+    if (!options->resolve_rip)
+        return addr;
+
+    end = options->rip_end ? options->rip_end : options->rip_offset + sizeof(disp);
+    memcpy(&disp, match + options->rip_offset, sizeof(disp));
+
+    return addr + end + (DWORD64)(int64_t)disp;
+}
+
+static bool libhack_signature_append(struct libhack_scan_result *result, size_t *capacity,
+                                     DWORD64 addr)
+{
+    if (result->count == *capacity)
+    {
+        size_t new_capacity = *capacity ? *capacity * 2 : 64;
+        DWORD64 *addrs = (DWORD64 *)realloc(result->addrs, new_capacity * sizeof(DWORD64));
+
+        if (!addrs)
+            return false;
+
+        result->addrs = addrs;
+        *capacity = new_capacity;
+    }
+
+    result->addrs[result->count++] = addr;
+
+    return true;
+}
+
+/**
+ * @brief Checks if a region must be scanned for a signature
+ *
+ * @param region Region
+ * @param options Scan options
+ * @return bool true if the region must be scanned
+ */
+static bool libhack_signature_region_wanted(const struct libhack_region *region,
+                                            const struct libhack_signature_options *options)
+{
+    if (!libhack_region_readable(region))
+        return false;
+
+    return !options->executable_only || region->perms[2] == 'x';
+}
+
+/**
+ * @brief Scratch buffers of a walk reading file-backed regions from their image
+ *
+ */
+struct libhack_signature_image_io
+{
+	/**
+	 * @brief Pagemap entries of the chunk
+	 *
+	 */
+	uint64_t *entries;
+
+	/**
+	 * @brief Read descriptors of the pages which must be fetched remotely
+	 *
+	 */
+	struct libhack_mem_desc *descs;
+
+	/**
+	 * @brief Status of each descriptor
+	 *
+	 */
+	long *status;
+
+	/**
+	 * @brief Bytes taken from local images
+	 *
+	 */
+	size_t local_bytes;
+
+	/**
+	 * @brief Bytes read from the process
+	 *
+	 */
+	size_t remote_bytes;
+};
+
+/**
+ * @brief Reads a chunk of a file-backed region, using its image where possible
+ *
+ * Pages that are present and no longer file pages were copied on write by
+ * the process, and swapped pages are anonymous too, so only those (and pages
+ * past the end of the file) are read from the process. When the whole chunk
+ * is clean, data points straight into the image and nothing is copied.
+ *
+ * @param handle Handle to libhack
+ * @param image Image of the region
+ * @param io Scratch buffers sized for one chunk
+ * @param addr Address of the chunk (page aligned)
+ * @param buffer Local buffer used when some page must be read remotely
+ * @param len Size of the chunk
+ * @param bad_pages Bitmap which receives the pages that could not be read
+ * @param data Receives the bytes of the chunk
+ * @return long LIBHACK_OK, EFAULT if some pages could not be read or errno value
+ */
+static long libhack_signature_read_image(struct libhack_handle *handle,
+                                         const struct libhack_image *image,
+                                         struct libhack_signature_image_io *io, DWORD64 addr,
+                                         unsigned char *buffer, size_t len,
+                                         unsigned char *bad_pages, const unsigned char **data)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t pages = (len + page - 1) / page;
+    size_t offset = (size_t)(addr - image->start);
+    size_t count = 0;
+    bool known = libhack_pagemap_read(handle, addr, pages, io->entries) == LIBHACK_OK;
+    long result = LIBHACK_OK;
+
+    for (size_t i = 0; i < pages; i++)
+    {
+        uint64_t entry = io->entries[i];
+        size_t pos = i * page;
+        size_t n = len - pos < page ? len - pos : page;
+        bool dirty = !known || offset + pos + n > image->size ||
+                     (entry & LIBHACK_PAGEMAP_SWAPPED) ||
+                     ((entry & LIBHACK_PAGEMAP_PRESENT) && !(entry & LIBHACK_PAGEMAP_FILE_SHARED));
+
+        if (!dirty)
+            continue;
+
+        io->descs[count].addr = addr + pos;
+        io->descs[count].buffer = buffer + pos;
+        io->descs[count].len = n;
+        count++;
+    }
+
+    if (count == 0)
+    {
+        io->local_bytes += len;
+        *data = image->data + offset;
+        return LIBHACK_OK;
+    }
+
+    memset(bad_pages, 0, libhack_page_bitmap_size(addr, len));
+
+    // Clean pages come from the image, the rest from the process
+    for (size_t i = 0, next = 0; i < pages; i++)
+    {
+        size_t pos = i * page;
+        size_t n = len - pos < page ? len - pos : page;
+
+        if (next < count && io->descs[next].addr == addr + pos)
+        {
+            next++;
+            continue;
+        }
+
+        memcpy(buffer + pos, image->data + offset + pos, n);
+        io->local_bytes += n;
+    }
+
+    libhack_read_batch(handle, io->descs, count, io->status);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t index = (size_t)((io->descs[i].addr - addr) / page);
+
+        if (io->status[i] == ESRCH)
+            return ESRCH;
+
+        if (io->status[i] == LIBHACK_OK)
+        {
+            io->remote_bytes += io->descs[i].len;
+            continue;
+        }
+
+        memset(io->descs[i].buffer, 0, io->descs[i].len);
+        bad_pages[index / 8] |= (unsigned char)(1 << (index % 8));
+        result = EFAULT;
+    }
+
+    *data = buffer;
+
+    return result;
+}
+
+/**
+ * @brief Reads every wanted region once and hands its chunks to a searcher
+ *
+ * Chunks overlap by length - 1 bytes so matches crossing into the next chunk
+ * are still found.
+ *
+ * @param handle Handle to libhack
+ * @param options Scan scope
+ * @param length Longest match
+ * @param fn Searcher
+ * @param ctx Argument of the searcher
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_signature_walk(struct libhack_handle *handle,
+                                   const struct libhack_signature_options *options,
+                                   size_t length, libhack_signature_chunk fn, void *ctx)
+{
+    const struct libhack_maps *maps;
+    const struct libhack_module *module = NULL;
+    struct libhack_signature_image_io io;
+    unsigned char *buffer;
+    unsigned char *bad_pages;
+    size_t read_max = LIBHACK_SCAN_CHUNK + length - 1;
+    size_t max_pages = read_max / (size_t)sysconf(_SC_PAGESIZE) + 2;
+    size_t first = 0;
+    size_t last;
+    long status = LIBHACK_OK;
+    bool done = false;
+
+    if (libhack_maps_update(handle, NULL) != LIBHACK_OK)
+        return ESRCH;
+
+    maps = libhack_get_maps(handle);
+    if (!maps)
+        return ESRCH;
+
+    last = maps->count;
+    memset(&io, 0, sizeof(io));
+    buffer = (unsigned char *)malloc(read_max);
+    bad_pages = (unsigned char *)malloc(libhack_page_bitmap_size(0, read_max) + 1);
+    if (options->file_images)
+    {
+        io.entries = (uint64_t *)malloc(max_pages * sizeof(uint64_t));
+        io.descs = (struct libhack_mem_desc *)malloc(max_pages * sizeof(struct libhack_mem_desc));
+        io.status = (long *)malloc(max_pages * sizeof(long));
+    }
+
+    if (!buffer || !bad_pages ||
+        (options->file_images && (!io.entries || !io.descs || !io.status)))
+    {
+        status = ENOMEM;
+        done = true;
+    }
+
+    // Scans scoped to a module only visit its own regions
+    if (options->module)
+    {
+        module = libhack_maps_find_module(maps, options->module);
+        first = module ? module->first_region : 0;
+        last = module ? module->end_region : 0;
+    }
+
+    for (size_t i = first; i < last && !done; i++)
+    {
+        const struct libhack_region *region = &maps->regions[i];
+        struct libhack_image image;
+        bool use_image;
+
+        if (!libhack_signature_region_wanted(region, options))
+            continue;
+
+        // Skip the bss and anything mapped between the regions of the module
+        if (module && region->pathname != module->path)
+            continue;
+
+        use_image = options->file_images && region->inode != 0 &&
+                    libhack_image_map(handle, region, &image) == LIBHACK_OK;
+
+        for (DWORD64 addr = region->start; addr < region->end && !done; addr += LIBHACK_SCAN_CHUNK)
+        {
+            size_t left = (size_t)(region->end - addr);
+            size_t len = left < read_max ? left : read_max;
+            const unsigned char *data = buffer;
+            long read_status;
+
+            if (use_image)
+            {
+                read_status = libhack_signature_read_image(handle, &image, &io, addr, buffer, len,
+                                                           bad_pages, &data);
+            }
+            else
+            {
+                read_status = libhack_read_bytes(handle, addr, buffer, len, bad_pages);
+                if (read_status == LIBHACK_OK || read_status == EFAULT)
+                    io.remote_bytes += len;
+            }
+
+            if (read_status == ESRCH)
+            {
+                status = ESRCH;
+                break;
+            }
+
+            if (read_status != LIBHACK_OK && read_status != EFAULT)
+                continue;
+
+            done = !fn(ctx, addr, data, len, left < LIBHACK_SCAN_CHUNK ? left : LIBHACK_SCAN_CHUNK,
+                       read_status == EFAULT ? bad_pages : NULL);
+        }
+
+        if (use_image)
+            libhack_image_unmap(&image);
+
+        if (status == ESRCH)
+            break;
+    }
+
+    libhack_debug("signature scan: %zu bytes from file images, %zu bytes from the process",
+                  io.local_bytes, io.remote_bytes);
+
+    free(io.entries);
+    free(io.descs);
+    free(io.status);
+    free(buffer);
+    free(bad_pages);
+
+    return status;
+}
+
+/**
+ * @brief State of a single signature scan
+ *
+ */
+struct libhack_signature_job
+{
+	/**
+	 * @brief Signature
+	 *
+	 */
+	const struct libhack_signature *sig;
+
+	/**
+	 * @brief Scan options
+	 *
+	 */
+	const struct libhack_signature_options *options;
+
+	/**
+	 * @brief Receives the addresses
+	 *
+	 */
+	struct libhack_scan_result *result;
+
+	/**
+	 * @brief Capacity of result->addrs
+	 *
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief Address of the chunk being searched
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Bytes of the chunk
+	 *
+	 */
+	const unsigned char *buffer;
+
+	/**
+	 * @brief Matches must start before this offset
+	 *
+	 */
+	size_t limit;
+
+	/**
+	 * @brief Pages of the chunk that could not be read (may be NULL)
+	 *
+	 */
+	const unsigned char *bad_pages;
+
+	/**
+	 * @brief LIBHACK_OK or the error which stopped the scan
+	 *
+	 */
+	long status;
+};
+
+static bool libhack_signature_push(void *ctx, size_t offset)
+{
+    struct libhack_signature_job *job = (struct libhack_signature_job *)ctx;
+    size_t max = job->options->max_results;
+
+    // Overlap with the next chunk, which reports it
+    if (offset >= job->limit)
+        return true;
+
+    if (libhack_signature_on_bad_page(job->addr, offset, job->sig->length, job->bad_pages))
+        return true;
+
+    if (!libhack_signature_append(job->result, &job->capacity,
+                                  libhack_signature_target(job->options, job->addr + offset,
+                                                           job->buffer + offset)))
+    {
+        job->status = ENOMEM;
+        return false;
+    }
+
+    return max == 0 || job->result->count < max;
+}
+
+static bool libhack_signature_scan_chunk(void *ctx, DWORD64 addr, const unsigned char *buffer,
+                                         size_t len, size_t limit, const unsigned char *bad_pages)
+{
+    struct libhack_signature_job *job = (struct libhack_signature_job *)ctx;
+    size_t max = job->options->max_results;
+
+    job->addr = addr;
+    job->buffer = buffer;
+    job->limit = limit;
+    job->bad_pages = bad_pages;
+
+    libhack_signature_run(job->sig, buffer, len, libhack_signature_push, job);
+
+    return job->status == LIBHACK_OK && (max == 0 || job->result->count < max);
+}
+
+long libhack_signature_scan(struct libhack_handle *handle, const struct libhack_signature *sig,
+                            const struct libhack_signature_options *options,
+                            struct libhack_scan_result *result)
+{
+    struct libhack_signature_options opts;
+    struct libhack_signature_job job;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && sig != NULL && result != NULL, -1);
+
+    memset(result, 0, sizeof(*result));
+    memset(&opts, 0, sizeof(opts));
+    if (options)
+        opts = *options;
+
+    if (opts.resolve_rip && opts.rip_offset + sizeof(int32_t) > sig->length)
+    {
+        libhack_err("RIP displacement lies outside of the signature");
+        return EINVAL;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.sig = sig;
+    job.options = &opts;
+    job.result = result;
+    job.status = LIBHACK_OK;
+
+    status = libhack_signature_walk(handle, &opts, sig->length, libhack_signature_scan_chunk, &job);
+    if (status == LIBHACK_OK)
+        status = job.status;
+
+    if (status != LIBHACK_OK)
+    {
+        libhack_scan_result_free(result);
+        return status;
+    }
+
+    libhack_debug("signature found %zu times on %d", result->count, handle->pid);
+
+    return LIBHACK_OK;
+}
+
+long libhack_signature_find(struct libhack_handle *handle, const struct libhack_signature *sig,
+                            const struct libhack_signature_options *options, DWORD64 *addr)
+{
+    struct libhack_signature_options opts;
+    struct libhack_scan_result result;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(addr != NULL, -1);
+
+    memset(&opts, 0, sizeof(opts));
+    if (options)
+        opts = *options;
+
+    opts.max_results = 1;
+
+    status = libhack_signature_scan(handle, sig, &opts, &result);
+    if (status != LIBHACK_OK)
+        return status;
+
+    if (result.count == 0)
+        return ENOENT;
+
+    *addr = result.addrs[0];
+    libhack_scan_result_free(&result);
+
+    return LIBHACK_OK;
+}
+
+void libhack_signature_free(struct libhack_signature *sig)
+{
+    if (!sig)
+        return;
+
+    free(sig->bytes);
+    free(sig->mask);
+    free(sig);
+}
+
+/**
+ * @brief Longest anchor segment inserted in the automaton
+ *
+ */
+#define SIGNATURE_SET_MAX_SEGMENT 16
+
+/**
+ * @brief Marks the end of an output list
+ *
+ */
+#define SIGNATURE_SET_NONE SIZE_MAX
+
+/**
+ * @brief A signature of a set
+ *
+ */
+struct libhack_signature_entry
+{
+	/**
+	 * @brief Compiled signature
+	 *
+	 */
+	struct libhack_signature *sig;
+
+	/**
+	 * @brief Per signature options
+	 *
+	 */
+	struct libhack_signature_options options;
+
+	/**
+	 * @brief Offset of the anchor segment into the signature
+	 *
+	 */
+	size_t segment;
+
+	/**
+	 * @brief Length of the anchor segment
+	 *
+	 */
+	size_t segment_len;
+
+	/**
+	 * @brief Next signature whose segment ends on the same state
+	 *
+	 */
+	size_t next;
+};
+
+struct libhack_signature_set
+{
+	/**
+	 * @brief Signatures
+	 *
+	 */
+	struct libhack_signature_entry *entries;
+
+	/**
+	 * @brief Number of signatures
+	 *
+	 */
+	size_t count;
+
+	/**
+	 * @brief Longest signature
+	 *
+	 */
+	size_t max_length;
+
+	/**
+	 * @brief Automaton transitions, 256 per state
+	 *
+	 */
+	uint32_t *delta;
+
+	/**
+	 * @brief First signature whose segment ends on each state
+	 *
+	 */
+	size_t *outputs;
+
+	/**
+	 * @brief Nearest proper suffix state with outputs (0 if none)
+	 *
+	 */
+	uint32_t *dict;
+
+	/**
+	 * @brief Number of states
+	 *
+	 */
+	size_t state_count;
+
+	/**
+	 * @brief Automaton matches the current signatures
+	 *
+	 */
+	bool compiled;
+};
+
+/**
+ * @brief Callback receiving each match of a set
+ *
+ * @return bool false to stop the search
+ */
+typedef bool (*libhack_signature_set_hit)(void *ctx, size_t id, size_t offset);
+
+struct libhack_signature_set *libhack_signature_set_create()
+{
+    return (struct libhack_signature_set *)calloc(1, sizeof(struct libhack_signature_set));
+}
+
+/**
+ * @brief Picks the longest run of fully known bytes of a signature
+ *
+ * @param entry Signature of the set
+ */
+static void libhack_signature_set_segment(struct libhack_signature_entry *entry)
+{
+    const struct libhack_signature *sig = entry->sig;
+
+    entry->segment = 0;
+    entry->segment_len = 0;
+
+    for (size_t i = 0; i < sig->length;)
+    {
+        size_t len = 0;
+
+        while (i + len < sig->length && sig->mask[i + len] == 0xFF)
+            len++;
+
+        if (len > entry->segment_len)
+        {
+            entry->segment = i;
+            entry->segment_len = len;
+        }
+
+        i += len ? len : 1;
+    }
+
+    // Longer segments only grow the automaton, the verification does the rest
+    if (entry->segment_len > SIGNATURE_SET_MAX_SEGMENT)
+        entry->segment_len = SIGNATURE_SET_MAX_SEGMENT;
+}
+
+long libhack_signature_set_add(struct libhack_signature_set *set, const char *pattern,
+                               const struct libhack_signature_options *options, size_t *id)
+{
+    struct libhack_signature_entry *entries;
+    struct libhack_signature_entry *entry;
+    struct libhack_signature *sig;
+
+    // Sanity checking
+    libhack_assert_or_return(set != NULL && pattern != NULL, -1);
+
+    sig = libhack_signature_compile(pattern);
+    if (!sig)
+        return EINVAL;
+
+    if (options && options->resolve_rip && options->rip_offset + sizeof(int32_t) > sig->length)
+    {
+        libhack_err("RIP displacement lies outside of the signature");
+        libhack_signature_free(sig);
+        return EINVAL;
+    }
+
+    entries = (struct libhack_signature_entry *)realloc(set->entries,
+                                                        (set->count + 1) * sizeof(*entries));
+    if (!entries)
+    {
+        libhack_signature_free(sig);
+        return ENOMEM;
+    }
+
+    set->entries = entries;
+    entry = &entries[set->count];
+    memset(entry, 0, sizeof(*entry));
+    entry->sig = sig;
+    if (options)
+        entry->options = *options;
+
+    libhack_signature_set_segment(entry);
+
+    if (sig->length > set->max_length)
+        set->max_length = sig->length;
+
+    if (id)
+        *id = set->count;
+
+    set->count++;
+    set->compiled = false;
+
+    return LIBHACK_OK;
+}
+
+size_t libhack_signature_set_count(const struct libhack_signature_set *set)
+{
+    return set ? set->count : 0;
+}
+
+/**
+ * @brief Builds the Aho-Corasick automaton of the anchor segments
+ *
+ * Missing transitions are resolved through the failure links, so the search
+ * takes exactly one table lookup per byte.
+ *
+ * @param set Signature set
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_signature_set_compile(struct libhack_signature_set *set)
+{
+    size_t max_states = 1;
+    uint32_t *fail = NULL;
+    uint32_t *queue = NULL;
+    size_t head = 0;
+    size_t tail = 0;
+
+    for (size_t i = 0; i < set->count; i++)
+        max_states += set->entries[i].segment_len;
+
+    free(set->delta);
+    free(set->outputs);
+    free(set->dict);
+
+    set->delta = (uint32_t *)calloc(max_states * 256, sizeof(uint32_t));
+    set->outputs = (size_t *)malloc(max_states * sizeof(size_t));
+    set->dict = (uint32_t *)calloc(max_states, sizeof(uint32_t));
+    fail = (uint32_t *)calloc(max_states, sizeof(uint32_t));
+    queue = (uint32_t *)malloc(max_states * sizeof(uint32_t));
+    if (!set->delta || !set->outputs || !set->dict || !fail || !queue)
+    {
+        free(fail);
+        free(queue);
+        return ENOMEM;
+    }
+
+    for (size_t s = 0; s < max_states; s++)
+        set->outputs[s] = SIGNATURE_SET_NONE;
+
+    // Trie of the segments; state 0 is the root, so 0 also means "no child"
+    set->state_count = 1;
+    for (size_t i = 0; i < set->count; i++)
+    {
+        struct libhack_signature_entry *entry = &set->entries[i];
+        uint32_t state = 0;
+
+        for (size_t j = 0; j < entry->segment_len; j++)
+        {
+            unsigned char byte = entry->sig->bytes[entry->segment + j];
+            uint32_t *next = &set->delta[state * 256 + byte];
+
+            if (*next == 0)
+                *next = (uint32_t)set->state_count++;
+
+            state = *next;
+        }
+
+        entry->next = set->outputs[state];
+        set->outputs[state] = i;
+    }
+
+    for (size_t c = 0; c < 256; c++)
+    {
+        if (set->delta[c])
+            queue[tail++] = set->delta[c];
+    }
+
+    while (head < tail)
+    {
+        uint32_t state = queue[head++];
+
+        for (size_t c = 0; c < 256; c++)
+        {
+            uint32_t *next = &set->delta[state * 256 + c];
+            uint32_t fallback = set->delta[fail[state] * 256 + c];
+
+            if (*next == 0)
+            {
+                *next = fallback;
+                continue;
+            }
+
+            fail[*next] = fallback;
+            set->dict[*next] = set->outputs[fallback] != SIGNATURE_SET_NONE ? fallback
+                                                                           : set->dict[fallback];
+            queue[tail++] = *next;
+        }
+    }
+
+    free(fail);
+    free(queue);
+
+    set->compiled = true;
+
+    libhack_debug("signature set of %zu patterns compiled to %zu states", set->count,
+                  set->state_count);
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Runs the automaton over a buffer and verifies every segment hit
+ *
+ * @param set Compiled signature set
+ * @param buffer Buffer to be searched
+ * @param len Size of buffer
+ * @param hit Callback receiving each match
+ * @param ctx Argument of the callback
+ */
+static void libhack_signature_set_run(const struct libhack_signature_set *set,
+                                      const unsigned char *buffer, size_t len,
+                                      libhack_signature_set_hit hit, void *ctx)
+{
+    uint32_t state = 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        state = set->delta[state * 256 + buffer[i]];
+
+        for (uint32_t out = set->outputs[state] != SIGNATURE_SET_NONE ? state : set->dict[state];
+             out != 0; out = set->dict[out])
+        {
+            for (size_t id = set->outputs[out]; id != SIGNATURE_SET_NONE; id = set->entries[id].next)
+            {
+                const struct libhack_signature_entry *entry = &set->entries[id];
+                size_t end = i + 1 - entry->segment_len;
+
+                if (end < entry->segment)
+                    continue;
+
+                size_t start = end - entry->segment;
+
+                if (start + entry->sig->length > len ||
+                    !libhack_signature_verify(entry->sig, buffer + start))
+                    continue;
+
+                if (!hit(ctx, id, start))
+                    return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Matches collected by libhack_signature_set_search
+ *
+ */
+struct libhack_signature_set_array
+{
+	/**
+	 * @brief Receives the signature of each match (may be NULL)
+	 *
+	 */
+	size_t *ids;
+
+	/**
+	 * @brief Receives the offset of each match (may be NULL)
+	 *
+	 */
+	size_t *offsets;
+
+	/**
+	 * @brief Capacity of ids and offsets
+	 *
+	 */
+	size_t max;
+
+	/**
+	 * @brief Number of matches found
+	 *
+	 */
+	size_t count;
+};
+
+static bool libhack_signature_set_collect(void *ctx, size_t id, size_t offset)
+{
+    struct libhack_signature_set_array *array = (struct libhack_signature_set_array *)ctx;
+
+    if (array->count < array->max)
+    {
+        if (array->ids)
+            array->ids[array->count] = id;
+
+        if (array->offsets)
+            array->offsets[array->count] = offset;
+    }
+
+    array->count++;
+
+    return true;
+}
+
+size_t libhack_signature_set_search(struct libhack_signature_set *set, const unsigned char *buffer,
+                                    size_t len, size_t *ids, size_t *offsets, size_t max)
+{
+    struct libhack_signature_set_array array = {ids, offsets, max, 0};
+
+    if (!set || !buffer || set->count == 0)
+        return 0;
+
+    if (!set->compiled && libhack_signature_set_compile(set) != LIBHACK_OK)
+        return 0;
+
+    libhack_signature_set_run(set, buffer, len, libhack_signature_set_collect, &array);
+
+    return array.count;
+}
+
+/**
+ * @brief State of a signature set scan
+ *
+ */
+struct libhack_signature_set_job
+{
+	/**
+	 * @brief Signature set
+	 *
+	 */
+	const struct libhack_signature_set *set;
+
+	/**
+	 * @brief Results of each signature
+	 *
+	 */
+	struct libhack_scan_result *results;
+
+	/**
+	 * @brief Capacity of each result
+	 *
+	 */
+	size_t *capacity;
+
+	/**
+	 * @brief Limited signatures which still miss matches
+	 *
+	 */
+	size_t pending;
+
+	/**
+	 * @brief Some signature wants every match
+	 *
+	 */
+	bool unlimited;
+
+	/**
+	 * @brief Address of the chunk being searched
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Bytes of the chunk
+	 *
+	 */
+	const unsigned char *buffer;
+
+	/**
+	 * @brief Matches must start before this offset
+	 *
+	 */
+	size_t limit;
+
+	/**
+	 * @brief Pages of the chunk that could not be read (may be NULL)
+	 *
+	 */
+	const unsigned char *bad_pages;
+
+	/**
+	 * @brief LIBHACK_OK or the error which stopped the scan
+	 *
+	 */
+	long status;
+};
+
+static bool libhack_signature_set_push(void *ctx, size_t id, size_t offset)
+{
+    struct libhack_signature_set_job *job = (struct libhack_signature_set_job *)ctx;
+    const struct libhack_signature_entry *entry = &job->set->entries[id];
+    struct libhack_scan_result *result = &job->results[id];
+    size_t max = entry->options.max_results;
+
+    if (offset >= job->limit || (max && result->count >= max))
+        return true;
+
+    if (libhack_signature_on_bad_page(job->addr, offset, entry->sig->length, job->bad_pages))
+        return true;
+
+    if (!libhack_signature_append(result, &job->capacity[id],
+                                  libhack_signature_target(&entry->options, job->addr + offset,
+                                                           job->buffer + offset)))
+    {
+        job->status = ENOMEM;
+        return false;
+    }
+
+    if (max && result->count == max)
+        job->pending--;
+
+    // Every signature got all the matches it asked for
+    return job->unlimited || job->pending > 0;
+}
+
+static bool libhack_signature_set_scan_chunk(void *ctx, DWORD64 addr, const unsigned char *buffer,
+                                             size_t len, size_t limit, const unsigned char *bad_pages)
+{
+    struct libhack_signature_set_job *job = (struct libhack_signature_set_job *)ctx;
+
+    job->addr = addr;
+    job->buffer = buffer;
+    job->limit = limit;
+    job->bad_pages = bad_pages;
+
+    libhack_signature_set_run(job->set, buffer, len, libhack_signature_set_push, job);
+
+    return job->status == LIBHACK_OK && (job->unlimited || job->pending > 0);
+}
+
+long libhack_signature_set_scan(struct libhack_handle *handle, struct libhack_signature_set *set,
+                                const struct libhack_signature_options *options,
+                                struct libhack_scan_result *results)
+{
+    struct libhack_signature_options scope;
+    struct libhack_signature_set_job job;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL && set != NULL && results != NULL, -1);
+
+    memset(results, 0, set->count * sizeof(*results));
+    if (set->count == 0)
+        return LIBHACK_OK;
+
+    if (!set->compiled)
+    {
+        status = libhack_signature_set_compile(set);
+        if (status != LIBHACK_OK)
+            return status;
+    }
+
+    memset(&scope, 0, sizeof(scope));
+    if (options)
+    {
+        scope.module = options->module;
+        scope.executable_only = options->executable_only;
+        scope.file_images = options->file_images;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.set = set;
+    job.results = results;
+    job.status = LIBHACK_OK;
+    job.capacity = (size_t *)calloc(set->count, sizeof(size_t));
+    if (!job.capacity)
+        return ENOMEM;
+
+    // Signatures without a limit keep the scan going until the end
+    for (size_t i = 0; i < set->count; i++)
+    {
+        if (set->entries[i].options.max_results == 0)
+            job.unlimited = true;
+        else
+            job.pending++;
+    }
+
+    status = libhack_signature_walk(handle, &scope, set->max_length,
+                                    libhack_signature_set_scan_chunk, &job);
+    if (status == LIBHACK_OK)
+        status = job.status;
+
+    free(job.capacity);
+
+    if (status != LIBHACK_OK)
+    {
+        for (size_t i = 0; i < set->count; i++)
+            libhack_scan_result_free(&results[i]);
+
+        return status;
+    }
+
+    libhack_debug("signature set of %zu patterns scanned on %d", set->count, handle->pid);
+
+    return LIBHACK_OK;
+}
+
+void libhack_signature_set_free(struct libhack_signature_set *set)
+{
+    if (!set)
+        return;
+
+    for (size_t i = 0; i < set->count; i++)
+        libhack_signature_free(set->entries[i].sig);
+
+    free(set->entries);
+    free(set->delta);
+    free(set->outputs);
+    free(set->dict);
+    free(set);
+}
+
+#endif // __linux__
@@ -0,0 +1,245 @@
+/**
+ * @file signature.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Byte signature (array of bytes) scanning
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_SIGNATURE_H
+#define LIBHACK_SIGNATURE_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "init.h"
+#include "scan.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A compiled byte signature
+ *
+ */
+struct libhack_signature;
+
+/**
+ * @brief Options of a signature scan (zeroed options scan every readable region)
+ *
+ */
+struct libhack_signature_options
+{
+	/**
+	 * @brief File name or pathname of the module to be scanned (NULL scans the whole process)
+	 *
+	 */
+	const char *module;
+
+	/**
+	 * @brief Scan only executable regions
+	 *
+	 */
+	bool executable_only;
+
+	/**
+	 * @brief Stop after this many matches (0 finds every match)
+	 *
+	 */
+	size_t max_results;
+
+	/**
+	 * @brief Report the target of a RIP-relative operand instead of the match address
+	 *
+	 */
+	bool resolve_rip;
+
+	/**
+	 * @brief Offset into the match of the 32-bit displacement
+	 *
+	 */
+	size_t rip_offset;
+
+	/**
+	 * @brief Offset into the match of the end of the instruction (0 uses rip_offset + 4)
+	 *
+	 */
+	size_t rip_end;
+
+	/**
+	 * @brief Take file-backed regions from their file on disk, reading from the process only
+	 * the pages it has modified
+	 *
+	 */
+	bool file_images;
+};
+
+/**
+ * @brief Compiles a signature such as "48 8B 05 ?? ?? ?? ?? 48 85 C0"
+ *
+ * Bytes are separated by spaces. "??" or "?" matches any byte and a single
+ * question mark inside a byte ("4?", "?8") matches any value of that nibble.
+ * At least one byte must be fully known.
+ *
+ * @param pattern Signature text
+ * @return struct libhack_signature* Compiled signature or NULL on error
+ */
+struct libhack_signature *libhack_signature_compile(const char *pattern);
+
+/**
+ * @brief Gets the number of bytes matched by a signature
+ *
+ * @param sig Compiled signature
+ * @return size_t Length in bytes
+ */
+size_t libhack_signature_length(const struct libhack_signature *sig);
+
+/**
+ * @brief Checks a local buffer against a signature
+ *
+ * @param sig Compiled signature
+ * @param buffer Buffer holding at least libhack_signature_length bytes
+ * @return bool true if the buffer starts with the signature
+ */
+bool libhack_signature_match(const struct libhack_signature *sig, const unsigned char *buffer);
+
+/**
+ * @brief Finds every match of a signature in a local buffer
+ *
+ * Signatures with a long safe shift are searched with a skip table; others
+ * use a SIMD prefilter on their two rarest known bytes.
+ *
+ * @param sig Compiled signature
+ * @param buffer Buffer to be searched
+ * @param len Size of buffer
+ * @param offsets Receives the offsets of the matches (may be NULL)
+ * @param max Capacity of offsets
+ * @return size_t Number of matches (may exceed max)
+ */
+size_t libhack_signature_search(const struct libhack_signature *sig, const unsigned char *buffer,
+								size_t len, size_t *offsets, size_t max);
+
+/**
+ * @brief Scans the process for a signature
+ *
+ * @param handle Handle to libhack
+ * @param sig Compiled signature
+ * @param options Scan options (may be NULL)
+ * @param result Receives the match addresses, or the RIP-relative targets
+ * (release with libhack_scan_result_free)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_signature_scan(struct libhack_handle *handle, const struct libhack_signature *sig,
+							const struct libhack_signature_options *options,
+							struct libhack_scan_result *result);
+
+/**
+ * @brief Finds the first match of a signature
+ *
+ * @param handle Handle to libhack
+ * @param sig Compiled signature
+ * @param options Scan options (may be NULL, max_results is ignored)
+ * @param addr Receives the match address or the RIP-relative target
+ * @return long LIBHACK_OK on success, ENOENT if there is no match or errno value
+ */
+long libhack_signature_find(struct libhack_handle *handle, const struct libhack_signature *sig,
+							const struct libhack_signature_options *options, DWORD64 *addr);
+
+/**
+ * @brief Releases a compiled signature
+ *
+ * @param sig Compiled signature
+ */
+void libhack_signature_free(struct libhack_signature *sig);
+
+/**
+ * @brief Many signatures searched together in a single pass
+ *
+ * The longest fully known segment of every signature is compiled into one
+ * Aho-Corasick automaton; each segment hit is then verified against the
+ * whole signature, wildcards included.
+ *
+ */
+struct libhack_signature_set;
+
+/**
+ * @brief Creates an empty signature set
+ *
+ * @return struct libhack_signature_set* Signature set or NULL on error
+ */
+struct libhack_signature_set *libhack_signature_set_create();
+
+/**
+ * @brief Adds a signature to a set
+ *
+ * @param set Signature set
+ * @param pattern Signature text (see libhack_signature_compile)
+ * @param options Per signature max_results and RIP resolution (may be NULL, module,
+ * executable_only and file_images are ignored)
+ * @param id Receives the index of the signature in the set (may be NULL)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_signature_set_add(struct libhack_signature_set *set, const char *pattern,
+							   const struct libhack_signature_options *options, size_t *id);
+
+/**
+ * @brief Gets the number of signatures of a set
+ *
+ * @param set Signature set
+ * @return size_t Number of signatures
+ */
+size_t libhack_signature_set_count(const struct libhack_signature_set *set);
+
+/**
+ * @brief Finds every match of every signature of a set in a local buffer
+ *
+ * Matches are reported in the order their anchor segment ends.
+ *
+ * @param set Signature set
+ * @param buffer Buffer to be searched
+ * @param len Size of buffer
+ * @param ids Receives the signature of each match (may be NULL)
+ * @param offsets Receives the offset of each match (may be NULL)
+ * @param max Capacity of ids and offsets
+ * @return size_t Number of matches (may exceed max)
+ */
+size_t libhack_signature_set_search(struct libhack_signature_set *set, const unsigned char *buffer,
+									size_t len, size_t *ids, size_t *offsets, size_t max);
+
+/**
+ * @brief Scans the process for every signature of a set, reading each byte once
+ *
+ * @param handle Handle to libhack
+ * @param set Signature set
+ * @param options Scan scope (may be NULL, only module, executable_only and
+ * file_images are used)
+ * @param results Array of libhack_signature_set_count entries receiving, in address order, the
+ * matches of each signature (release each one with libhack_scan_result_free)
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_signature_set_scan(struct libhack_handle *handle, struct libhack_signature_set *set,
+								const struct libhack_signature_options *options,
+								struct libhack_scan_result *results);
+
+/**
+ * @brief Releases a signature set
+ *
+ * @param set Signature set
+ */
+void libhack_signature_set_free(struct libhack_signature_set *set);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_SIGNATURE_H
@@ -0,0 +1,908 @@
+/**
+ * @file snapshot.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Snapshots of writable memory for unknown initial value scans
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "logger.h"
+#include "maps.h"
+#include "pagemap.h"
+#include "process.h"
+#include "snapshot.h"
+#include "status_codes.h"
+
+/**
+ * @brief Slot of pages holding only zeros
+ *
+ */
+#define SNAPSHOT_ZERO_SLOT SIZE_MAX
+
+/**
+ * @brief Number of slots of a new spill file
+ *
+ */
+#define SNAPSHOT_INITIAL_SLOTS 1024
+
+/**
+ * @brief A page of the snapshot
+ *
+ */
+struct libhack_snapshot_page
+{
+	/**
+	 * @brief Address of the page
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Slot of the spill file holding the page (or SNAPSHOT_ZERO_SLOT)
+	 *
+	 */
+	size_t slot;
+};
+
+struct libhack_snapshot
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Spill file descriptor (unlinked)
+	 *
+	 */
+	int fd;
+
+	/**
+	 * @brief Shared mapping of the spill file
+	 *
+	 */
+	unsigned char *map;
+
+	/**
+	 * @brief Number of slots the spill file can hold
+	 *
+	 */
+	size_t slot_capacity;
+
+	/**
+	 * @brief Number of slots ever handed out
+	 *
+	 */
+	size_t slot_count;
+
+	/**
+	 * @brief Slots no longer referenced by any page
+	 *
+	 */
+	size_t *free_slots;
+
+	/**
+	 * @brief Number of free slots
+	 *
+	 */
+	size_t free_count;
+
+	/**
+	 * @brief Page size of the system
+	 *
+	 */
+	size_t page;
+
+	/**
+	 * @brief Pages sorted by address
+	 *
+	 */
+	struct libhack_snapshot_page *pages;
+
+	/**
+	 * @brief Number of pages
+	 *
+	 */
+	size_t page_count;
+
+	/**
+	 * @brief Statistics of the last snapshot
+	 *
+	 */
+	struct libhack_snapshot_stats stats;
+
+	/**
+	 * @brief Track the pages written by the process
+	 *
+	 */
+	bool track_writes;
+
+	/**
+	 * @brief Soft-dirty bits were cleared before the pages were copied
+	 *
+	 */
+	bool tracking;
+
+	/**
+	 * @brief Written pages make most of the snapshot: the next one clears the bits again
+	 *
+	 */
+	bool rearm;
+};
+
+/**
+ * @brief Buffers used to read only the pages written since the snapshot
+ *
+ */
+struct libhack_snapshot_io
+{
+	/**
+	 * @brief Pagemap entries of a chunk
+	 *
+	 */
+	uint64_t *entries;
+
+	/**
+	 * @brief Index of the snapshot page at the same address (or SIZE_MAX)
+	 *
+	 */
+	size_t *from;
+
+	/**
+	 * @brief Pages which must be read
+	 *
+	 */
+	unsigned char *need;
+
+	/**
+	 * @brief Read descriptors
+	 *
+	 */
+	struct libhack_mem_desc *descs;
+
+	/**
+	 * @brief Status of each descriptor
+	 *
+	 */
+	long *status;
+};
+
+static inline unsigned char *libhack_snapshot_slot(const struct libhack_snapshot *snap, size_t slot)
+{
+    return snap->map + slot * snap->page;
+}
+
+static bool libhack_snapshot_is_zero(const unsigned char *data, size_t len)
+{
+    const uint64_t *words = (const uint64_t *)data;
+
+    for (size_t i = 0; i < len / sizeof(uint64_t); i++)
+    {
+        if (words[i])
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Creates the spill file, unlinked so it vanishes with the process
+ *
+ * @param dir Directory of the file
+ * @return int File descriptor or -1 on error
+ */
+static int libhack_snapshot_open_spill(const char *dir)
+{
+    char path[4096];
+    int fd;
+
+    fd = open(dir, O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    if (fd >= 0)
+        return fd;
+
+    // Filesystems without O_TMPFILE support
+    snprintf(path, sizeof(path), "%s/libhack-snapshot-XXXXXX", dir);
+    fd = mkostemp(path, O_CLOEXEC);
+    if (fd >= 0)
+        unlink(path);
+
+    return fd;
+}
+
+/**
+ * @brief Doubles the capacity of the spill file
+ *
+ * @param snap Snapshot
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_snapshot_grow(struct libhack_snapshot *snap)
+{
+    size_t capacity = snap->slot_capacity ? snap->slot_capacity * 2 : SNAPSHOT_INITIAL_SLOTS;
+    size_t *free_slots;
+    void *map;
+    int error;
+
+    // Reserve the blocks now: running out of disk on a mapped write raises SIGBUS
+    error = posix_fallocate(snap->fd, 0, (off_t)(capacity * snap->page));
+    if (error != 0)
+    {
+        libhack_err("failed to grow snapshot spill file: %d", error);
+        return error;
+    }
+
+    if (snap->map)
+        map = mremap(snap->map, snap->slot_capacity * snap->page, capacity * snap->page, MREMAP_MAYMOVE);
+    else
+        map = mmap(NULL, capacity * snap->page, PROT_READ | PROT_WRITE, MAP_SHARED, snap->fd, 0);
+
+    if (map == MAP_FAILED)
+        return errno;
+
+    snap->map = (unsigned char *)map;
+
+    free_slots = (size_t *)realloc(snap->free_slots, capacity * sizeof(size_t));
+    if (!free_slots)
+        return ENOMEM;
+
+    snap->free_slots = free_slots;
+    snap->slot_capacity = capacity;
+
+    return LIBHACK_OK;
+}
+
+static long libhack_snapshot_alloc_slot(struct libhack_snapshot *snap, size_t *slot)
+{
+    if (snap->free_count > 0)
+    {
+        *slot = snap->free_slots[--snap->free_count];
+        return LIBHACK_OK;
+    }
+
+    if (snap->slot_count == snap->slot_capacity)
+    {
+        long status = libhack_snapshot_grow(snap);
+        if (status != LIBHACK_OK)
+            return status;
+    }
+
+    *slot = snap->slot_count++;
+
+    return LIBHACK_OK;
+}
+
+static bool libhack_snapshot_io_alloc(struct libhack_snapshot_io *io, size_t pages)
+{
+    io->entries = (uint64_t *)malloc(pages * sizeof(uint64_t));
+    io->from = (size_t *)malloc(pages * sizeof(size_t));
+    io->need = (unsigned char *)malloc(pages);
+    io->descs = (struct libhack_mem_desc *)malloc(pages * sizeof(struct libhack_mem_desc));
+    io->status = (long *)malloc(pages * sizeof(long));
+
+    return io->entries && io->from && io->need && io->descs && io->status;
+}
+
+static void libhack_snapshot_io_free(struct libhack_snapshot_io *io)
+{
+    free(io->entries);
+    free(io->from);
+    free(io->need);
+    free(io->descs);
+    free(io->status);
+}
+
+/**
+ * @brief Checks if a page may read back as zeros without being marked as written
+ *
+ * Pages dropped by MADV_DONTNEED lose their contents without a write fault.
+ *
+ * @param entry Pagemap entry of the page
+ * @return bool true if the page is missing or maps the zero page
+ */
+static bool libhack_snapshot_maybe_dropped(uint64_t entry)
+{
+    if (!(entry & (LIBHACK_PAGEMAP_PRESENT | LIBHACK_PAGEMAP_SWAPPED)))
+        return true;
+
+    if (!(entry & LIBHACK_PAGEMAP_PRESENT))
+        return false;
+
+    // Without page frame numbers the zero page is told apart by being shared
+    if (!(entry & LIBHACK_PAGEMAP_PFN_MASK))
+        return !(entry & LIBHACK_PAGEMAP_EXCLUSIVE);
+
+    return libhack_pagemap_is_zero_page(entry);
+}
+
+/**
+ * @brief Finds the pages of a chunk written since the soft-dirty bits were cleared
+ *
+ * @param snap Snapshot
+ * @param addr Address of the first page
+ * @param count Number of pages
+ * @param io Buffers (io->from must be filled, io->need receives the pages to be read)
+ * @return size_t Number of pages to be read
+ */
+static size_t libhack_snapshot_written(struct libhack_snapshot *snap, DWORD64 addr, size_t count,
+                                       struct libhack_snapshot_io *io)
+{
+    bool known = libhack_pagemap_read(snap->handle, addr, count, io->entries) == LIBHACK_OK;
+    size_t needed = 0;
+
+    for (size_t p = 0; p < count; p++)
+    {
+        uint64_t entry = io->entries[p];
+        bool written;
+
+        if (!known || io->from[p] == SIZE_MAX || (entry & LIBHACK_PAGEMAP_SOFT_DIRTY))
+            written = true;
+        else if (libhack_snapshot_maybe_dropped(entry))
+            written = snap->pages[io->from[p]].slot != SNAPSHOT_ZERO_SLOT;
+        else
+            written = false;
+
+        io->need[p] = written;
+        needed += written;
+    }
+
+    return needed;
+}
+
+/**
+ * @brief Reads the pages of a chunk flagged by libhack_snapshot_written
+ *
+ * @param snap Snapshot
+ * @param addr Address of the first page
+ * @param buffer Receives the pages at their offset in the chunk
+ * @param count Number of pages of the chunk
+ * @param needed Number of pages to be read (all of them if equal to count)
+ * @param io Buffers
+ * @param bad_pages Receives the pages which could not be read
+ * @return long LIBHACK_OK, EFAULT if some page could not be read or errno value
+ */
+static long libhack_snapshot_read_pages(struct libhack_snapshot *snap, DWORD64 addr,
+                                        unsigned char *buffer, size_t count, size_t needed,
+                                        struct libhack_snapshot_io *io, unsigned char *bad_pages)
+{
+    size_t descs = 0;
+    long status = LIBHACK_OK;
+
+    if (needed == count)
+        return libhack_read_bytes(snap->handle, addr, buffer, count * snap->page, bad_pages);
+
+    if (needed == 0)
+        return LIBHACK_OK;
+
+    for (size_t p = 0; p < count; p++)
+    {
+        if (!io->need[p])
+            continue;
+
+        io->descs[descs].addr = addr + p * snap->page;
+        io->descs[descs].buffer = buffer + p * snap->page;
+        io->descs[descs].len = snap->page;
+        descs++;
+    }
+
+    if (libhack_read_batch(snap->handle, io->descs, descs, io->status) == LIBHACK_OK)
+        return LIBHACK_OK;
+
+    memset(bad_pages, 0, count / 8 + 1);
+
+    for (size_t p = 0, d = 0; p < count; p++)
+    {
+        if (!io->need[p])
+            continue;
+
+        if (io->status[d] == ESRCH)
+            return ESRCH;
+
+        if (io->status[d++] != LIBHACK_OK)
+        {
+            bad_pages[p / 8] |= (unsigned char)(1 << (p % 8));
+            status = EFAULT;
+        }
+    }
+
+    return status;
+}
+
+static bool libhack_snapshot_region_wanted(const struct libhack_region *region)
+{
+    return libhack_region_readable(region) && region->perms[1] == 'w';
+}
+
+struct libhack_snapshot *libhack_snapshot_create(struct libhack_handle *handle, const char *dir)
+{
+    struct libhack_snapshot *snap;
+    long page = sysconf(_SC_PAGESIZE);
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, NULL);
+
+    if (!dir)
+        dir = getenv("TMPDIR");
+
+    if (!dir || !*dir)
+        dir = "/tmp";
+
+    snap = (struct libhack_snapshot *)calloc(1, sizeof(struct libhack_snapshot));
+    if (!snap)
+        return NULL;
+
+    snap->fd = libhack_snapshot_open_spill(dir);
+    if (snap->fd < 0)
+    {
+        libhack_err("failed to create snapshot spill file in %s: %d", dir, errno);
+        free(snap);
+        return NULL;
+    }
+
+    snap->handle = handle;
+    snap->page = page > 0 ? (size_t)page : 4096;
+
+    return snap;
+}
+
+long libhack_snapshot_track_writes(struct libhack_snapshot *snap, bool enabled)
+{
+    // Sanity checking
+    libhack_assert_or_return(snap != NULL, -1);
+
+    if (enabled && !libhack_pagemap_soft_dirty_supported())
+        return ENOTSUP;
+
+    snap->track_writes = enabled;
+    snap->tracking = false;
+    snap->rearm = false;
+
+    return LIBHACK_OK;
+}
+
+long libhack_snapshot_take(struct libhack_snapshot *snap)
+{
+    struct libhack_snapshot_page *pages = NULL;
+    struct libhack_snapshot_stats stats;
+    const struct libhack_maps *maps;
+    unsigned char *buffer = NULL;
+    unsigned char *bad_pages = NULL;
+    unsigned char *carried = NULL;
+    struct libhack_snapshot_io io = {0};
+    size_t chunk_pages = LIBHACK_SCAN_CHUNK / snap->page;
+    bool incremental = snap->tracking && !snap->rearm && snap->page_count > 0;
+    bool tracking = snap->tracking && !snap->rearm;
+    size_t cursor = 0;
+    size_t old_slots;
+    size_t total = 0;
+    size_t count = 0;
+    size_t old = 0;
+    long status = LIBHACK_OK;
+
+    // Sanity checking
+    libhack_assert_or_return(snap != NULL, -1);
+
+    if (libhack_maps_update(snap->handle, NULL) != LIBHACK_OK)
+        return ESRCH;
+
+    maps = libhack_get_maps(snap->handle);
+    if (!maps)
+        return ESRCH;
+
+    for (size_t i = 0; i < maps->count; i++)
+    {
+        if (libhack_snapshot_region_wanted(&maps->regions[i]))
+            total += (size_t)((maps->regions[i].end - maps->regions[i].start) / snap->page);
+    }
+
+    // Slots of the previous snapshot still referenced by the new one
+    old_slots = snap->slot_count;
+    carried = (unsigned char *)calloc(old_slots / 8 + 1, 1);
+    pages = (struct libhack_snapshot_page *)malloc((total + 1) * sizeof(struct libhack_snapshot_page));
+    buffer = (unsigned char *)malloc(LIBHACK_SCAN_CHUNK);
+    bad_pages = (unsigned char *)malloc(libhack_page_bitmap_size(0, LIBHACK_SCAN_CHUNK) + 1);
+    if (!carried || !pages || !buffer || !bad_pages || !libhack_snapshot_io_alloc(&io, chunk_pages))
+    {
+        status = ENOMEM;
+        goto out;
+    }
+
+    memset(&stats, 0, sizeof(stats));
+
+    /*
+     * Bits are only cleared before a full copy: clearing them between two
+     * incremental snapshots would lose the writes done while reading
+     */
+    if (snap->track_writes && !tracking)
+    {
+        status = libhack_pagemap_clear_soft_dirty(snap->handle);
+        if (status == ESRCH)
+            goto out;
+
+        tracking = status == LIBHACK_OK;
+        status = LIBHACK_OK;
+    }
+
+    for (size_t i = 0; i < maps->count; i++)
+    {
+        const struct libhack_region *region = &maps->regions[i];
+
+        if (!libhack_snapshot_region_wanted(region))
+            continue;
+
+        for (DWORD64 addr = region->start; addr < region->end; addr += LIBHACK_SCAN_CHUNK)
+        {
+            size_t len = (size_t)(region->end - addr);
+            size_t needed;
+            long read_status;
+
+            if (len > LIBHACK_SCAN_CHUNK)
+                len = LIBHACK_SCAN_CHUNK;
+
+            needed = len / snap->page;
+
+            if (incremental)
+            {
+                for (size_t p = 0; p < len / snap->page; p++)
+                {
+                    DWORD64 page_addr = addr + p * snap->page;
+
+                    while (cursor < snap->page_count && snap->pages[cursor].addr < page_addr)
+                        cursor++;
+
+                    io.from[p] = cursor < snap->page_count && snap->pages[cursor].addr == page_addr
+                                     ? cursor
+                                     : SIZE_MAX;
+                }
+
+                needed = libhack_snapshot_written(snap, addr, len / snap->page, &io);
+            }
+
+            read_status = libhack_snapshot_read_pages(snap, addr, buffer, len / snap->page, needed,
+                                                      &io, bad_pages);
+            if (read_status == ESRCH)
+            {
+                status = ESRCH;
+                goto out;
+            }
+
+            // Regions may vanish while the snapshot is taken
+            if (read_status != LIBHACK_OK && read_status != EFAULT)
+                continue;
+
+            for (size_t p = 0; p < len / snap->page && count < total; p++)
+            {
+                struct libhack_snapshot_page *entry;
+                const unsigned char *data = buffer + p * snap->page;
+                DWORD64 page_addr = addr + p * snap->page;
+
+                // Pages not written since the bits were cleared keep their copy
+                if (incremental && !io.need[p])
+                {
+                    entry = &pages[count++];
+                    entry->addr = page_addr;
+                    entry->slot = snap->pages[io.from[p]].slot;
+                    stats.clean_pages++;
+
+                    if (entry->slot == SNAPSHOT_ZERO_SLOT)
+                    {
+                        stats.zero_pages++;
+                    }
+                    else
+                    {
+                        carried[entry->slot / 8] |= (unsigned char)(1 << (entry->slot % 8));
+                        stats.shared_pages++;
+                    }
+
+                    continue;
+                }
+
+                if (read_status == EFAULT && (bad_pages[p / 8] & (1 << (p % 8))))
+                    continue;
+
+                entry = &pages[count++];
+                entry->addr = page_addr;
+
+                if (libhack_snapshot_is_zero(data, snap->page))
+                {
+                    entry->slot = SNAPSHOT_ZERO_SLOT;
+                    stats.zero_pages++;
+                    continue;
+                }
+
+                while (old < snap->page_count && snap->pages[old].addr < page_addr)
+                    old++;
+
+                // Unchanged pages keep referencing the copy of the previous snapshot
+                if (old < snap->page_count && snap->pages[old].addr == page_addr &&
+                    snap->pages[old].slot != SNAPSHOT_ZERO_SLOT &&
+                    memcmp(libhack_snapshot_slot(snap, snap->pages[old].slot), data, snap->page) == 0)
+                {
+                    entry->slot = snap->pages[old].slot;
+                    carried[entry->slot / 8] |= (unsigned char)(1 << (entry->slot % 8));
+                    stats.shared_pages++;
+                    continue;
+                }
+
+                status = libhack_snapshot_alloc_slot(snap, &entry->slot);
+                if (status != LIBHACK_OK)
+                {
+                    count--;
+                    goto out;
+                }
+
+                memcpy(libhack_snapshot_slot(snap, entry->slot), data, snap->page);
+                stats.stored_pages++;
+            }
+        }
+    }
+
+    // Copies not carried over are recycled by the next snapshots
+    for (size_t i = 0; i < snap->page_count; i++)
+    {
+        size_t slot = snap->pages[i].slot;
+
+        if (slot != SNAPSHOT_ZERO_SLOT && !(carried[slot / 8] & (1 << (slot % 8))))
+            snap->free_slots[snap->free_count++] = slot;
+    }
+
+    free(snap->pages);
+    snap->pages = pages;
+    snap->page_count = count;
+    pages = NULL;
+
+    stats.pages = count;
+    if (incremental)
+        stats.dirty_pages = stats.pages - stats.clean_pages;
+
+    snap->stats = stats;
+    snap->tracking = tracking;
+
+    // Written pages pile up until the bits are cleared, which only a full copy can do
+    snap->rearm = tracking &&
+                  stats.dirty_pages * 100 > stats.pages * LIBHACK_SNAPSHOT_REARM_PERCENT;
+
+    libhack_debug("snapshot of %d: %zu pages, %zu zero, %zu shared, %zu stored, %zu not read",
+                  snap->handle->pid, stats.pages, stats.zero_pages, stats.shared_pages,
+                  stats.stored_pages, stats.clean_pages);
+
+out:
+    // Give back the slots taken by a snapshot which could not be completed
+    if (pages)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t slot = pages[i].slot;
+
+            if (slot == SNAPSHOT_ZERO_SLOT)
+                continue;
+
+            if (slot < old_slots && (carried[slot / 8] & (1 << (slot % 8))))
+                continue;
+
+            snap->free_slots[snap->free_count++] = slot;
+        }
+    }
+
+    free(pages);
+    free(carried);
+    free(buffer);
+    free(bad_pages);
+    libhack_snapshot_io_free(&io);
+
+    return status;
+}
+
+long libhack_snapshot_compare(struct libhack_snapshot *snap, enum libhack_narrow_op op,
+                              const void *value, struct libhack_candidates *set)
+{
+    enum libhack_value_type type;
+    size_t alignment;
+    size_t size;
+    size_t chunk_pages;
+    unsigned char *cur = NULL;
+    unsigned char *prev = NULL;
+    unsigned char *bad_pages = NULL;
+    signed char *equal = NULL;
+    struct libhack_snapshot_io io = {0};
+    size_t skipped = 0;
+    long status = LIBHACK_OK;
+
+    // Sanity checking
+    libhack_assert_or_return(snap != NULL && set != NULL, -1);
+    libhack_assert_or_return(op != LIBHACK_NARROW_EQUAL || value != NULL, -1);
+
+    type = libhack_candidates_type(set);
+    alignment = libhack_candidates_alignment(set);
+    size = libhack_value_size(type);
+
+    status = libhack_candidates_begin(set);
+    if (status != LIBHACK_OK)
+        return status;
+
+    // One extra page lets values cross the end of a chunk
+    chunk_pages = LIBHACK_SCAN_CHUNK / snap->page;
+    cur = (unsigned char *)malloc((chunk_pages + 1) * snap->page);
+    prev = (unsigned char *)malloc((chunk_pages + 1) * snap->page);
+    bad_pages = (unsigned char *)malloc(libhack_page_bitmap_size(0, (chunk_pages + 1) * snap->page) + 1);
+    equal = (signed char *)malloc(chunk_pages + 1);
+    if (!cur || !prev || !bad_pages || !equal || !libhack_snapshot_io_alloc(&io, chunk_pages + 1))
+    {
+        status = ENOMEM;
+        goto out;
+    }
+
+    for (size_t i = 0; i < snap->page_count;)
+    {
+        DWORD64 base = snap->pages[i].addr;
+        size_t n = 1;
+        size_t extra = 0;
+        size_t needed;
+        size_t len;
+        long read_status;
+
+        while (i + n < snap->page_count && n < chunk_pages &&
+               snap->pages[i + n].addr == base + n * snap->page)
+            n++;
+
+        if (i + n < snap->page_count && snap->pages[i + n].addr == base + n * snap->page)
+            extra = 1;
+
+        len = (n + extra) * snap->page;
+        needed = n + extra;
+
+        if (snap->tracking)
+        {
+            for (size_t p = 0; p < n + extra; p++)
+                io.from[p] = i + p;
+
+            needed = libhack_snapshot_written(snap, base, n + extra, &io);
+        }
+
+        read_status = libhack_snapshot_read_pages(snap, base, cur, n + extra, needed, &io, bad_pages);
+        if (read_status == ESRCH)
+        {
+            status = ESRCH;
+            goto out;
+        }
+
+        if (read_status != LIBHACK_OK && read_status != EFAULT)
+        {
+            i += n;
+            continue;
+        }
+
+        for (size_t p = 0; p < n + extra; p++)
+        {
+            const struct libhack_snapshot_page *page = &snap->pages[i + p];
+            bool clean = needed < n + extra && !io.need[p];
+
+            /*
+             * Unread pages are only looked at by values crossing into a page
+             * which was read, unless the matches keep their value
+             */
+            if (clean && op != LIBHACK_NARROW_EQUAL && op != LIBHACK_NARROW_UNCHANGED &&
+                (p == 0 || !io.need[p - 1]) &&
+                (p + 1 == n + extra || !io.need[p + 1]))
+            {
+                equal[p] = 1;
+                skipped += p < n;
+                continue;
+            }
+
+            if (page->slot == SNAPSHOT_ZERO_SLOT)
+                memset(prev + p * snap->page, 0, snap->page);
+            else
+                memcpy(prev + p * snap->page, libhack_snapshot_slot(snap, page->slot), snap->page);
+
+            if (clean)
+            {
+                memcpy(cur + p * snap->page, prev + p * snap->page, snap->page);
+                equal[p] = 1;
+                skipped += p < n;
+            }
+            else if (read_status == EFAULT && (bad_pages[p / 8] & (1 << (p % 8))))
+                equal[p] = -1;
+            else
+                equal[p] = memcmp(prev + p * snap->page, cur + p * snap->page, snap->page) == 0;
+        }
+
+        for (size_t offset = (alignment - base % alignment) % alignment;
+             offset < n * snap->page && offset + size <= len; offset += alignment)
+        {
+            size_t first = offset / snap->page;
+            size_t last = (offset + size - 1) / snap->page;
+
+            if (equal[first] < 0 || equal[last] < 0)
+                continue;
+
+            // Values inside untouched pages are decided without comparing them
+            if (equal[first] && equal[last] && op != LIBHACK_NARROW_EQUAL)
+            {
+                if (op != LIBHACK_NARROW_UNCHANGED)
+                {
+                    size_t page_last = (first + 1) * snap->page - size;
+
+                    // Jump to the last value starting in the page
+                    if (first == last && page_last > offset)
+                        offset += (page_last - offset) / alignment * alignment;
+
+                    continue;
+                }
+            }
+            else if (!libhack_narrow_test(type, op, prev + offset, cur + offset, value))
+            {
+                continue;
+            }
+
+            status = libhack_candidates_append(set, base + offset, cur + offset);
+            if (status != LIBHACK_OK)
+                goto out;
+        }
+
+        i += n;
+    }
+
+    status = libhack_candidates_end(set);
+    if (status != LIBHACK_OK)
+        goto out;
+
+    libhack_debug("snapshot comparison found %zu addresses on %d, %zu pages not read",
+                  libhack_candidates_count(set), snap->handle->pid, skipped);
+
+out:
+    // Leave nothing half-filled behind
+    if (status != LIBHACK_OK)
+        libhack_candidates_load(set, NULL, 0);
+
+    free(cur);
+    free(prev);
+    free(bad_pages);
+    free(equal);
+    libhack_snapshot_io_free(&io);
+
+    return status;
+}
+
+void libhack_snapshot_get_stats(const struct libhack_snapshot *snap,
+                                struct libhack_snapshot_stats *stats)
+{
+    if (!snap || !stats)
+        return;
+
+    *stats = snap->stats;
+    stats->file_size = snap->slot_capacity * snap->page;
+}
+
+void libhack_snapshot_free(struct libhack_snapshot *snap)
+{
+    if (!snap)
+        return;
+
+    if (snap->map)
+        munmap(snap->map, snap->slot_capacity * snap->page);
+
+    close(snap->fd);
+    free(snap->free_slots);
+    free(snap->pages);
+    free(snap);
+}
+
+#endif // __linux__
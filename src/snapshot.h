@@ -0,0 +1,178 @@
+/**
+ * @file snapshot.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Snapshots of writable memory for unknown initial value scans
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_SNAPSHOT_H
+#define LIBHACK_SNAPSHOT_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "candidates.h"
+#include "init.h"
+#include "scan.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Share of written pages above which the next snapshot clears the soft-dirty bits again
+ *
+ */
+#define LIBHACK_SNAPSHOT_REARM_PERCENT 50
+
+/**
+ * @brief Copy of every writable page of a process
+ *
+ * Page contents live in a spill file mapped in memory, so the kernel can
+ * write them back to disk instead of keeping them in RAM. Zero pages are not
+ * stored and pages which did not change since the previous snapshot share
+ * the copy taken by it.
+ *
+ */
+struct libhack_snapshot;
+
+/**
+ * @brief Storage used by a snapshot
+ *
+ */
+struct libhack_snapshot_stats
+{
+	/**
+	 * @brief Number of pages in the snapshot
+	 *
+	 */
+	size_t pages;
+
+	/**
+	 * @brief Pages holding only zeros (not stored)
+	 *
+	 */
+	size_t zero_pages;
+
+	/**
+	 * @brief Pages shared with the previous snapshot
+	 *
+	 */
+	size_t shared_pages;
+
+	/**
+	 * @brief Pages copied to the spill file by the last snapshot
+	 *
+	 */
+	size_t stored_pages;
+
+	/**
+	 * @brief Pages kept from the previous snapshot without reading them (write tracking)
+	 *
+	 */
+	size_t clean_pages;
+
+	/**
+	 * @brief Pages written since the soft-dirty bits were cleared, which snapshots and
+	 * comparisons read again (write tracking)
+	 *
+	 */
+	size_t dirty_pages;
+
+	/**
+	 * @brief Size of the spill file in bytes
+	 *
+	 */
+	size_t file_size;
+};
+
+/**
+ * @brief Creates an empty snapshot bound to a handle
+ *
+ * @param handle Handle to libhack
+ * @param dir Directory of the spill file (NULL uses TMPDIR or /tmp)
+ * @return struct libhack_snapshot* Snapshot or NULL on error
+ */
+struct libhack_snapshot *libhack_snapshot_create(struct libhack_handle *handle, const char *dir);
+
+/**
+ * @brief Enables or disables tracking of the pages written by the process
+ *
+ * With tracking enabled, the next snapshot clears the soft-dirty bits of the
+ * process before copying it. From then on, comparisons and new snapshots only
+ * read the pages written since that snapshot, taking the others from the
+ * copy. The bits are not cleared between two of these snapshots, since writes
+ * done while one is read would be lost, so the written pages keep piling up:
+ * once they exceed LIBHACK_SNAPSHOT_REARM_PERCENT of the snapshot, the next
+ * snapshot is a full one which clears the bits again. Calling this again
+ * (with any value) also makes the next snapshot a full one.
+ *
+ * Clearing the bits also affects other users of them, such as checkpointing
+ * tools attached to the same process.
+ *
+ * @param snap Snapshot
+ * @param enabled true to track written pages
+ * @return long LIBHACK_OK on success, ENOTSUP if the kernel does not track soft-dirty bits or errno value
+ */
+long libhack_snapshot_track_writes(struct libhack_snapshot *snap, bool enabled);
+
+/**
+ * @brief Copies every writable region of the process
+ *
+ * This is the first pass of an unknown initial value scan. Calling it again
+ * replaces the snapshot by the current memory, sharing unchanged pages.
+ *
+ * @param snap Snapshot
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_snapshot_take(struct libhack_snapshot *snap);
+
+/**
+ * @brief Compares the current memory against the snapshot
+ *
+ * Memory is streamed in chunks of LIBHACK_SCAN_CHUNK bytes; the snapshot is
+ * left untouched. Matches are encoded into the candidate set as they are
+ * found, block by block, so a pass matching most of the memory costs a
+ * bitmap and the current values instead of a list of addresses. The set is
+ * then narrowed by the following passes.
+ *
+ * @param snap Snapshot
+ * @param op Condition
+ * @param value New value for LIBHACK_NARROW_EQUAL (ignored otherwise)
+ * @param set Candidate set replaced by the matches, which gives the type and alignment of the values
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_snapshot_compare(struct libhack_snapshot *snap, enum libhack_narrow_op op,
+							  const void *value, struct libhack_candidates *set);
+
+/**
+ * @brief Gets the storage used by a snapshot
+ *
+ * @param snap Snapshot
+ * @param stats Receives the statistics
+ */
+void libhack_snapshot_get_stats(const struct libhack_snapshot *snap,
+								struct libhack_snapshot_stats *stats);
+
+/**
+ * @brief Releases a snapshot and its spill file
+ *
+ * @param snap Snapshot
+ */
+void libhack_snapshot_free(struct libhack_snapshot *snap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_SNAPSHOT_H
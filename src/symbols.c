@@ -0,0 +1,823 @@
+/**
+ * @file symbols.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Resolution of ELF symbols exported by the modules of the process
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <elf.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "logger.h"
+#include "maps.h"
+#include "process.h"
+#include "status_codes.h"
+#include "symbols.h"
+
+/**
+ * @brief Words of the .gnu.hash chain array read at once
+ *
+ */
+#define SYMBOLS_CHAIN_BLOCK 256
+
+/**
+ * @brief Copy of the dynamic symbols of a module
+ *
+ */
+struct libhack_symbol_module
+{
+	/**
+	 * @brief Pathname of the module
+	 *
+	 */
+	char *path;
+
+	/**
+	 * @brief Load address the copy was taken from
+	 *
+	 */
+	DWORD64 base;
+
+	/**
+	 * @brief ELF header found at base when the copy was taken
+	 *
+	 */
+	Elf64_Ehdr header;
+
+	/**
+	 * @brief Result of building the copy (modules which are not ELF images fail once)
+	 *
+	 */
+	long status;
+
+	/**
+	 * @brief Difference between runtime addresses and ELF virtual addresses
+	 *
+	 */
+	DWORD64 bias;
+
+	/**
+	 * @brief Dynamic symbol table
+	 *
+	 */
+	Elf64_Sym *symtab;
+
+	/**
+	 * @brief Number of symbols
+	 *
+	 */
+	size_t nsyms;
+
+	/**
+	 * @brief Dynamic string table
+	 *
+	 */
+	char *strtab;
+
+	/**
+	 * @brief Size of strtab
+	 *
+	 */
+	size_t strsz;
+
+	/**
+	 * @brief Version index of every symbol (NULL if the module is not versioned)
+	 *
+	 */
+	uint16_t *versym;
+
+	/**
+	 * @brief .gnu.hash table (NULL if the module only has a SysV hash table)
+	 *
+	 */
+	uint32_t *gnu_hash;
+
+	/**
+	 * @brief Bloom filter words of the .gnu.hash table
+	 *
+	 */
+	const uint64_t *bloom;
+
+	/**
+	 * @brief Buckets of the .gnu.hash table
+	 *
+	 */
+	const uint32_t *buckets;
+
+	/**
+	 * @brief Chain of hashes of the .gnu.hash table, starting at symoffset
+	 *
+	 */
+	uint32_t *chains;
+
+	/**
+	 * @brief SysV .hash table: nbucket, nchain, buckets and chains
+	 *
+	 */
+	uint32_t *sysv_hash;
+};
+
+struct libhack_symbols
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Modules indexed so far
+	 *
+	 */
+	struct libhack_symbol_module *modules;
+
+	/**
+	 * @brief Number of modules
+	 *
+	 */
+	size_t count;
+};
+
+static uint32_t libhack_symbols_gnu_hash(const char *name)
+{
+    uint32_t hash = 5381;
+
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++)
+        hash = hash * 33 + *p;
+
+    return hash;
+}
+
+static uint32_t libhack_symbols_sysv_hash(const char *name)
+{
+    uint32_t hash = 0;
+
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++)
+    {
+        uint32_t high;
+
+        hash = (hash << 4) + *p;
+        high = hash & 0xf0000000;
+        if (high)
+            hash ^= high >> 24;
+
+        hash &= ~high;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Reads a whole range from the process
+ *
+ * @param handle Handle to libhack
+ * @param addr Remote address
+ * @param buffer Local buffer
+ * @param len Number of bytes
+ * @return long LIBHACK_OK if every byte was read or errno value
+ */
+static long libhack_symbols_read(struct libhack_handle *handle, DWORD64 addr, void *buffer,
+                                 size_t len)
+{
+    long status = libhack_read_bytes(handle, addr, buffer, len, NULL);
+
+    return status == EFAULT ? EIO : status;
+}
+
+/**
+ * @brief Reads a remote range into a new allocation
+ *
+ * @param handle Handle to libhack
+ * @param addr Remote address
+ * @param len Number of bytes
+ * @param status Receives LIBHACK_OK or errno value
+ * @return void* Local copy or NULL on error
+ */
+static void *libhack_symbols_copy(struct libhack_handle *handle, DWORD64 addr, size_t len,
+                                  long *status)
+{
+    void *buffer = malloc(len ? len : 1);
+
+    if (!buffer)
+    {
+        *status = ENOMEM;
+        return NULL;
+    }
+
+    *status = libhack_symbols_read(handle, addr, buffer, len);
+    if (*status != LIBHACK_OK)
+    {
+        free(buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief Releases the tables of a module, keeping its identity
+ *
+ * @param entry Module
+ */
+static void libhack_symbols_clear(struct libhack_symbol_module *entry)
+{
+    free(entry->symtab);
+    free(entry->strtab);
+    free(entry->versym);
+    free(entry->gnu_hash);
+    free(entry->chains);
+    free(entry->sysv_hash);
+
+    entry->symtab = NULL;
+    entry->strtab = NULL;
+    entry->versym = NULL;
+    entry->gnu_hash = NULL;
+    entry->bloom = NULL;
+    entry->buckets = NULL;
+    entry->chains = NULL;
+    entry->sysv_hash = NULL;
+    entry->nsyms = 0;
+    entry->strsz = 0;
+}
+
+/**
+ * @brief Copies the .gnu.hash table and counts the symbols it covers
+ *
+ * The table does not store the number of symbols: it is found by walking the
+ * chain of the highest bucket up to its terminating entry.
+ *
+ * @param handle Handle to libhack
+ * @param entry Module
+ * @param addr Remote address of the table
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_symbols_load_gnu_hash(struct libhack_handle *handle,
+                                          struct libhack_symbol_module *entry, DWORD64 addr)
+{
+    uint32_t header[4];
+    size_t table_len;
+    uint32_t nbuckets;
+    uint32_t symoffset;
+    uint32_t last = 0;
+    size_t nchains = 0;
+    size_t capacity = 0;
+    const struct libhack_region *region = libhack_maps_find(handle->maps, addr);
+    DWORD64 pos;
+    size_t words;
+    long status;
+
+    status = libhack_symbols_read(handle, addr, header, sizeof(header));
+    if (status != LIBHACK_OK)
+        return status;
+
+    nbuckets = header[0];
+    symoffset = header[1];
+    if (nbuckets == 0 || header[2] == 0 || (header[2] & (header[2] - 1)) != 0)
+        return ENOEXEC;
+
+    table_len = sizeof(header) + header[2] * sizeof(uint64_t) + nbuckets * sizeof(uint32_t);
+    entry->gnu_hash = (uint32_t *)libhack_symbols_copy(handle, addr, table_len, &status);
+    if (!entry->gnu_hash)
+        return status;
+
+    entry->bloom = (const uint64_t *)(entry->gnu_hash + 4);
+    entry->buckets = (const uint32_t *)(entry->bloom + header[2]);
+
+    for (uint32_t i = 0; i < nbuckets; i++)
+    {
+        if (entry->buckets[i] > last)
+            last = entry->buckets[i];
+    }
+
+    if (last < symoffset)
+    {
+        entry->nsyms = symoffset;
+        return LIBHACK_OK;
+    }
+
+    // Chains of the buckets are laid out in order, so the last one ends the table
+    for (;;)
+    {
+        if (nchains == capacity)
+        {
+            uint32_t *chains;
+
+            capacity += SYMBOLS_CHAIN_BLOCK;
+            chains = (uint32_t *)realloc(entry->chains, capacity * sizeof(uint32_t));
+            if (!chains)
+                return ENOMEM;
+
+            entry->chains = chains;
+
+            // Never read past the region holding the table
+            pos = addr + table_len + nchains * sizeof(uint32_t);
+            words = region && region->end > pos ? (size_t)(region->end - pos) / sizeof(uint32_t) : 0;
+            if (words == 0)
+                return ENOEXEC;
+
+            if (words > SYMBOLS_CHAIN_BLOCK)
+                words = SYMBOLS_CHAIN_BLOCK;
+
+            status = libhack_symbols_read(handle, pos, entry->chains + nchains,
+                                          words * sizeof(uint32_t));
+            if (status != LIBHACK_OK)
+                return status;
+
+            capacity = nchains + words;
+        }
+
+        if (symoffset + nchains >= last && (entry->chains[nchains] & 1))
+            break;
+
+        nchains++;
+    }
+
+    entry->nsyms = symoffset + nchains + 1;
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Copies the dynamic symbols of a module loaded at base
+ *
+ * @param handle Handle to libhack
+ * @param entry Module
+ * @param module Module as found in the region table
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_symbols_load(struct libhack_handle *handle, struct libhack_symbol_module *entry,
+                                 const struct libhack_module *module)
+{
+    Elf64_Ehdr ehdr;
+    Elf64_Phdr *phdrs;
+    Elf64_Dyn *dyn = NULL;
+    DWORD64 dyn_addr = 0;
+    size_t dyn_count = 0;
+    DWORD64 min_vaddr = (DWORD64)-1;
+    DWORD64 first_vaddr = 0;
+    DWORD64 symtab = 0, strtab = 0, gnu_hash = 0, sysv_hash = 0, versym = 0;
+    size_t strsz = 0;
+    size_t syment = sizeof(Elf64_Sym);
+    long status;
+
+    status = libhack_symbols_read(handle, module->base, &ehdr, sizeof(ehdr));
+    if (status != LIBHACK_OK)
+        return status;
+
+    if (memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0)
+        return ENOEXEC;
+
+    entry->header = ehdr;
+
+    if (ehdr.e_ident[EI_CLASS] != ELFCLASS64 || ehdr.e_phentsize != sizeof(Elf64_Phdr))
+    {
+        libhack_debug("%s is not a 64-bit ELF image", module->path);
+        return ENOEXEC;
+    }
+
+    phdrs = (Elf64_Phdr *)libhack_symbols_copy(handle, module->base + ehdr.e_phoff,
+                                               ehdr.e_phnum * sizeof(Elf64_Phdr), &status);
+    if (!phdrs)
+        return status;
+
+    // The module base maps the lowest loadable segment
+    for (size_t i = 0; i < ehdr.e_phnum; i++)
+    {
+        if (phdrs[i].p_type == PT_LOAD && phdrs[i].p_vaddr < min_vaddr)
+        {
+            min_vaddr = phdrs[i].p_vaddr;
+            first_vaddr = phdrs[i].p_vaddr - phdrs[i].p_offset;
+        }
+
+        if (phdrs[i].p_type == PT_DYNAMIC)
+        {
+            dyn_addr = phdrs[i].p_vaddr;
+            dyn_count = phdrs[i].p_memsz / sizeof(Elf64_Dyn);
+        }
+    }
+
+    free(phdrs);
+
+    if (min_vaddr == (DWORD64)-1 || dyn_count == 0)
+        return ENOEXEC;
+
+    entry->bias = module->base - first_vaddr;
+
+    dyn = (Elf64_Dyn *)libhack_symbols_copy(handle, entry->bias + dyn_addr,
+                                            dyn_count * sizeof(Elf64_Dyn), &status);
+    if (!dyn)
+        return status;
+
+    for (size_t i = 0; i < dyn_count && dyn[i].d_tag != DT_NULL; i++)
+    {
+        DWORD64 ptr = dyn[i].d_un.d_ptr;
+
+        // The loader relocates the dynamic section in place on most architectures
+        if (ptr < module->base || ptr >= module->end)
+            ptr += entry->bias;
+
+        switch (dyn[i].d_tag)
+        {
+        case DT_SYMTAB:
+            symtab = ptr;
+            break;
+        case DT_STRTAB:
+            strtab = ptr;
+            break;
+        case DT_STRSZ:
+            strsz = dyn[i].d_un.d_val;
+            break;
+        case DT_SYMENT:
+            syment = dyn[i].d_un.d_val;
+            break;
+        case DT_GNU_HASH:
+            gnu_hash = ptr;
+            break;
+        case DT_HASH:
+            sysv_hash = ptr;
+            break;
+        case DT_VERSYM:
+            versym = ptr;
+            break;
+        default:
+            break;
+        }
+    }
+
+    free(dyn);
+
+    if (!symtab || !strtab || !strsz || syment != sizeof(Elf64_Sym) || (!gnu_hash && !sysv_hash))
+        return ENOEXEC;
+
+    if (gnu_hash)
+    {
+        status = libhack_symbols_load_gnu_hash(handle, entry, gnu_hash);
+        if (status != LIBHACK_OK)
+            return status;
+    }
+    else
+    {
+        uint32_t header[2];
+
+        status = libhack_symbols_read(handle, sysv_hash, header, sizeof(header));
+        if (status != LIBHACK_OK)
+            return status;
+
+        entry->sysv_hash = (uint32_t *)libhack_symbols_copy(
+            handle, sysv_hash, (2 + (size_t)header[0] + header[1]) * sizeof(uint32_t), &status);
+        if (!entry->sysv_hash)
+            return status;
+
+        entry->nsyms = header[1];
+    }
+
+    entry->symtab = (Elf64_Sym *)libhack_symbols_copy(handle, symtab,
+                                                      entry->nsyms * sizeof(Elf64_Sym), &status);
+    if (!entry->symtab)
+        return status;
+
+    entry->strtab = (char *)malloc(strsz + 1);
+    if (!entry->strtab)
+        return ENOMEM;
+
+    status = libhack_symbols_read(handle, strtab, entry->strtab, strsz);
+    if (status != LIBHACK_OK)
+        return status;
+
+    entry->strtab[strsz] = '\0';
+    entry->strsz = strsz;
+
+    if (versym)
+    {
+        entry->versym = (uint16_t *)libhack_symbols_copy(handle, versym,
+                                                         entry->nsyms * sizeof(uint16_t), &status);
+        if (!entry->versym)
+            return status;
+    }
+
+    libhack_debug("indexed %zu symbols of %s (%s)", entry->nsyms, module->name,
+                  gnu_hash ? ".gnu.hash" : ".hash");
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Checks a symbol of a module against a name
+ *
+ * @param entry Module
+ * @param index Symbol index
+ * @param name Symbol name
+ * @return int 0 if it does not match, 1 for a hidden version, 2 for a default one
+ */
+static int libhack_symbols_match(const struct libhack_symbol_module *entry, size_t index,
+                                 const char *name)
+{
+    const Elf64_Sym *sym;
+
+    if (index >= entry->nsyms)
+        return 0;
+
+    sym = &entry->symtab[index];
+    if (sym->st_shndx == SHN_UNDEF || sym->st_name >= entry->strsz ||
+        ELF64_ST_TYPE(sym->st_info) == STT_TLS)
+        return 0;
+
+    if (strcmp(entry->strtab + sym->st_name, name) != 0)
+        return 0;
+
+    if (entry->versym && (entry->versym[index] & 0x8000))
+        return 1;
+
+    return 2;
+}
+
+/**
+ * @brief Looks a name up in the hash table of a module
+ *
+ * @param entry Module with its tables loaded
+ * @param name Symbol name
+ * @param addr Receives the runtime address
+ * @return bool true if the module exports the symbol
+ */
+static bool libhack_symbols_find(const struct libhack_symbol_module *entry, const char *name,
+                                 DWORD64 *addr)
+{
+    size_t found = 0;
+    int best = 0;
+
+    if (entry->gnu_hash)
+    {
+        uint32_t hash = libhack_symbols_gnu_hash(name);
+        uint32_t nbuckets = entry->gnu_hash[0];
+        uint32_t symoffset = entry->gnu_hash[1];
+        uint32_t bloom_size = entry->gnu_hash[2];
+        uint32_t shift = entry->gnu_hash[3];
+        uint64_t word = entry->bloom[(hash / 64) & (bloom_size - 1)];
+        uint64_t bits = (1ULL << (hash % 64)) | (1ULL << ((hash >> shift) % 64));
+
+        if ((word & bits) != bits)
+            return false;
+
+        for (size_t i = entry->buckets[hash % nbuckets]; i >= symoffset && i < entry->nsyms; i++)
+        {
+            uint32_t chain = entry->chains[i - symoffset];
+
+            if ((chain | 1) == (hash | 1))
+            {
+                int match = libhack_symbols_match(entry, i, name);
+
+                if (match > best)
+                {
+                    best = match;
+                    found = i;
+                }
+            }
+
+            if (chain & 1)
+                break;
+        }
+    }
+    else
+    {
+        uint32_t nbucket = entry->sysv_hash[0];
+        uint32_t nchain = entry->sysv_hash[1];
+        const uint32_t *buckets = entry->sysv_hash + 2;
+        const uint32_t *chains = buckets + nbucket;
+
+        if (nbucket == 0)
+            return false;
+
+        for (uint32_t i = buckets[libhack_symbols_sysv_hash(name) % nbucket];
+             i != STN_UNDEF && i < nchain; i = chains[i])
+        {
+            int match = libhack_symbols_match(entry, i, name);
+
+            if (match > best)
+            {
+                best = match;
+                found = i;
+            }
+        }
+    }
+
+    if (best == 0)
+        return false;
+
+    *addr = entry->bias + entry->symtab[found].st_value;
+
+    return true;
+}
+
+/**
+ * @brief Gets the symbols of a module, copying them if needed
+ *
+ * @param symbols Symbol index
+ * @param module Module as found in the region table
+ * @param entry Receives the indexed module
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_symbols_module(struct libhack_symbols *symbols,
+                                   const struct libhack_module *module,
+                                   struct libhack_symbol_module **entry)
+{
+    struct libhack_symbol_module *found = NULL;
+
+    for (size_t i = 0; i < symbols->count; i++)
+    {
+        if (strcmp(symbols->modules[i].path, module->path) == 0)
+        {
+            found = &symbols->modules[i];
+            break;
+        }
+    }
+
+    if (found && found->base == module->base)
+    {
+        *entry = found;
+        return found->status;
+    }
+
+    if (!found)
+    {
+        struct libhack_symbol_module *modules = (struct libhack_symbol_module *)realloc(
+            symbols->modules, (symbols->count + 1) * sizeof(struct libhack_symbol_module));
+        if (!modules)
+            return ENOMEM;
+
+        symbols->modules = modules;
+        found = &modules[symbols->count];
+        memset(found, 0, sizeof(*found));
+
+        found->path = strdup(module->path);
+        if (!found->path)
+            return ENOMEM;
+
+        symbols->count++;
+    }
+
+    // First lookup, or the module was reloaded somewhere else
+    libhack_symbols_clear(found);
+    found->base = module->base;
+    found->status = libhack_symbols_load(symbols->handle, found, module);
+    if (found->status != LIBHACK_OK)
+        libhack_symbols_clear(found);
+
+    *entry = found;
+
+    return found->status;
+}
+
+struct libhack_symbols *libhack_symbols_create(struct libhack_handle *handle)
+{
+    struct libhack_symbols *symbols;
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, NULL);
+
+    symbols = (struct libhack_symbols *)calloc(1, sizeof(struct libhack_symbols));
+    if (!symbols)
+        return NULL;
+
+    symbols->handle = handle;
+
+    return symbols;
+}
+
+/**
+ * @brief Checks that a module still lies where its copy was taken from
+ *
+ * A module unloaded and loaded again elsewhere keeps its old base in a region
+ * table which was not refreshed since. Reading its ELF header again tells if
+ * something else, or nothing, is mapped there now; the copy is then dropped.
+ *
+ * @param symbols Symbol index
+ * @param entry Indexed module
+ * @return long LIBHACK_OK if the module did not move, ESTALE otherwise
+ */
+static long libhack_symbols_check(struct libhack_symbols *symbols,
+                                  struct libhack_symbol_module *entry)
+{
+    Elf64_Ehdr ehdr;
+
+    if (libhack_symbols_read(symbols->handle, entry->base, &ehdr, sizeof(ehdr)) == LIBHACK_OK &&
+        memcmp(&ehdr, &entry->header, sizeof(ehdr)) == 0)
+        return LIBHACK_OK;
+
+    // Copied again on the next lookup, from the base found by then
+    entry->base = 0;
+
+    return ESTALE;
+}
+
+/**
+ * @brief Looks a symbol up in the modules of a region table
+ *
+ * @param symbols Symbol index
+ * @param maps Region table
+ * @param module File name or pathname of the module (NULL searches every module)
+ * @param name Symbol name
+ * @param addr Receives the address
+ * @return long LIBHACK_OK on success, ESTALE if the module holding the symbol
+ * moved, ENOENT if the symbol is not exported or errno value
+ */
+static long libhack_symbols_search(struct libhack_symbols *symbols,
+                                   const struct libhack_maps *maps, const char *module,
+                                   const char *name, DWORD64 *addr)
+{
+    struct libhack_symbol_module *entry;
+    long status;
+
+    if (module)
+    {
+        const struct libhack_module *found = libhack_maps_find_module(maps, module);
+
+        if (!found)
+            return ENOENT;
+
+        status = libhack_symbols_module(symbols, found, &entry);
+        if (status != LIBHACK_OK)
+            return status;
+
+        if (!libhack_symbols_find(entry, name, addr))
+            return ENOENT;
+
+        return libhack_symbols_check(symbols, entry);
+    }
+
+    // Address order, which may differ from the global scope of the loader
+    for (size_t i = 0; i < maps->module_count; i++)
+    {
+        status = libhack_symbols_module(symbols, &maps->modules[i], &entry);
+        if (status == ESRCH)
+            return status;
+
+        if (status == LIBHACK_OK && libhack_symbols_find(entry, name, addr))
+            return libhack_symbols_check(symbols, entry);
+    }
+
+    return ENOENT;
+}
+
+long libhack_symbols_lookup(struct libhack_symbols *symbols, const char *module,
+                            const char *name, DWORD64 *addr)
+{
+    const struct libhack_maps *maps;
+    bool changed = false;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(symbols != NULL && name != NULL && addr != NULL, -1);
+
+    maps = libhack_get_maps(symbols->handle);
+    if (!maps)
+        return ESRCH;
+
+    status = libhack_symbols_search(symbols, maps, module, name, addr);
+
+    /*
+     * The module may have been loaded, or loaded again elsewhere, after the
+     * region table was built
+     */
+    if (status == ESTALE || (status == ENOENT && module))
+    {
+        long update = libhack_maps_update(symbols->handle, &changed);
+
+        if (update != LIBHACK_OK)
+            return status == ESTALE ? update : status;
+
+        if (changed || status == ESTALE)
+            status = libhack_symbols_search(symbols, symbols->handle->maps, module, name, addr);
+    }
+
+    return status;
+}
+
+void libhack_symbols_free(struct libhack_symbols *symbols)
+{
+    if (!symbols)
+        return;
+
+    for (size_t i = 0; i < symbols->count; i++)
+    {
+        libhack_symbols_clear(&symbols->modules[i]);
+        free(symbols->modules[i].path);
+    }
+
+    free(symbols->modules);
+    free(symbols);
+}
+
+#endif // __linux__
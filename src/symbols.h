@@ -0,0 +1,84 @@
+/**
+ * @file symbols.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Resolution of ELF symbols exported by the modules of the process
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_SYMBOLS_H
+#define LIBHACK_SYMBOLS_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Per module symbol indexes of a process
+ *
+ * The dynamic symbol table, string table and hash table (.gnu.hash, or the
+ * SysV .hash when it is missing) of a module are copied from the process
+ * memory the first time a symbol of that module is looked up. Later lookups
+ * are answered locally and the copy is only rebuilt when the module is
+ * loaded at a different address.
+ *
+ */
+struct libhack_symbols;
+
+/**
+ * @brief Creates an empty symbol index bound to a handle
+ *
+ * @param handle Handle to libhack
+ * @return struct libhack_symbols* Symbol index or NULL on error
+ */
+struct libhack_symbols *libhack_symbols_create(struct libhack_handle *handle);
+
+/**
+ * @brief Gets the runtime address of a symbol exported by a module
+ *
+ * Default versions are preferred over hidden ones when a symbol has several
+ * versions. For STT_GNU_IFUNC symbols the address of the resolver is returned.
+ *
+ * Modules are taken from the region table of the handle. The ELF header of
+ * the module holding the symbol is read again to check that it was not
+ * reloaded elsewhere since the table was built; the table is refreshed if it
+ * was, or if the module is not found in it.
+ *
+ * Without a module, every module is searched in address order, which is not
+ * the global scope of the loader: a definition interposed by an earlier
+ * library (LD_PRELOAD) may lose to one of a library mapped below it.
+ *
+ * @param symbols Symbol index
+ * @param module File name or pathname of the module (NULL searches every module)
+ * @param name Symbol name
+ * @param addr Receives the address
+ * @return long LIBHACK_OK on success, ENOENT if the symbol is not exported,
+ * ESTALE if the module moved again while it was looked up or errno value
+ */
+long libhack_symbols_lookup(struct libhack_symbols *symbols, const char *module,
+                            const char *name, DWORD64 *addr);
+
+/**
+ * @brief Releases a symbol index
+ *
+ * @param symbols Symbol index
+ */
+void libhack_symbols_free(struct libhack_symbols *symbols);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_SYMBOLS_H
@@ -1,4 +1,816 @@
+#include <stdlib.h>
+#include <string.h>
 #include "init.h"
+#ifdef __linux__
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "candidates.h"
+#include "compare.h"
+#include "consts.h"
+#include "process.h"
+#include "signature.h"
+#include "snapshot.h"
+#include "status_codes.h"
+#endif
+
+#ifdef __linux__
+/**
+ * @brief Checks every SIMD kernel against the scalar reference
+ *
+ * @return int 0 if every kernel agrees with the scalar one
+ */
+static int test_compare_kernels()
+{
+    const size_t count = 1000;
+    const size_t strides[] = {1, 2, 3, 4, 8, 12};
+    enum libhack_simd_level best = libhack_simd_detect();
+    unsigned char *buffer = (unsigned char *)malloc(count * 12 + 8);
+    uint64_t expected[(1000 + 63) / 64];
+    uint64_t mask[(1000 + 63) / 64];
+    int failed = 0;
+
+    if (!buffer)
+        return 1;
+
+    srand(1234);
+
+    for (int type = LIBHACK_TYPE_INT8; type <= LIBHACK_TYPE_DOUBLE; type++)
+    {
+        size_t size = libhack_value_size((enum libhack_value_type)type);
+
+        for (size_t s = 0; s < sizeof(strides) / sizeof(strides[0]); s++)
+        {
+            size_t stride = strides[s];
+
+            for (int op = LIBHACK_CMP_EQ; op <= LIBHACK_CMP_RANGE; op++)
+            {
+                struct libhack_compare cmp;
+
+                // Small random bytes make hits common for every operator
+                for (size_t i = 0; i < count * 12 + 8; i++)
+                    buffer[i] = (unsigned char)(rand() % 4);
+
+                memset(&cmp, 0, sizeof(cmp));
+                cmp.type = (enum libhack_value_type)type;
+                cmp.op = (enum libhack_compare_op)op;
+                memcpy(&cmp.a, buffer + (rand() % count) * stride, size);
+                memcpy(&cmp.b, buffer + (rand() % count) * stride, size);
+
+                size_t hits = libhack_compare_block_level(LIBHACK_SIMD_SCALAR, &cmp, buffer,
+                                                          count, stride, expected);
+
+                for (int level = LIBHACK_SIMD_SSE2; level <= (int)best; level++)
+                {
+                    if (libhack_compare_block_level((enum libhack_simd_level)level, &cmp,
+                                                    buffer, count, stride, mask) != hits ||
+                        memcmp(mask, expected, sizeof(mask)) != 0)
+                    {
+                        printf("compare mismatch: level %d type %d op %d stride %zu\n",
+                               level, type, op, stride);
+                        failed = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    free(buffer);
+
+    return failed;
+}
+
+/**
+ * @brief Checks a candidate set against the expected addresses and values
+ *
+ * @param set Candidate set
+ * @param addrs Expected addresses
+ * @param values Expected values
+ * @param count Number of expected candidates
+ * @return int 0 if the set holds exactly the expected candidates
+ */
+static int check_candidates(const struct libhack_candidates *set, const DWORD64 *addrs,
+                            const int32_t *values, size_t count)
+{
+    DWORD64 *got = (DWORD64 *)malloc((count + 1) * sizeof(DWORD64));
+    int32_t *got_values = (int32_t *)malloc((count + 1) * sizeof(int32_t));
+    int failed = 0;
+
+    if (!got || !got_values)
+        failed = 1;
+    else if (libhack_candidates_count(set) != count ||
+             libhack_candidates_get(set, got, got_values, count + 1) != count ||
+             memcmp(got, addrs, count * sizeof(DWORD64)) != 0 ||
+             memcmp(got_values, values, count * sizeof(int32_t)) != 0)
+        failed = 1;
+
+    free(got);
+    free(got_values);
+
+    return failed;
+}
+
+/**
+ * @brief Checks the candidate codec and narrowing against a plain array
+ *
+ * The handle is attached to the test itself, so candidates are local
+ * variables read through the batched reads.
+ *
+ * @param lh Handle attached to the test process
+ * @return int 0 if every layout round-trips and narrows like the reference
+ */
+static int test_candidates(struct libhack_handle *lh)
+{
+    const size_t len = 256 * 1024 + 64;
+    unsigned char *memory = (unsigned char *)malloc(len);
+    DWORD64 *addrs = (DWORD64 *)malloc(len / 4 * sizeof(DWORD64));
+    int32_t *prev = (int32_t *)malloc(len / 4 * sizeof(int32_t));
+    int32_t *cur = (int32_t *)malloc(len / 4 * sizeof(int32_t));
+    int failed = 0;
+
+    if (!memory || !addrs || !prev || !cur)
+    {
+        free(memory);
+        free(addrs);
+        free(prev);
+        free(cur);
+        return 1;
+    }
+
+    srand(4321);
+
+    // Dense (bitmap blocks), sparse (delta blocks) and misaligned (byte positions) layouts
+    for (int layout = 0; layout < 3; layout++)
+    {
+        struct libhack_candidates *set = libhack_candidates_create(lh, LIBHACK_TYPE_INT32, 4);
+        size_t first = ((uintptr_t)memory % 4) ? 4 - (uintptr_t)memory % 4 : 0;
+        size_t count = 0;
+        size_t kept = 0;
+
+        if (!set)
+        {
+            failed = 1;
+            break;
+        }
+
+        for (size_t i = 0; i < len; i++)
+            memory[i] = (unsigned char)rand();
+
+        for (size_t offset = first + (layout == 2); offset + 4 <= len; offset += 4)
+        {
+            if (layout == 0 || rand() % 500 == 0)
+            {
+                addrs[count] = (DWORD64)(uintptr_t)(memory + offset);
+                memcpy(&prev[count], memory + offset, 4);
+                count++;
+            }
+        }
+
+        if (libhack_candidates_load(set, addrs, count) != LIBHACK_OK ||
+            check_candidates(set, addrs, prev, count) != 0)
+        {
+            printf("candidates load mismatch: layout %d\n", layout);
+            failed = 1;
+        }
+
+        // A dense set must be cheaper than the list of its addresses
+        if (layout == 0 && libhack_candidates_memory(set) >= count * sizeof(DWORD64))
+        {
+            printf("candidates dense layout takes %zu bytes\n", libhack_candidates_memory(set));
+            failed = 1;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            int32_t value = prev[i] + rand() % 3 - 1;
+
+            memcpy((void *)(uintptr_t)addrs[i], &value, 4);
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            memcpy(&cur[kept], (void *)(uintptr_t)addrs[i], 4);
+
+            if (cur[kept] > prev[i])
+                addrs[kept++] = addrs[i];
+        }
+
+        if (libhack_candidates_narrow(set, LIBHACK_NARROW_INCREASED, NULL) != LIBHACK_OK ||
+            check_candidates(set, addrs, cur, kept) != 0)
+        {
+            printf("candidates narrow mismatch: layout %d\n", layout);
+            failed = 1;
+        }
+
+        // Streamed sets must encode like loaded ones
+        if (layout != 2)
+        {
+            long status = libhack_candidates_begin(set);
+
+            for (size_t i = 0; i < kept && status == LIBHACK_OK; i++)
+                status = libhack_candidates_append(set, addrs[i], &cur[i]);
+
+            if (status == LIBHACK_OK)
+                status = libhack_candidates_end(set);
+
+            if (status != LIBHACK_OK || check_candidates(set, addrs, cur, kept) != 0)
+            {
+                printf("candidates stream mismatch: layout %d\n", layout);
+                failed = 1;
+            }
+        }
+
+        libhack_candidates_free(set);
+    }
+
+    free(memory);
+    free(addrs);
+    free(prev);
+    free(cur);
+
+    return failed;
+}
+
+/**
+ * @brief Writes a random signature matching a buffer, with wildcards and nibble masks
+ *
+ * @param source Bytes the signature is taken from
+ * @param len Number of bytes of the signature
+ * @param text Receives the signature text (at least len * 3 + 1 characters)
+ * @param value Receives the known bits of each byte
+ * @param mask Receives the mask of the known bits of each byte
+ */
+static void make_signature(const unsigned char *source, size_t len, char *text,
+                           unsigned char *value, unsigned char *mask)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    char *p = text;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        int kind = rand() % 10;
+
+        // The middle byte stays known so the signature always compiles
+        if (i == len / 2 || kind < 6)
+            mask[i] = 0xFF;
+        else if (kind < 8)
+            mask[i] = 0x00;
+        else if (kind < 9)
+            mask[i] = 0xF0;
+        else
+            mask[i] = 0x0F;
+
+        value[i] = source[i] & mask[i];
+
+        if (mask[i] == 0x00 && rand() % 2)
+        {
+            *p++ = '?';
+        }
+        else
+        {
+            *p++ = mask[i] & 0xF0 ? digits[value[i] >> 4] : '?';
+            *p++ = mask[i] & 0x0F ? digits[value[i] & 0x0F] : '?';
+        }
+
+        *p++ = ' ';
+    }
+
+    *p = '\0';
+}
+
+/**
+ * @brief Finds the matches of a signature by trying every offset
+ *
+ * @param buffer Buffer to be searched
+ * @param len Size of buffer
+ * @param value Known bits of each byte
+ * @param mask Mask of the known bits of each byte
+ * @param sig_len Number of bytes of the signature
+ * @param offsets Receives the offsets of the matches
+ * @return size_t Number of matches
+ */
+static size_t naive_signature_search(const unsigned char *buffer, size_t len,
+                                     const unsigned char *value, const unsigned char *mask,
+                                     size_t sig_len, size_t *offsets)
+{
+    size_t count = 0;
+
+    for (size_t offset = 0; offset + sig_len <= len; offset++)
+    {
+        size_t i = 0;
+
+        while (i < sig_len && (buffer[offset + i] & mask[i]) == value[i])
+            i++;
+
+        if (i == sig_len)
+            offsets[count++] = offset;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Checks the signature parser and the local search against a naive matcher
+ *
+ * Short and long signatures cover both the skip table and the rare byte
+ * prefilter; a small alphabet makes partial matches common.
+ *
+ * @return int 0 if every search agrees with the naive matcher
+ */
+static int test_signature_search()
+{
+    const size_t len = 64 * 1024;
+    const char *invalid[] = {"", "?? ??", "4G", "123", "?? 4? ?8"};
+    unsigned char *buffer = (unsigned char *)malloc(len);
+    size_t *expected = (size_t *)malloc(len * sizeof(size_t));
+    size_t *offsets = (size_t *)malloc(len * sizeof(size_t));
+    unsigned char value[64];
+    unsigned char mask[64];
+    char text[64 * 3 + 1];
+    int failed = 0;
+
+    if (!buffer || !expected || !offsets)
+    {
+        free(buffer);
+        free(expected);
+        free(offsets);
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+        struct libhack_signature *sig = libhack_signature_compile(invalid[i]);
+
+        if (sig)
+        {
+            printf("signature \"%s\" should not compile\n", invalid[i]);
+            libhack_signature_free(sig);
+            failed = 1;
+        }
+    }
+
+    srand(5678);
+
+    for (int round = 0; round < 200; round++)
+    {
+        size_t sig_len = 1 + (size_t)rand() % 48;
+        int alphabet = round % 2 ? 4 : 256;
+        struct libhack_signature *sig;
+        size_t count;
+        size_t found;
+
+        for (size_t i = 0; i < len; i++)
+            buffer[i] = (unsigned char)(rand() % alphabet);
+
+        make_signature(buffer + (size_t)rand() % (len - sig_len), sig_len, text, value, mask);
+
+        sig = libhack_signature_compile(text);
+        if (!sig || libhack_signature_length(sig) != sig_len)
+        {
+            printf("signature \"%s\" failed to compile\n", text);
+            libhack_signature_free(sig);
+            failed = 1;
+            continue;
+        }
+
+        count = naive_signature_search(buffer, len, value, mask, sig_len, expected);
+        found = libhack_signature_search(sig, buffer, len, offsets, len);
+
+        if (found != count || memcmp(offsets, expected, count * sizeof(size_t)) != 0)
+        {
+            printf("signature search mismatch: \"%s\" found %zu of %zu\n", text, found, count);
+            failed = 1;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!libhack_signature_match(sig, buffer + expected[i]))
+            {
+                printf("signature match mismatch: \"%s\" at %zu\n", text, expected[i]);
+                failed = 1;
+                break;
+            }
+        }
+
+        libhack_signature_free(sig);
+    }
+
+    free(buffer);
+    free(expected);
+    free(offsets);
+
+    return failed;
+}
+
+/**
+ * @brief Maps a region of three scan chunks between two inaccessible pages
+ *
+ * The guard pages keep the region from merging with its neighbours, so scan
+ * chunks start at known offsets.
+ *
+ * @param len Receives the size of the region
+ * @return unsigned char* First byte of the region or NULL on error
+ */
+static unsigned char *map_scan_region(size_t *len)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    unsigned char *map;
+
+    *len = 3 * LIBHACK_SCAN_CHUNK;
+    map = (unsigned char *)mmap(NULL, *len + 2 * page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS,
+                                -1, 0);
+    if (map == MAP_FAILED)
+        return NULL;
+
+    if (mprotect(map + page, *len, PROT_READ | PROT_WRITE) != 0)
+    {
+        munmap(map, *len + 2 * page);
+        return NULL;
+    }
+
+    return map + page;
+}
+
+static void unmap_scan_region(unsigned char *region, size_t len)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    munmap(region - page, len + 2 * page);
+}
+
+/**
+ * @brief Counts the matches of a scan lying in a region
+ *
+ * @param result Scan result
+ * @param region First byte of the region
+ * @param len Size of the region
+ * @param offsets Receives the offsets of the matches in the region
+ * @return size_t Number of matches in the region
+ */
+static size_t scan_matches_in(const struct libhack_scan_result *result,
+                              const unsigned char *region, size_t len, size_t *offsets)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < result->count; i++)
+    {
+        if (result->addrs[i] >= (DWORD64)(uintptr_t)region &&
+            result->addrs[i] < (DWORD64)(uintptr_t)region + len)
+            offsets[count++] = (size_t)(result->addrs[i] - (DWORD64)(uintptr_t)region);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Checks that a process scan finds signatures crossing its chunk boundaries
+ *
+ * @param lh Handle attached to the test process
+ * @return int 0 if every planted match is found and nothing else in the region
+ */
+static int test_signature_scan(struct libhack_handle *lh)
+{
+    const size_t sig_len = 12;
+    size_t len;
+    unsigned char *region = map_scan_region(&len);
+    const size_t planted[] = {0, LIBHACK_SCAN_CHUNK - 5, 2 * LIBHACK_SCAN_CHUNK - 1,
+                              2 * LIBHACK_SCAN_CHUNK + 64, 3 * LIBHACK_SCAN_CHUNK - 12};
+    unsigned char source[12];
+    unsigned char value[12];
+    unsigned char mask[12];
+    char text[12 * 3 + 1];
+    size_t offsets[16];
+    struct libhack_signature *sig;
+    struct libhack_scan_result result;
+    int failed = 0;
+
+    if (!region)
+        return 1;
+
+    srand(8765);
+
+    // Zeros around the planted bytes can never match them
+    for (size_t i = 0; i < sig_len; i++)
+        source[i] = (unsigned char)(0x80 | rand());
+
+    for (size_t i = 0; i < sizeof(planted) / sizeof(planted[0]); i++)
+        memcpy(region + planted[i], source, sig_len);
+
+    make_signature(source, sig_len, text, value, mask);
+
+    sig = libhack_signature_compile(text);
+    if (!sig || libhack_signature_scan(lh, sig, NULL, &result) != LIBHACK_OK)
+    {
+        libhack_signature_free(sig);
+        unmap_scan_region(region, len);
+        return 1;
+    }
+
+    if (scan_matches_in(&result, region, len, offsets) != sizeof(planted) / sizeof(planted[0]) ||
+        memcmp(offsets, planted, sizeof(planted)) != 0)
+    {
+        printf("signature scan missed matches crossing chunks: \"%s\"\n", text);
+        failed = 1;
+    }
+
+    libhack_scan_result_free(&result);
+    libhack_signature_free(sig);
+    unmap_scan_region(region, len);
+
+    return failed;
+}
+
+static int compare_matches(const void *a, const void *b)
+{
+    const size_t *x = (const size_t *)a;
+    const size_t *y = (const size_t *)b;
+
+    if (x[0] != y[0])
+        return x[0] < y[0] ? -1 : 1;
+
+    return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+/**
+ * @brief Checks multi-pattern search against the naive matcher of each signature
+ *
+ * Some signatures are prefixes or suffixes of others, so the automaton has to
+ * follow its failure and output links to report every one of them.
+ *
+ * @return int 0 if every set reports exactly the matches of its signatures
+ */
+static int test_signature_set_search()
+{
+    const size_t len = 32 * 1024;
+    const size_t max = 32 * 1024 * 24;
+    unsigned char *buffer = (unsigned char *)malloc(len);
+    size_t *expected = (size_t *)malloc(max * 2 * sizeof(size_t));
+    size_t *matches = (size_t *)malloc(max * 2 * sizeof(size_t));
+    size_t *offsets = (size_t *)malloc(max * sizeof(size_t));
+    size_t *ids = (size_t *)malloc(max * sizeof(size_t));
+    unsigned char value[32];
+    unsigned char mask[32];
+    char text[32 * 3 + 1];
+    int failed = 0;
+
+    if (!buffer || !expected || !matches || !offsets || !ids)
+    {
+        free(buffer);
+        free(expected);
+        free(matches);
+        free(offsets);
+        free(ids);
+        return 1;
+    }
+
+    srand(2468);
+
+    for (int round = 0; round < 50 && !failed; round++)
+    {
+        struct libhack_signature_set *set = libhack_signature_set_create();
+        size_t signatures = 1 + (size_t)rand() % 24;
+        size_t previous = 0;
+        size_t count = 0;
+        size_t found;
+
+        if (!set)
+        {
+            failed = 1;
+            break;
+        }
+
+        for (size_t i = 0; i < len; i++)
+            buffer[i] = (unsigned char)(rand() % (round % 2 ? 4 : 16));
+
+        for (size_t id = 0; id < signatures && !failed; id++)
+        {
+            size_t sig_len = 1 + (size_t)rand() % 24;
+            size_t source = (size_t)rand() % (len - 32);
+            size_t sig_count;
+
+            // Prefixes and suffixes of the previous signature share its automaton states
+            if (id > 0 && rand() % 3 == 0)
+                source = previous + (rand() % 2 ? 0 : (size_t)rand() % 4);
+
+            previous = source;
+            make_signature(buffer + source, sig_len, text, value, mask);
+
+            if (libhack_signature_set_add(set, text, NULL, NULL) != LIBHACK_OK)
+            {
+                printf("signature \"%s\" failed to join a set\n", text);
+                failed = 1;
+                break;
+            }
+
+            sig_count = naive_signature_search(buffer, len, value, mask, sig_len, offsets);
+
+            for (size_t i = 0; i < sig_count && count < max; i++)
+            {
+                expected[count * 2] = id;
+                expected[count * 2 + 1] = offsets[i];
+                count++;
+            }
+        }
+
+        found = libhack_signature_set_search(set, buffer, len, ids, offsets, max);
+
+        for (size_t i = 0; i < found && i < max; i++)
+        {
+            matches[i * 2] = ids[i];
+            matches[i * 2 + 1] = offsets[i];
+        }
+
+        qsort(expected, count, 2 * sizeof(size_t), compare_matches);
+        qsort(matches, found < max ? found : max, 2 * sizeof(size_t), compare_matches);
+
+        if (!failed && (found != count || memcmp(matches, expected, count * 2 * sizeof(size_t)) != 0))
+        {
+            printf("signature set mismatch: round %d found %zu of %zu\n", round, found, count);
+            failed = 1;
+        }
+
+        libhack_signature_set_free(set);
+    }
+
+    free(buffer);
+    free(expected);
+    free(matches);
+    free(offsets);
+    free(ids);
+
+    return failed;
+}
+
+/**
+ * @brief Checks that a set scan finds each signature across chunk boundaries
+ *
+ * @param lh Handle attached to the test process
+ * @return int 0 if every planted match is reported for its signature only
+ */
+static int test_signature_set_scan(struct libhack_handle *lh)
+{
+    size_t len;
+    unsigned char *region = map_scan_region(&len);
+    const size_t planted[2][3] = {
+        {LIBHACK_SCAN_CHUNK - 3, 2 * LIBHACK_SCAN_CHUNK + 100, 3 * LIBHACK_SCAN_CHUNK - 16},
+        {0, LIBHACK_SCAN_CHUNK + 200, 2 * LIBHACK_SCAN_CHUNK - 15}};
+    struct libhack_signature_set *set = libhack_signature_set_create();
+    struct libhack_scan_result results[2];
+    unsigned char source[2][16];
+    unsigned char value[16];
+    unsigned char mask[16];
+    char text[16 * 3 + 1];
+    size_t offsets[16];
+    int failed = 0;
+
+    if (!region || !set)
+    {
+        if (region)
+            unmap_scan_region(region, len);
+        libhack_signature_set_free(set);
+        return 1;
+    }
+
+    srand(1357);
+
+    for (size_t s = 0; s < 2; s++)
+    {
+        for (size_t i = 0; i < 16; i++)
+            source[s][i] = (unsigned char)(0x80 | rand());
+
+        for (size_t i = 0; i < 3; i++)
+            memcpy(region + planted[s][i], source[s], 16);
+
+        make_signature(source[s], 16, text, value, mask);
+
+        if (libhack_signature_set_add(set, text, NULL, NULL) != LIBHACK_OK)
+            failed = 1;
+    }
+
+    if (failed || libhack_signature_set_scan(lh, set, NULL, results) != LIBHACK_OK)
+    {
+        libhack_signature_set_free(set);
+        unmap_scan_region(region, len);
+        return 1;
+    }
+
+    for (size_t s = 0; s < 2; s++)
+    {
+        if (scan_matches_in(&results[s], region, len, offsets) != 3 ||
+            memcmp(offsets, planted[s], sizeof(planted[s])) != 0)
+        {
+            printf("signature set scan missed matches of signature %zu\n", s);
+            failed = 1;
+        }
+
+        libhack_scan_result_free(&results[s]);
+    }
+
+    libhack_signature_set_free(set);
+    unmap_scan_region(region, len);
+
+    return failed;
+}
+/**
+ * @brief Checks the values kept by an unchanged comparison with write tracking
+ *
+ * Untouched pages are not read again, so the values of their matches come
+ * from the snapshot. Skipped when the kernel does not track soft-dirty bits.
+ *
+ * @param lh Handle attached to the test process
+ * @return int 0 if every unchanged value of the region is kept with its value
+ */
+static int test_snapshot_unchanged(struct libhack_handle *lh)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t len;
+    unsigned char *region = map_scan_region(&len);
+    struct libhack_snapshot *snap = libhack_snapshot_create(lh, NULL);
+    struct libhack_candidates *set = libhack_candidates_create(lh, LIBHACK_TYPE_INT32, 4);
+    DWORD64 *addrs = NULL;
+    int32_t *values = NULL;
+    size_t count;
+    size_t found = 0;
+    long status;
+    int failed = 0;
+
+    if (!region || !snap || !set)
+    {
+        failed = 1;
+        goto out;
+    }
+
+    status = libhack_snapshot_track_writes(snap, true);
+    if (status == ENOTSUP)
+    {
+        printf("soft-dirty bits not tracked, skipping snapshot test\n");
+        goto out;
+    }
+
+    srand(2468);
+
+    for (size_t i = 0; i < len; i++)
+        region[i] = (unsigned char)rand();
+
+    if (status != LIBHACK_OK || libhack_snapshot_take(snap) != LIBHACK_OK)
+    {
+        failed = 1;
+        goto out;
+    }
+
+    // Every value of one page changes, the other pages are left alone
+    for (size_t offset = 5 * page; offset < 6 * page; offset++)
+        region[offset] ^= 0xff;
+
+    if (libhack_snapshot_compare(snap, LIBHACK_NARROW_UNCHANGED, NULL, set) != LIBHACK_OK)
+    {
+        failed = 1;
+        goto out;
+    }
+
+    count = libhack_candidates_count(set);
+    addrs = (DWORD64 *)malloc((count + 1) * sizeof(DWORD64));
+    values = (int32_t *)malloc((count + 1) * sizeof(int32_t));
+    if (!addrs || !values || libhack_candidates_get(set, addrs, values, count + 1) != count)
+    {
+        failed = 1;
+        goto out;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char *addr = (unsigned char *)(uintptr_t)addrs[i];
+
+        if (addr < region || addr >= region + len)
+            continue;
+
+        found++;
+
+        if (memcmp(&values[i], addr, 4) != 0)
+        {
+            printf("snapshot unchanged value mismatch at offset %zu\n", (size_t)(addr - region));
+            failed = 1;
+            break;
+        }
+    }
+
+    if (!failed && found != (len - page) / 4)
+    {
+        printf("snapshot unchanged kept %zu values of the region\n", found);
+        failed = 1;
+    }
+
+out:
+    free(addrs);
+    free(values);
+    libhack_candidates_free(set);
+    libhack_snapshot_free(snap);
+    if (region)
+        unmap_scan_region(region, len);
+
+    return failed;
+}
+#endif
 
 int main()
 {
@@ -9,6 +821,44 @@ int main()
         return 1;
     }
 
+#ifdef __linux__
+    if (test_compare_kernels() != 0) {
+        printf("compare kernels test failed\n");
+        libhack_free(lh);
+        return 1;
+    }
+
+    if (libhack_attach_pid(lh, getpid()) != LIBHACK_OK) {
+        printf("failed to attach to the test process\n");
+        libhack_free(lh);
+        return 1;
+    }
+
+    if (test_candidates(lh) != 0) {
+        printf("candidates test failed\n");
+        libhack_free(lh);
+        return 1;
+    }
+
+    if (test_signature_search() != 0 || test_signature_scan(lh) != 0) {
+        printf("signature test failed\n");
+        libhack_free(lh);
+        return 1;
+    }
+
+    if (test_signature_set_search() != 0 || test_signature_set_scan(lh) != 0) {
+        printf("signature set test failed\n");
+        libhack_free(lh);
+        return 1;
+    }
+
+    if (test_snapshot_unchanged(lh) != 0) {
+        printf("snapshot test failed\n");
+        libhack_free(lh);
+        return 1;
+    }
+#endif
+
     printf("test passed\n");
 
     libhack_free(lh);
@@ -0,0 +1,776 @@
+/**
+ * @file watch.c
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Hardware watchpoints on the threads of a process through perf events
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <linux/hw_breakpoint.h>
+#include <linux/perf_event.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "logger.h"
+#include "procfs.h"
+#include "status_codes.h"
+#include "watch.h"
+
+/**
+ * @brief Threads listed at once when the thread count is unknown
+ *
+ */
+#define WATCH_INITIAL_THREADS 64
+
+/**
+ * @brief Longest wait of a poll before the threads are synchronized again
+ *
+ */
+#define WATCH_POLL_SLICE_MS 100
+
+/**
+ * @brief Sample layout selected by the breakpoint events
+ *
+ */
+#define WATCH_SAMPLE_TYPE (PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_TIME | PERF_SAMPLE_ID)
+
+/**
+ * @brief A PERF_RECORD_SAMPLE of WATCH_SAMPLE_TYPE, after its header
+ *
+ */
+struct libhack_watch_sample
+{
+	/**
+	 * @brief Instruction pointer
+	 *
+	 */
+	uint64_t ip;
+
+	/**
+	 * @brief Process ID
+	 *
+	 */
+	uint32_t pid;
+
+	/**
+	 * @brief Thread ID
+	 *
+	 */
+	uint32_t tid;
+
+	/**
+	 * @brief Time of the sample
+	 *
+	 */
+	uint64_t time;
+
+	/**
+	 * @brief ID of the event
+	 *
+	 */
+	uint64_t id;
+};
+
+/**
+ * @brief A watched address
+ *
+ */
+struct libhack_watch_slot
+{
+	/**
+	 * @brief The slot holds a watchpoint
+	 *
+	 */
+	bool used;
+
+	/**
+	 * @brief Watched address
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Number of bytes watched
+	 *
+	 */
+	size_t len;
+
+	/**
+	 * @brief Accesses reported
+	 *
+	 */
+	enum libhack_watch_type type;
+};
+
+/**
+ * @brief Events opened on a thread
+ *
+ */
+struct libhack_watch_thread
+{
+	/**
+	 * @brief Thread ID
+	 *
+	 */
+	pid_t tid;
+
+	/**
+	 * @brief Dummy event owning the ring buffer, so removing a watchpoint keeps it
+	 *
+	 */
+	int ring_fd;
+
+	/**
+	 * @brief Whether the ring buffer reported the exit of the thread
+	 *
+	 */
+	bool exited;
+
+	/**
+	 * @brief Mapping of the ring buffer (metadata page followed by the data pages)
+	 *
+	 */
+	struct perf_event_mmap_page *ring;
+
+	/**
+	 * @brief Breakpoint event of each slot (-1 if the slot is empty)
+	 *
+	 */
+	int fds[LIBHACK_WATCH_SLOTS];
+
+	/**
+	 * @brief Kernel ID of each breakpoint event
+	 *
+	 */
+	uint64_t ids[LIBHACK_WATCH_SLOTS];
+};
+
+struct libhack_watchpoints
+{
+	/**
+	 * @brief Handle to libhack
+	 *
+	 */
+	struct libhack_handle *handle;
+
+	/**
+	 * @brief Watchpoints
+	 *
+	 */
+	struct libhack_watch_slot slots[LIBHACK_WATCH_SLOTS];
+
+	/**
+	 * @brief Threads with events opened
+	 *
+	 */
+	struct libhack_watch_thread *threads;
+
+	/**
+	 * @brief Number of threads
+	 *
+	 */
+	size_t thread_count;
+
+	/**
+	 * @brief Capacity of threads
+	 *
+	 */
+	size_t thread_capacity;
+
+	/**
+	 * @brief Thread to be drained first by the next poll, so no thread starves the others
+	 *
+	 */
+	size_t next_thread;
+
+	/**
+	 * @brief Page size of the system
+	 *
+	 */
+	size_t page;
+
+	/**
+	 * @brief Hits lost because a ring buffer was full
+	 *
+	 */
+	size_t lost;
+};
+
+static int libhack_perf_event_open(struct perf_event_attr *attr, pid_t tid)
+{
+    return (int)syscall(SYS_perf_event_open, attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+/**
+ * @brief Opens the breakpoint event of a slot on a thread
+ *
+ * @param wp Watchpoints
+ * @param thread Thread
+ * @param slot Slot
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_watch_open_slot(struct libhack_watchpoints *wp,
+                                    struct libhack_watch_thread *thread, size_t slot)
+{
+    const struct libhack_watch_slot *watch = &wp->slots[slot];
+    struct perf_event_attr attr;
+    long status;
+    int fd;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_BREAKPOINT;
+    attr.bp_type = watch->type == LIBHACK_WATCH_WRITE ? HW_BREAKPOINT_W : HW_BREAKPOINT_RW;
+    attr.bp_addr = watch->addr;
+    attr.bp_len = watch->len;
+    attr.sample_period = 1;
+    attr.sample_type = WATCH_SAMPLE_TYPE;
+    attr.wakeup_events = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    fd = libhack_perf_event_open(&attr, thread->tid);
+    if (fd == -1)
+        return errno;
+
+    if (ioctl(fd, PERF_EVENT_IOC_SET_OUTPUT, thread->ring_fd) == -1 ||
+        ioctl(fd, PERF_EVENT_IOC_ID, &thread->ids[slot]) == -1)
+    {
+        status = errno;
+        close(fd);
+        return status;
+    }
+
+    thread->fds[slot] = fd;
+
+    return LIBHACK_OK;
+}
+
+static void libhack_watch_close_slot(struct libhack_watch_thread *thread, size_t slot)
+{
+    if (thread->fds[slot] == -1)
+        return;
+
+    close(thread->fds[slot]);
+    thread->fds[slot] = -1;
+    thread->ids[slot] = 0;
+}
+
+static void libhack_watch_close_thread(struct libhack_watchpoints *wp,
+                                       struct libhack_watch_thread *thread)
+{
+    for (size_t slot = 0; slot < LIBHACK_WATCH_SLOTS; slot++)
+        libhack_watch_close_slot(thread, slot);
+
+    if (thread->ring)
+        munmap(thread->ring, (LIBHACK_WATCH_RING_PAGES + 1) * wp->page);
+
+    close(thread->ring_fd);
+}
+
+/**
+ * @brief Opens the ring buffer and the breakpoints of every used slot on a thread
+ *
+ * @param wp Watchpoints
+ * @param thread Thread (tid must be set)
+ * @return long LIBHACK_OK on success or errno value
+ */
+static long libhack_watch_open_thread(struct libhack_watchpoints *wp,
+                                      struct libhack_watch_thread *thread)
+{
+    struct perf_event_attr attr;
+    void *ring;
+    long status = LIBHACK_OK;
+
+    for (size_t slot = 0; slot < LIBHACK_WATCH_SLOTS; slot++)
+    {
+        thread->fds[slot] = -1;
+        thread->ids[slot] = 0;
+    }
+
+    thread->ring = NULL;
+    thread->exited = false;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.config = PERF_COUNT_SW_DUMMY;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    thread->ring_fd = libhack_perf_event_open(&attr, thread->tid);
+    if (thread->ring_fd == -1)
+        return errno;
+
+    ring = mmap(NULL, (LIBHACK_WATCH_RING_PAGES + 1) * wp->page, PROT_READ | PROT_WRITE,
+                MAP_SHARED, thread->ring_fd, 0);
+    if (ring == MAP_FAILED)
+    {
+        status = errno;
+        close(thread->ring_fd);
+        return status;
+    }
+
+    thread->ring = (struct perf_event_mmap_page *)ring;
+
+    for (size_t slot = 0; slot < LIBHACK_WATCH_SLOTS && status == LIBHACK_OK; slot++)
+    {
+        if (wp->slots[slot].used)
+            status = libhack_watch_open_slot(wp, thread, slot);
+    }
+
+    if (status != LIBHACK_OK)
+        libhack_watch_close_thread(wp, thread);
+
+    return status;
+}
+
+struct libhack_watchpoints *libhack_watch_create(struct libhack_handle *handle)
+{
+    struct libhack_watchpoints *wp;
+    long page = sysconf(_SC_PAGESIZE);
+
+    // Sanity checking
+    libhack_assert_or_return(handle != NULL, NULL);
+
+    wp = (struct libhack_watchpoints *)calloc(1, sizeof(struct libhack_watchpoints));
+    if (!wp)
+        return NULL;
+
+    wp->handle = handle;
+    wp->page = page > 0 ? (size_t)page : 4096;
+
+    return wp;
+}
+
+/**
+ * @brief Lists the threads of the process
+ *
+ * @param pid Process ID
+ * @param count Receives the number of threads
+ * @return pid_t* Thread IDs (release with free) or NULL on error
+ */
+static pid_t *libhack_watch_list_threads(pid_t pid, size_t *count)
+{
+    size_t capacity = WATCH_INITIAL_THREADS;
+    pid_t *tids = NULL;
+
+    for (;;)
+    {
+        pid_t *grown = (pid_t *)realloc(tids, capacity * sizeof(pid_t));
+
+        if (!grown)
+        {
+            free(tids);
+            return NULL;
+        }
+
+        tids = grown;
+        *count = libhack_list_threads(pid, tids, capacity);
+
+        // A full list may have been cut short
+        if (*count < capacity)
+            return tids;
+
+        capacity *= 2;
+    }
+}
+
+long libhack_watch_sync(struct libhack_watchpoints *wp)
+{
+    pid_t *tids;
+    size_t count;
+    size_t kept = 0;
+    long status = LIBHACK_OK;
+
+    // Sanity checking
+    libhack_assert_or_return(wp != NULL, -1);
+
+    if (wp->handle->pid == -1)
+        return ESRCH;
+
+    tids = libhack_watch_list_threads(wp->handle->pid, &count);
+    if (!tids)
+        return ENOMEM;
+
+    if (count == 0)
+    {
+        free(tids);
+        return ESRCH;
+    }
+
+    // Forget the threads which exited, keeping their queued hits until the next poll
+    for (size_t i = 0; i < wp->thread_count; i++)
+    {
+        struct libhack_watch_thread *thread = &wp->threads[i];
+        bool alive = false;
+
+        for (size_t j = 0; j < count && !alive; j++)
+            alive = tids[j] == thread->tid;
+
+        if (!alive && __atomic_load_n(&thread->ring->data_head, __ATOMIC_ACQUIRE) ==
+                          thread->ring->data_tail)
+        {
+            libhack_watch_close_thread(wp, thread);
+            continue;
+        }
+
+        wp->threads[kept++] = *thread;
+    }
+
+    wp->thread_count = kept;
+
+    for (size_t j = 0; j < count; j++)
+    {
+        struct libhack_watch_thread *thread;
+        bool known = false;
+        long open_status;
+
+        for (size_t i = 0; i < kept && !known; i++)
+            known = wp->threads[i].tid == tids[j];
+
+        if (known)
+            continue;
+
+        if (wp->thread_count == wp->thread_capacity)
+        {
+            size_t capacity = wp->thread_capacity ? wp->thread_capacity * 2 : WATCH_INITIAL_THREADS;
+            struct libhack_watch_thread *threads = (struct libhack_watch_thread *)realloc(
+                wp->threads, capacity * sizeof(struct libhack_watch_thread));
+
+            if (!threads)
+            {
+                status = ENOMEM;
+                break;
+            }
+
+            wp->threads = threads;
+            wp->thread_capacity = capacity;
+        }
+
+        thread = &wp->threads[wp->thread_count];
+        thread->tid = tids[j];
+
+        open_status = libhack_watch_open_thread(wp, thread);
+
+        // The thread may exit while it is listed
+        if (open_status == ESRCH)
+            continue;
+
+        if (open_status != LIBHACK_OK)
+        {
+            libhack_err("failed to set watchpoints on thread %d: %ld", tids[j], open_status);
+            status = open_status;
+            continue;
+        }
+
+        wp->thread_count++;
+    }
+
+    free(tids);
+
+    return status;
+}
+
+long libhack_watch_add(struct libhack_watchpoints *wp, DWORD64 addr, size_t len,
+                       enum libhack_watch_type type, int *watch)
+{
+    size_t slot;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(wp != NULL && watch != NULL, -1);
+
+    if ((len != 1 && len != 2 && len != 4 && len != 8) || addr % len != 0)
+        return EINVAL;
+
+    for (slot = 0; slot < LIBHACK_WATCH_SLOTS && wp->slots[slot].used; slot++)
+        ;
+
+    if (slot == LIBHACK_WATCH_SLOTS)
+        return ENOSPC;
+
+    status = libhack_watch_sync(wp);
+    if (status != LIBHACK_OK)
+        return status;
+
+    wp->slots[slot].addr = addr;
+    wp->slots[slot].len = len;
+    wp->slots[slot].type = type;
+
+    for (size_t i = 0; i < wp->thread_count; i++)
+    {
+        status = libhack_watch_open_slot(wp, &wp->threads[i], slot);
+
+        // Debug registers may be taken by a debugger on some thread: all or nothing
+        if (status != LIBHACK_OK && status != ESRCH)
+        {
+            for (size_t j = 0; j < i; j++)
+                libhack_watch_close_slot(&wp->threads[j], slot);
+
+            libhack_err("failed to watch %llx on thread %d: %ld", (unsigned long long)addr,
+                        wp->threads[i].tid, status);
+            return status;
+        }
+    }
+
+    wp->slots[slot].used = true;
+    *watch = (int)slot;
+
+    libhack_debug("watching %llx (%zu bytes) on %zu threads of %d", (unsigned long long)addr,
+                  len, wp->thread_count, wp->handle->pid);
+
+    return LIBHACK_OK;
+}
+
+long libhack_watch_remove(struct libhack_watchpoints *wp, int watch)
+{
+    // Sanity checking
+    libhack_assert_or_return(wp != NULL, -1);
+
+    if (watch < 0 || watch >= LIBHACK_WATCH_SLOTS || !wp->slots[watch].used)
+        return EINVAL;
+
+    for (size_t i = 0; i < wp->thread_count; i++)
+        libhack_watch_close_slot(&wp->threads[i], (size_t)watch);
+
+    wp->slots[watch].used = false;
+
+    return LIBHACK_OK;
+}
+
+/**
+ * @brief Copies bytes out of a ring buffer, following the wrap around
+ *
+ * @param data Data pages of the ring buffer
+ * @param size Size of the data pages
+ * @param offset Position in the ring (not reduced)
+ * @param dest Destination
+ * @param len Number of bytes
+ */
+static void libhack_watch_ring_copy(const unsigned char *data, size_t size, uint64_t offset,
+                                    void *dest, size_t len)
+{
+    size_t start = (size_t)(offset & (size - 1));
+    size_t first = len < size - start ? len : size - start;
+
+    memcpy(dest, data + start, first);
+    memcpy((unsigned char *)dest + first, data, len - first);
+}
+
+/**
+ * @brief Moves the hits queued by a thread to the caller
+ *
+ * @param wp Watchpoints
+ * @param thread Thread
+ * @param hits Receives the hits
+ * @param max Capacity of hits
+ * @param count Number of hits stored in hits (updated)
+ */
+static void libhack_watch_drain(struct libhack_watchpoints *wp,
+                                const struct libhack_watch_thread *thread,
+                                struct libhack_watch_hit *hits, size_t max, size_t *count)
+{
+    const unsigned char *data = (const unsigned char *)thread->ring + wp->page;
+    size_t size = LIBHACK_WATCH_RING_PAGES * wp->page;
+    uint64_t head = __atomic_load_n(&thread->ring->data_head, __ATOMIC_ACQUIRE);
+    uint64_t tail = thread->ring->data_tail;
+
+    while (tail < head && *count < max)
+    {
+        struct perf_event_header header;
+
+        libhack_watch_ring_copy(data, size, tail, &header, sizeof(header));
+
+        if (header.size < sizeof(header))
+        {
+            tail = head;
+            break;
+        }
+
+        if (header.type == PERF_RECORD_SAMPLE &&
+            header.size >= sizeof(header) + sizeof(struct libhack_watch_sample))
+        {
+            struct libhack_watch_sample sample;
+
+            libhack_watch_ring_copy(data, size, tail + sizeof(header), &sample, sizeof(sample));
+
+            // Hits of a removed watchpoint no longer match any event
+            for (size_t slot = 0; slot < LIBHACK_WATCH_SLOTS; slot++)
+            {
+                if (thread->fds[slot] == -1 || thread->ids[slot] != sample.id)
+                    continue;
+
+                hits[*count].watch = (int)slot;
+                hits[*count].tid = (pid_t)sample.tid;
+                hits[*count].ip = sample.ip;
+                hits[*count].addr = wp->slots[slot].addr;
+                hits[*count].time = sample.time;
+                (*count)++;
+                break;
+            }
+        }
+        else if (header.type == PERF_RECORD_LOST)
+        {
+            uint64_t lost[2];
+
+            // Event ID followed by the number of records lost
+            libhack_watch_ring_copy(data, size, tail + sizeof(header), lost, sizeof(lost));
+            wp->lost += (size_t)lost[1];
+        }
+
+        tail += header.size;
+    }
+
+    __atomic_store_n(&thread->ring->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+static void libhack_watch_drain_all(struct libhack_watchpoints *wp, struct libhack_watch_hit *hits,
+                                    size_t max, size_t *count)
+{
+    size_t first = wp->thread_count ? wp->next_thread % wp->thread_count : 0;
+
+    for (size_t i = 0; i < wp->thread_count && *count < max; i++)
+        libhack_watch_drain(wp, &wp->threads[(first + i) % wp->thread_count], hits, max, count);
+
+    wp->next_thread = first + 1;
+}
+
+long libhack_watch_poll(struct libhack_watchpoints *wp, struct libhack_watch_hit *hits,
+                        size_t max, size_t *count, int timeout_ms)
+{
+    struct timespec start;
+    struct pollfd *fds = NULL;
+    size_t capacity = 0;
+    long status;
+
+    // Sanity checking
+    libhack_assert_or_return(wp != NULL && hits != NULL && count != NULL, -1);
+
+    *count = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (;;)
+    {
+        size_t nfds = 0;
+        int wait = WATCH_POLL_SLICE_MS;
+        int ready;
+
+        // Threads which could not get the watchpoints were logged, the others are still watched
+        status = libhack_watch_sync(wp);
+        if (status == ESRCH || status == ENOMEM)
+            break;
+
+        status = LIBHACK_OK;
+
+        libhack_watch_drain_all(wp, hits, max, count);
+
+        if (*count > 0 || timeout_ms == 0 || wp->thread_count == 0)
+            break;
+
+        if (timeout_ms > 0)
+        {
+            struct timespec now;
+            long left;
+
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            left = timeout_ms - ((now.tv_sec - start.tv_sec) * 1000L +
+                                 (now.tv_nsec - start.tv_nsec) / 1000000L);
+            if (left <= 0)
+                break;
+
+            if (left < wait)
+                wait = (int)left;
+        }
+
+        if (wp->thread_count > capacity)
+        {
+            struct pollfd *grown =
+                (struct pollfd *)realloc(fds, wp->thread_count * sizeof(struct pollfd));
+
+            if (!grown)
+            {
+                status = ENOMEM;
+                break;
+            }
+
+            fds = grown;
+            capacity = wp->thread_count;
+        }
+
+        // Threads which exited report POLLHUP until they are forgotten
+        for (size_t i = 0; i < wp->thread_count; i++)
+        {
+            if (wp->threads[i].exited)
+                continue;
+
+            fds[nfds].fd = wp->threads[i].ring_fd;
+            fds[nfds].events = POLLIN;
+            fds[nfds].revents = 0;
+            nfds++;
+        }
+
+        if (nfds == 0)
+        {
+            status = ESRCH;
+            break;
+        }
+
+        // Waits are sliced so threads created meanwhile get the watchpoints
+        ready = poll(fds, nfds, wait);
+        if (ready == -1 && errno != EINTR)
+        {
+            status = errno;
+            break;
+        }
+
+        for (size_t i = 0, f = 0; i < wp->thread_count; i++)
+        {
+            if (wp->threads[i].exited)
+                continue;
+
+            if (fds[f++].revents & (POLLHUP | POLLERR))
+                wp->threads[i].exited = true;
+        }
+    }
+
+    free(fds);
+
+    return status;
+}
+
+size_t libhack_watch_lost(const struct libhack_watchpoints *wp)
+{
+    return wp ? wp->lost : 0;
+}
+
+void libhack_watch_free(struct libhack_watchpoints *wp)
+{
+    if (!wp)
+        return;
+
+    for (size_t i = 0; i < wp->thread_count; i++)
+        libhack_watch_close_thread(wp, &wp->threads[i]);
+
+    free(wp->threads);
+    free(wp);
+}
+
+#endif // __linux__
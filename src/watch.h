@@ -0,0 +1,193 @@
+/**
+ * @file watch.h
+ * @author Lucas Vieira (lucas.engen.cc@gmail.com)
+ * @brief Hardware watchpoints on the threads of a process through perf events
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LIBHACK_WATCH_H
+#define LIBHACK_WATCH_H
+
+#include "platform.h"
+
+#ifdef __linux__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "init.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of watchpoints (debug address registers of each thread)
+ *
+ */
+#define LIBHACK_WATCH_SLOTS 4
+
+/**
+ * @brief Data pages of the ring buffer receiving the hits of a thread (power of two)
+ *
+ */
+#define LIBHACK_WATCH_RING_PAGES 8
+
+/**
+ * @brief Accesses reported by a watchpoint
+ *
+ */
+enum libhack_watch_type
+{
+	/**
+	 * @brief Writes only
+	 *
+	 */
+	LIBHACK_WATCH_WRITE,
+
+	/**
+	 * @brief Reads and writes
+	 *
+	 */
+	LIBHACK_WATCH_ACCESS
+};
+
+/**
+ * @brief An access caught by a watchpoint
+ *
+ */
+struct libhack_watch_hit
+{
+	/**
+	 * @brief Watchpoint returned by libhack_watch_add
+	 *
+	 */
+	int watch;
+
+	/**
+	 * @brief Thread which did the access
+	 *
+	 */
+	pid_t tid;
+
+	/**
+	 * @brief Instruction pointer reported by the trap (on x86, the instruction after the access)
+	 *
+	 */
+	DWORD64 ip;
+
+	/**
+	 * @brief Watched address
+	 *
+	 */
+	DWORD64 addr;
+
+	/**
+	 * @brief Time of the access in nanoseconds (perf clock)
+	 *
+	 */
+	uint64_t time;
+};
+
+/**
+ * @brief Watchpoints set on every thread of a process
+ *
+ * Each watchpoint is a PERF_TYPE_BREAKPOINT event opened on each thread. The
+ * events of a thread share a ring buffer, so the target is never stopped:
+ * hits are queued by the kernel and collected by libhack_watch_poll. Threads
+ * created later get the watchpoints on the next call to libhack_watch_sync or
+ * libhack_watch_poll; accesses they do before that are not seen. Accesses
+ * done by the kernel on behalf of the process (system calls) are not seen
+ * either.
+ *
+ */
+struct libhack_watchpoints;
+
+/**
+ * @brief Creates an empty set of watchpoints bound to a handle
+ *
+ * @param handle Handle to libhack
+ * @return struct libhack_watchpoints* Watchpoints or NULL on error
+ */
+struct libhack_watchpoints *libhack_watch_create(struct libhack_handle *handle);
+
+/**
+ * @brief Watches an address on every thread of the process
+ *
+ * @param wp Watchpoints
+ * @param addr Address, aligned to len
+ * @param len Number of bytes watched (1, 2, 4 or 8)
+ * @param type Accesses to be reported
+ * @param watch Receives the watchpoint
+ * @return long LIBHACK_OK on success, ENOSPC if every slot is in use or errno value
+ */
+long libhack_watch_add(struct libhack_watchpoints *wp, DWORD64 addr, size_t len,
+					   enum libhack_watch_type type, int *watch);
+
+/**
+ * @brief Removes a watchpoint from every thread
+ *
+ * Hits already queued for the watchpoint are dropped.
+ *
+ * @param wp Watchpoints
+ * @param watch Watchpoint returned by libhack_watch_add
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_watch_remove(struct libhack_watchpoints *wp, int watch);
+
+/**
+ * @brief Sets the watchpoints on new threads and forgets the threads which exited
+ *
+ * @param wp Watchpoints
+ * @return long LIBHACK_OK on success or errno value
+ */
+long libhack_watch_sync(struct libhack_watchpoints *wp);
+
+/**
+ * @brief Collects the hits queued by every thread
+ *
+ * Threads are synchronized first. If no hit is queued, waits for one up to
+ * timeout_ms, synchronizing the threads again every 100 ms so threads created
+ * meanwhile are watched. Hits of a thread are in order; use the time to order
+ * the hits of different threads.
+ *
+ * @param wp Watchpoints
+ * @param hits Receives the hits
+ * @param max Capacity of hits (hits left are returned by the next call)
+ * @param count Receives the number of hits
+ * @param timeout_ms Time to wait for a hit (0 returns at once, -1 waits forever)
+ * @return long LIBHACK_OK on success, ESRCH once no watched thread is left or errno value
+ */
+long libhack_watch_poll(struct libhack_watchpoints *wp, struct libhack_watch_hit *hits,
+						size_t max, size_t *count, int timeout_ms);
+
+/**
+ * @brief Gets the number of hits lost because a ring buffer was full
+ *
+ * The kernel reports lost hits once the ring buffer has room again, so hits
+ * lost by the last burst of a thread are only counted after its next hit.
+ *
+ * @param wp Watchpoints
+ * @return size_t Number of hits lost so far
+ */
+size_t libhack_watch_lost(const struct libhack_watchpoints *wp);
+
+/**
+ * @brief Removes every watchpoint and releases the set
+ *
+ * @param wp Watchpoints
+ */
+void libhack_watch_free(struct libhack_watchpoints *wp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // LIBHACK_WATCH_H